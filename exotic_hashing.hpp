@@ -4,6 +4,7 @@
 #include "include/phf/do_nothing_hash.hpp"
 
 #include "include/mphf/bbhash.hpp"
+#include "include/mphf/minimal_bit_mwhc.hpp"
 #include "include/mphf/recsplit/recsplit.hpp"
 
 #include "include/mmphf/adaptive_learned_mmphf.hpp"
@@ -16,8 +17,11 @@
 
 #include "include/omphf/map_omphf.hpp"
 #include "include/omphf/mwhc.hpp"
+#include "include/omphf/partitioned_mwhc.hpp"
 
+#include "include/sf/ribbon.hpp"
 #include "include/sf/sf_mwhc.hpp"
+#include "include/sf/xor_filter.hpp"
 
 #include "include/support/bitconverter.hpp"
 #include "include/support/bitvector.hpp"
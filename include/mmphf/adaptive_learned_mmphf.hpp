@@ -4,13 +4,16 @@
 #include <iostream>
 #include <memory>
 #include <sdsl/vectors.hpp>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "../omphf/mwhc.hpp"
 #include "../support/bitconverter.hpp"
 #include "../support/clustering.hpp"
 #include "../support/elias_fano_list.hpp"
+#include "../support/serialization.hpp"
 #include "../support/support.hpp"
 #include "hollow_trie.hpp"
 #include "learned_linear.hpp"
@@ -75,6 +78,19 @@ namespace exotic_hashing {
             }
          }
 
+         /// Writes this block's type followed by its model's sections
+         void serialize(support::Serializer& out) const {
+            out.write(static_cast<std::uint64_t>(type));
+            switch (type) {
+               case MWHC:
+                  reinterpret_cast<exotic_hashing::CompressedMWHC<Data>*>(m)->serialize(out);
+                  break;
+               case LearnedLinear:
+                  reinterpret_cast<exotic_hashing::LearnedLinear<Data>*>(m)->serialize(out);
+                  break;
+            }
+         }
+
          // Can't copy BuildingBlock (for now)
          BuildingBlock(const BuildingBlock& other) = delete;
          BuildingBlock& operator=(const BuildingBlock& other) = delete;
@@ -136,6 +152,13 @@ namespace exotic_hashing {
          return 1.0 / bits_per_key;
       }
 
+      /// shared by AdaptiveLearnedMMPHF and View, i.e., List is either an owning or a mapped EliasFanoList
+      template<class List>
+      static forceinline size_t region_of(const List& delimiters, const Data& key) {
+         const auto lb = delimiters.lower_bound(key);
+         return lb + ((lb < delimiters.size() && delimiters[lb] == key) & 0x1);
+      }
+
      public:
       explicit AdaptiveLearnedMMPHF(std::vector<Data> data) {
          // ensure data is sorted before we start
@@ -184,8 +207,7 @@ namespace exotic_hashing {
       }
 
       forceinline size_t operator()(const Data& key) const {
-         const auto lb = support::lower_bound(0, delimiters.size(), key, delimiters);
-         const size_t region_ind = lb + ((lb < delimiters.size() && delimiters[lb] == key) & 0x1);
+         const size_t region_ind = region_of(delimiters, key);
 
          const size_t offset = region_offsets[region_ind];
          const size_t local_rank = leafs[region_ind](key);
@@ -204,5 +226,82 @@ namespace exotic_hashing {
       static std::string name() {
          return "AdaptiveLearnedMMPHF";
       }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<AdaptiveLearnedMMPHF>());
+         delimiters.serialize(out);
+         region_offsets.serialize(out);
+         out.write(static_cast<std::uint64_t>(leafs.size()));
+         for (const auto& leaf : leafs)
+            leaf.serialize(out);
+         out.finish();
+      }
+
+      /**
+       * Read-only AdaptiveLearnedMMPHF operating on a memory mapped file
+       * written by save(). Each leaf's view is set up on open, i.e., opening
+       * a View costs O(leaf count) while all arrays remain mapped
+       */
+      class View {
+         using MWHCView = typename exotic_hashing::CompressedMWHC<Data>::View;
+         using LearnedLinearView = typename exotic_hashing::LearnedLinear<Data>::View;
+
+         support::MappedFile file;
+         typename support::EliasFanoList<Data>::Mapped delimiters;
+         typename support::EliasFanoList<size_t>::Mapped region_offsets;
+
+         /// type of each leaf and its index into the respective leaf vector
+         std::vector<std::pair<typename BuildingBlock::Type, size_t>> leafs;
+         /// MWHC views are not movable, i.e., are allocated individually
+         std::vector<std::unique_ptr<MWHCView>> mwhc_leafs;
+         std::vector<LearnedLinearView> learned_linear_leafs;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<AdaptiveLearnedMMPHF>());
+            delimiters.deserialize(in);
+            region_offsets.deserialize(in);
+
+            const auto leaf_cnt = in.read<std::uint64_t>();
+            for (size_t i = 0; i < leaf_cnt; i++) {
+               switch (in.read<std::uint64_t>()) {
+                  case BuildingBlock::MWHC:
+                     leafs.emplace_back(BuildingBlock::MWHC, mwhc_leafs.size());
+                     mwhc_leafs.push_back(std::make_unique<MWHCView>());
+                     mwhc_leafs.back()->deserialize(in);
+                     break;
+                  case BuildingBlock::LearnedLinear:
+                     leafs.emplace_back(BuildingBlock::LearnedLinear, learned_linear_leafs.size());
+                     learned_linear_leafs.emplace_back().deserialize(in);
+                     break;
+                  default:
+                     throw std::runtime_error("Failed to load " + name() + ": unknown leaf type");
+               }
+            }
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            const size_t region_ind = region_of(delimiters, key);
+
+            const size_t offset = region_offsets[region_ind];
+            const auto& [type, index] = leafs[region_ind];
+            const size_t local_rank =
+               type == BuildingBlock::MWHC ? (*mwhc_leafs[index])(key) : learned_linear_leafs[index](key);
+
+            return local_rank + offset;
+         }
+
+         size_t byte_size() const {
+            size_t res = region_offsets.byte_size() + delimiters.byte_size() +
+               sizeof(typename decltype(leafs)::value_type) * leafs.size();
+            for (const auto& leaf : mwhc_leafs)
+               res += sizeof(leaf) + leaf->byte_size();
+            for (const auto& leaf : learned_linear_leafs)
+               res += leaf.byte_size();
+
+            return res;
+         }
+      };
    };
 } // namespace exotic_hashing
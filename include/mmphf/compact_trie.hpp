@@ -1,14 +1,21 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include "../support/bitvector.hpp"
 #include "../support/elias.hpp"
+#include "../support/integer_codes.hpp"
+#include "../support/serialization.hpp"
 
 // Order important
 #include "../convenience/builtins.hpp"
@@ -17,12 +24,17 @@ namespace exotic_hashing {
    template<class Key, class BitConverter, class BitStream>
    struct SimpleHollowTrie;
 
-   template<class Key, class BitConverter, class BitStream>
+   template<class Key, class BitConverter, class BitStream, class IntEncoder>
    struct HollowTrie;
 
-   template<class Key, class BitConverter, bool estimate_non_key_rank, class BitStream>
+   template<class Key, class BitConverter, bool estimate_non_key_rank, class BitStream, class IntEncoder>
    class CompactedCompactTrie;
 
+   /**
+    * Reference based compact (patricia) trie. Nodes are individually heap
+    * allocated, i.e., there is no save()/View. CompactedCompactTrie stores
+    * the same trie as a single bitvector and supports both
+    */
    template<class Key, class BitConverter, bool estimate_non_key_rank = false,
             class BitStream = support::FixedBitvector<sizeof(Key) * 8, Key>>
    struct CompactTrie {
@@ -368,33 +380,75 @@ namespace exotic_hashing {
             return left == nullptr;
          }
 
-         friend HollowTrie<Key, BitConverter, BitStream>;
+         template<class K, class B, class S, class I>
+         friend struct HollowTrie;
          friend SimpleHollowTrie<Key, BitConverter, BitStream>;
-         friend CompactedCompactTrie<Key, BitConverter, true, BitStream>;
-         friend CompactedCompactTrie<Key, BitConverter, false, BitStream>;
+         template<class K, class B, bool e, class S, class I>
+         friend class CompactedCompactTrie;
       };
 
       Node* root = nullptr;
 
-      friend HollowTrie<Key, BitConverter, BitStream>;
+      template<class K, class B, class S, class I>
+      friend struct HollowTrie;
       friend SimpleHollowTrie<Key, BitConverter, BitStream>;
-      friend CompactedCompactTrie<Key, BitConverter, true, BitStream>;
-      friend CompactedCompactTrie<Key, BitConverter, false, BitStream>;
+      template<class K, class B, bool e, class S, class I>
+      friend class CompactedCompactTrie;
    };
 
    /**
     * Optimized CompactTrie, i.e., instead of utilizing reference based
     * nodes, CompactedCompactTrie utilizes a bitvector representation
-    * parallel to HollowTrie
+    * parallel to HollowTrie. Like HollowTrie, it is serializable via save()
+    * and View
+    *
+    * @tparam IntEncoder integer code for node fields, see support/integer_codes.hpp.
+    *   Parameterized codes, e.g., GolombRiceCoder, are fitted to each field at build time
     */
    template<class Key, class BitConverter, bool estimate_non_key_rank = false,
-            class BitStream = support::FixedBitvector<sizeof(Key) * 8, Key>>
+            class BitStream = support::FixedBitvector<sizeof(Key) * 8, Key>,
+            class IntEncoder = support::EliasDeltaCoder>
    class CompactedCompactTrie {
-      using IntEncoder = support::EliasDeltaCoder;
+      using CompactNode = typename CompactTrie<Key, BitConverter, estimate_non_key_rank, BitStream>::Node;
+
       support::Bitvector<> representation;
+      /// one (possibly fitted) code per node field
+      std::array<IntEncoder, 3> encoders{};
+
+      void build(const CompactNode& root) {
+         // parameterized codes are fitted to each node field's values
+         encoders = support::fit_codes<IntEncoder, 3>(
+            [&](const auto& codes, auto& fields) { collect_fields(root, codes, fields); });
+
+         representation = convert(root);
+      }
+
+      /**
+       * Collects the fields of all nodes of subtrie as convert() will encode
+       * them, given each field is encoded with the respective code of codes,
+       * i.e., left subtrie sizes depend on codes
+       *
+       * @return encoded size of subtrie in bits
+       */
+      static size_t collect_fields(const CompactNode& subtrie, const std::array<IntEncoder, 3>& codes,
+                                   std::array<std::vector<std::uint64_t>, 3>& fields) {
+         if (subtrie.is_leaf())
+            return 0;
 
-      support::Bitvector<>
-      convert(const typename CompactTrie<Key, BitConverter, estimate_non_key_rank, BitStream>::Node& subtrie) const {
+         const auto left_bitsize = collect_fields(*subtrie.left, codes, fields);
+         const auto right_bitsize = collect_fields(*subtrie.right, codes, fields);
+
+         const std::array<std::uint64_t, 3> node{subtrie.prefix.size() + 1, left_bitsize + 1,
+                                                 subtrie.left->leaf_count()};
+         size_t bitsize = left_bitsize + right_bitsize + subtrie.prefix.size();
+         for (size_t i = 0; i < node.size(); i++) {
+            fields[i].push_back(node[i]);
+            bitsize += codes[i].bits(node[i]);
+         }
+         return bitsize;
+      }
+
+      support::Bitvector<> convert(const CompactNode& subtrie) const {
          // prune entire leaf level of original compact trie
          if (subtrie.is_leaf())
             return support::Bitvector<>();
@@ -407,15 +461,15 @@ namespace exotic_hashing {
 
          // Encode 'parent | left subtrie | right subtrie', where
          // each node is encoded as 'prefix_size | prefix | left_bit_size | left_leaf_cnt'
-         rep.append(IntEncoder::encode(subtrie.prefix.size() + 1));
+         encoders[0].encode(subtrie.prefix.size() + 1, rep);
          rep.append(subtrie.prefix);
 
-         rep.append(IntEncoder::encode(left_bitrep.size() + 1));
+         encoders[1].encode(left_bitrep.size() + 1, rep);
 
          // TODO(dominik): leaf_count() is an O(log(N)) operation where N is the max
          // length of any Key's bitstream. By also storing right_leaf_count in
          // CompactTrie::Node, we could make this constant time
-         rep.append(IntEncoder::encode(subtrie.left->leaf_count()));
+         encoders[2].encode(subtrie.left->leaf_count(), rep);
 
          rep.append(left_bitrep);
          rep.append(right_bitrep);
@@ -431,8 +485,9 @@ namespace exotic_hashing {
          const size_t left_leaf_count;
       };
 
-      Node read_node(const support::Bitvector<>& stream, size_t& bit_index) const {
-         const auto prefix_len = IntEncoder::decode(stream, bit_index) - 1;
+      template<class Stream>
+      static Node read_node(const Stream& stream, const std::array<IntEncoder, 3>& encoders, size_t& bit_index) {
+         const auto prefix_len = encoders[0].decode(stream, bit_index) - 1;
 
          // TODO(dominik): this likely produces suboptimal performance!
          BitStream prefix(prefix_len, false);
@@ -442,57 +497,22 @@ namespace exotic_hashing {
          // advance past prefix
          bit_index += prefix_len;
 
-         const auto left_bitsize = IntEncoder::decode(stream, bit_index) - 1;
-         const auto left_leaf_count = IntEncoder::decode(stream, bit_index);
+         const auto left_bitsize = encoders[1].decode(stream, bit_index) - 1;
+         const auto left_leaf_count = encoders[2].decode(stream, bit_index);
 
          return {.prefix = prefix, .left_bitsize = left_bitsize, .left_leaf_count = left_leaf_count};
       }
 
-     public:
-      CompactedCompactTrie() = default;
-
-      /**
-       * Constructs from a keyset in any order
-       */
-      explicit CompactedCompactTrie(const std::vector<Key>& keyset) {
-         // overall complexity O(n log n) will not change, but sorting
-         // massively improves hidden constants during construction.
-         auto ds = keyset;
-         std::sort(ds.begin(), ds.end());
-
-         // construct on sorted data
-         construct(ds.begin(), ds.end());
-      }
-
-      /**
-       * Constructs from a **sorted** key range [begin, end)
-       */
-      template<class ForwardIt>
-      explicit CompactedCompactTrie(const ForwardIt& begin, const ForwardIt& end) {
-         construct(begin, end);
-      }
-
-      /**
-       * updates representation to only include keys of **sorted** key range [begin, end)
-       */
-      template<class ForwardIt>
-      void construct(const ForwardIt& begin, const ForwardIt& end) {
-         // for now, simply convert from existing compact trie. For efficiency, we
-         // could definitely implement a better construction algorithm in the future
-         CompactTrie<Key, BitConverter, estimate_non_key_rank, BitStream> t;
-         t.construct(begin, end);
-
-         representation = convert(*t.root);
-      }
-
-      forceinline size_t operator()(const Key& key) const {
+      /// shared by CompactedCompactTrie and View, i.e., Stream is either an owning or a mapped Bitvector
+      template<class Stream>
+      static size_t lookup(const Stream& representation, const std::array<IntEncoder, 3>& encoders, const Key& key) {
          const auto not_found_rank = std::numeric_limits<size_t>::max();
          const BitConverter converter;
          const BitStream key_bits = converter(key);
 
          size_t left_leaf_cnt = 0, key_bits_ind = 0, leftmost_right = representation.size(), bit_ind = 0;
          while (key_bits_ind < key_bits.size()) {
-            const auto node = read_node(representation, bit_ind);
+            const auto node = read_node(representation, encoders, bit_ind);
 
             if (key_bits.size() - key_bits_ind < node.prefix.size()) {
                if constexpr (estimate_non_key_rank)
@@ -537,12 +557,83 @@ namespace exotic_hashing {
          return not_found_rank;
       }
 
+     public:
+      CompactedCompactTrie() = default;
+
+      /**
+       * Constructs from a keyset in any order
+       */
+      explicit CompactedCompactTrie(const std::vector<Key>& keyset) {
+         // overall complexity O(n log n) will not change, but sorting
+         // massively improves hidden constants during construction.
+         auto ds = keyset;
+         std::sort(ds.begin(), ds.end());
+
+         // construct on sorted data
+         construct(ds.begin(), ds.end());
+      }
+
+      /**
+       * Constructs from a **sorted** key range [begin, end)
+       */
+      template<class ForwardIt>
+      explicit CompactedCompactTrie(const ForwardIt& begin, const ForwardIt& end) {
+         construct(begin, end);
+      }
+
+      /**
+       * updates representation to only include keys of **sorted** key range [begin, end)
+       */
+      template<class ForwardIt>
+      void construct(const ForwardIt& begin, const ForwardIt& end) {
+         // for now, simply convert from existing compact trie. For efficiency, we
+         // could definitely implement a better construction algorithm in the future
+         CompactTrie<Key, BitConverter, estimate_non_key_rank, BitStream> t;
+         t.construct(begin, end);
+
+         build(*t.root);
+      }
+
+      forceinline size_t operator()(const Key& key) const {
+         return lookup(representation, encoders, key);
+      }
+
       static std::string name() {
-         return "CompactedCompactTrie";
+         return "CompactedCompactTrie<" + IntEncoder::name() + ">";
       }
 
       size_t byte_size() const {
          return sizeof(decltype(*this)) + static_cast<size_t>(std::ceil(representation.size() / 8.));
       }
+
+      /// Writes this trie to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<CompactedCompactTrie>());
+         out.write(encoders);
+         representation.serialize(out);
+         out.finish();
+      }
+
+      /// Read-only CompactedCompactTrie operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         support::Bitvector<std::uint64_t, support::MappedArray> representation;
+         std::array<IntEncoder, 3> encoders{};
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<CompactedCompactTrie>());
+            encoders = in.read<std::array<IntEncoder, 3>>();
+            representation.deserialize(in);
+         }
+
+         forceinline size_t operator()(const Key& key) const {
+            return lookup(representation, encoders, key);
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + static_cast<size_t>(std::ceil(representation.size() / 8.));
+         }
+      };
    };
 } // namespace exotic_hashing
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -9,10 +10,13 @@
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "../support/bitvector.hpp"
 #include "../support/elias.hpp"
+#include "../support/integer_codes.hpp"
+#include "../support/serialization.hpp"
 #include "compact_trie.hpp"
 
 // Order important
@@ -253,10 +257,15 @@ namespace exotic_hashing {
       std::vector<Node<>> nodes;
    };
 
-   template<class Key, class BitConverter, class BitStream = support::FixedBitvector<sizeof(Key) * 8, Key>>
+   /**
+    * @tparam IntEncoder integer code for node fields, see support/integer_codes.hpp.
+    *   Parameterized codes, e.g., GolombRiceCoder, are fitted to each field at build time
+    */
+   template<class Key, class BitConverter, class BitStream = support::FixedBitvector<sizeof(Key) * 8, Key>,
+            class IntEncoder = support::EliasDeltaCoder>
    struct HollowTrie {
      private:
-      using IntEncoder = support::EliasDeltaCoder;
+      using CompactNode = typename CompactTrie<Key, BitConverter, false, BitStream>::Node;
 
      public:
       HollowTrie() = default;
@@ -274,8 +283,9 @@ namespace exotic_hashing {
        * the space efficient hollow trie representation
        */
       template<bool e>
-      explicit HollowTrie(const CompactTrie<Key, BitConverter, e, BitStream>& compact_trie)
-         : representation(convert(*compact_trie.root)) {}
+      explicit HollowTrie(const CompactTrie<Key, BitConverter, e, BitStream>& compact_trie) {
+         build(*compact_trie.root);
+      }
 
       template<class RandomIt>
       void construct(const RandomIt& begin, const RandomIt& end) {
@@ -284,49 +294,49 @@ namespace exotic_hashing {
          compact_trie.construct(begin, end);
 
          // Derive HollowTrie from CompactTrie
-         representation = convert(*compact_trie.root);
+         build(*compact_trie.root);
       }
 
       size_t operator()(const Key& key) const {
-         const BitConverter converter;
-         BitStream key_bits = converter(key);
-
-         size_t left_leaf_cnt = 0, key_bits_ind = 0, leftmost_right = representation.size();
-         for (size_t bit_ind = 0; key_bits_ind < key_bits.size();) {
-            const auto node = read_node(representation, bit_ind);
-            key_bits_ind += node.discriminator_index;
-
-            // Right (if) or Left (else) traversal
-            if (key_bits[key_bits_ind]) {
-               left_leaf_cnt += node.left_leaf_count;
+         return lookup(representation, encoders, key);
+      }
 
-               // Right child is always at i + node_skip
-               bit_ind += node.left_bitsize;
+      static std::string name() {
+         return "HollowTrie<" + IntEncoder::name() + ">";
+      }
 
-               // We encountered a right leaf
-               if (bit_ind >= leftmost_right)
-                  return left_leaf_cnt;
-            } else {
-               // We encountered a left leaf
-               if (node.left_leaf_count == 1)
-                  return left_leaf_cnt;
+      size_t byte_size() const {
+         return sizeof(HollowTrie) + static_cast<size_t>(std::ceil(representation.size() / 8.));
+      };
 
-               // Keep track of this to be able to detect right leafs
-               leftmost_right = bit_ind + node.left_bitsize;
+      /// Writes this trie to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<HollowTrie>());
+         out.write(encoders);
+         representation.serialize(out);
+         out.finish();
+      }
 
-               // bit_ind is already correctly set to left child start
-            }
+      /// Read-only HollowTrie operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         support::Bitvector<std::uint64_t, support::MappedArray> representation;
+         std::array<IntEncoder, 3> encoders{};
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<HollowTrie>());
+            encoders = in.read<std::array<IntEncoder, 3>>();
+            representation.deserialize(in);
          }
 
-         return std::numeric_limits<size_t>::max();
-      }
-
-      static std::string name() {
-         return "HollowTrie";
-      }
+         size_t operator()(const Key& key) const {
+            return lookup(representation, encoders, key);
+         }
 
-      size_t byte_size() const {
-         return sizeof(HollowTrie<Key, BitConverter>) + static_cast<size_t>(std::ceil(representation.size() / 8.));
+         size_t byte_size() const {
+            return sizeof(*this) + static_cast<size_t>(std::ceil(representation.size() / 8.));
+         }
       };
 
       /**
@@ -363,6 +373,39 @@ namespace exotic_hashing {
       }
 
      private:
+      void build(const CompactNode& root) {
+         // parameterized codes are fitted to each node field's values
+         encoders = support::fit_codes<IntEncoder, 3>(
+            [&](const auto& codes, auto& fields) { collect_fields(root, codes, fields); });
+
+         representation = convert(root);
+      }
+
+      /**
+       * Collects the fields of all nodes of subtrie as convert() will encode
+       * them, given each field is encoded with the respective code of codes,
+       * i.e., left subtrie sizes depend on codes
+       *
+       * @return encoded size of subtrie in bits
+       */
+      static size_t collect_fields(const CompactNode& subtrie, const std::array<IntEncoder, 3>& codes,
+                                   std::array<std::vector<std::uint64_t>, 3>& fields) {
+         if (subtrie.is_leaf())
+            return 0;
+
+         const auto left_bitsize = collect_fields(*subtrie.left, codes, fields);
+         const auto right_bitsize = collect_fields(*subtrie.right, codes, fields);
+
+         const std::array<std::uint64_t, 3> node{subtrie.prefix.size() + 1, left_bitsize + 1,
+                                                 subtrie.left->leaf_count()};
+         size_t bitsize = left_bitsize + right_bitsize;
+         for (size_t i = 0; i < node.size(); i++) {
+            fields[i].push_back(node[i]);
+            bitsize += codes[i].bits(node[i]);
+         }
+         return bitsize;
+      }
+
       /**
        * Converts a given CompactTrie subtrie to the HollowTrie stream format, derived
        * from ideas from the theory paper & Jacobson's 89 work (mentioned in theory paper)
@@ -379,8 +422,7 @@ namespace exotic_hashing {
        * of edges along each path are expected to be left child accesses, this
        * should improve real world performance noticeably.
        */
-      support::Bitvector<>
-      convert(const typename CompactTrie<Key, BitConverter, false, BitStream>::Node& subtrie) const {
+      support::Bitvector<> convert(const CompactNode& subtrie) const {
          if (subtrie.is_leaf())
             return support::Bitvector<>();
 
@@ -392,13 +434,13 @@ namespace exotic_hashing {
          // Encode 'parent | left subtrie | right subtrie'.
 
          // parent parameters
-         rep.append(IntEncoder::encode(subtrie.prefix.size() + 1));
-         rep.append(IntEncoder::encode(left_bitrep.size() + 1));
+         encoders[0].encode(subtrie.prefix.size() + 1, rep);
+         encoders[1].encode(left_bitrep.size() + 1, rep);
 
          // TODO(dominik): leaf_count() is an O(log(N)) operation where N is the max
          // length of any Key's bitstream.  By also storing right_leaf_count in
          // CompactTrie::Node, we could make this constant time
-         rep.append(IntEncoder::encode(subtrie.left->leaf_count()));
+         encoders[2].encode(subtrie.left->leaf_count(), rep);
 
          rep.append(left_bitrep);
          rep.append(right_bitrep);
@@ -417,16 +459,62 @@ namespace exotic_hashing {
        *
        * @return node parameters as well as amount of bits read from stream, packed into Node struct
        */
-      Node read_node(const support::Bitvector<>& stream, size_t& bit_index) const {
-         const auto discriminator_ind = IntEncoder::decode(stream, bit_index);
-         const auto left_bitsize = IntEncoder::decode(stream, bit_index);
-         const auto left_leaf_count = IntEncoder::decode(stream, bit_index);
+      template<class Stream>
+      static forceinline Node read_node(const Stream& stream, const std::array<IntEncoder, 3>& encoders,
+                                        size_t& bit_index) {
+         // stateless codes share a single code for all fields, i.e., may decode them at once
+         const auto [discriminator_ind, left_bitsize, left_leaf_count] = [&]() {
+            if constexpr (support::FieldDecoder<IntEncoder, 3>)
+               return IntEncoder::template decode_fields<3>(stream, bit_index);
+            else {
+               std::array<std::uint64_t, 3> fields;
+               for (size_t i = 0; i < fields.size(); i++)
+                  fields[i] = encoders[i].decode(stream, bit_index);
+               return fields;
+            }
+         }();
 
          return {.discriminator_index = discriminator_ind - 1,
                  .left_bitsize = left_bitsize - 1,
                  .left_leaf_count = left_leaf_count};
       }
 
+      /// shared by HollowTrie and View, i.e., Stream is either an owning or a mapped Bitvector
+      template<class Stream>
+      static size_t lookup(const Stream& representation, const std::array<IntEncoder, 3>& encoders, const Key& key) {
+         const BitConverter converter;
+         BitStream key_bits = converter(key);
+
+         size_t left_leaf_cnt = 0, key_bits_ind = 0, leftmost_right = representation.size();
+         for (size_t bit_ind = 0; key_bits_ind < key_bits.size();) {
+            const auto node = read_node(representation, encoders, bit_ind);
+            key_bits_ind += node.discriminator_index;
+
+            // Right (if) or Left (else) traversal
+            if (key_bits[key_bits_ind]) {
+               left_leaf_cnt += node.left_leaf_count;
+
+               // Right child is always at i + node_skip
+               bit_ind += node.left_bitsize;
+
+               // We encountered a right leaf
+               if (bit_ind >= leftmost_right)
+                  return left_leaf_cnt;
+            } else {
+               // We encountered a left leaf
+               if (node.left_leaf_count == 1)
+                  return left_leaf_cnt;
+
+               // Keep track of this to be able to detect right leafs
+               leftmost_right = bit_ind + node.left_bitsize;
+
+               // bit_ind is already correctly set to left child start
+            }
+         }
+
+         return std::numeric_limits<size_t>::max();
+      }
+
       /**
        * Prints a latex tikz forest representation of the subtrie
        * represented by this node
@@ -447,7 +535,7 @@ namespace exotic_hashing {
 
          // Current node
          size_t after_ind = bit_index;
-         const auto n = read_node(representation, after_ind);
+         const auto n = read_node(representation, encoders, after_ind);
          out << "[{" << n.discriminator_index << ", " << n.left_leaf_count << "}" << std::endl;
 
          // Left child
@@ -473,6 +561,8 @@ namespace exotic_hashing {
          out << "]" << std::endl;
       }
 
+      /// one (possibly fitted) code per node field
+      std::array<IntEncoder, 3> encoders{};
       support::Bitvector<> representation;
    };
 } // namespace exotic_hashing
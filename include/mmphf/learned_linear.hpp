@@ -1,11 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
-#include <sdsl/bit_vector_il.hpp>
-#include <sdsl/int_vector.hpp>
-#include <sdsl/io.hpp>
-#include <sdsl/util.hpp>
 #include <string>
+#include <vector>
+
+#include "../support/bitvector.hpp"
+#include "../support/serialization.hpp"
 
 #include "../convenience/builtins.hpp"
 
@@ -13,14 +15,21 @@ namespace exotic_hashing {
    template<class Data>
    class LearnedLinear {
       Data neg_intercept = 0;
-      sdsl::bit_vector_il<> bitvec{};
-      typename decltype(bitvec)::rank_1_type rank{};
+      support::Bitvector<> bitvec{};
 
-      forceinline size_t rank_index(const Data& key) const {
-         // slope is always 1 since we don't want to produce collisions
+      /// slope is always 1 since we don't want to produce collisions
+      static forceinline size_t rank_index(const Data& neg_intercept, const Data& key) {
          return key - neg_intercept;
       }
 
+      /// shared by LearnedLinear and View, i.e., Bitvec is either an owning or a mapped Bitvector
+      template<class Bitvec>
+      static forceinline size_t rank(const Data& neg_intercept, const Bitvec& bitvec, const Data& key) {
+         const size_t ind = rank_index(neg_intercept, key);
+         assert(ind < bitvec.size());
+         return bitvec.rank(ind);
+      }
+
      public:
       LearnedLinear() noexcept = default;
 
@@ -58,81 +67,69 @@ namespace exotic_hashing {
          assert(neg_intercept == min);
 
          // build rank bitvector
-         sdsl::bit_vector bv(scale, 0);
+         bitvec = decltype(bitvec)(scale, false);
          for (size_t i = 0; i < size; i++) {
             const auto key = *(begin + i);
-            const auto ind = rank_index(key);
+            const auto ind = rank_index(neg_intercept, key);
 
             assert(ind < scale);
-            bv[ind] = true;
+            bitvec[ind] = true;
          }
-         bitvec = bv;
-         sdsl::util::init_support(rank, &bitvec);
+         bitvec.init_rank_select();
       }
 
       forceinline size_t operator()(const Data& key) const {
-         const size_t ind = rank_index(key);
-         assert(ind < bitvec.size());
-         const size_t res = rank(ind);
-
-         return res;
+         return rank(neg_intercept, bitvec, key);
       }
 
       forceinline size_t byte_size() const {
-         return sdsl::size_in_bytes(bitvec) + sdsl::size_in_bytes(rank) + sizeof(decltype(neg_intercept));
+         return bitvec.byte_size() + sizeof(decltype(neg_intercept));
       }
 
       static std::string name() {
          return "LearnedLinear";
       }
 
-      /// Custom copy constructor is necessary since sdsl's rank support contains a pointer to bitvec
-      LearnedLinear(const LearnedLinear& other) noexcept {
-         neg_intercept = other.neg_intercept;
-         bitvec = other.bitvec;
-         rank = other.rank;
-
-         // reset vector as otherwise rank contains broken pointer
-         rank.set_vector(&bitvec);
+      /// Writes this function's sections, e.g., as part of an enclosing structure. See save()
+      void serialize(support::Serializer& out) const {
+         out.write(neg_intercept);
+         bitvec.serialize(out);
       }
 
-      /// Custom copy constructor is necessary since sdsl's rank support contains a pointer to bitvec
-      LearnedLinear(LearnedLinear&& other) noexcept {
-         neg_intercept = other.neg_intercept;
-         bitvec = other.bitvec;
-         rank = other.rank;
-
-         // reset vector as otherwise rank contains broken pointer
-         rank.set_vector(&bitvec);
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<LearnedLinear>());
+         serialize(out);
+         out.finish();
       }
 
-      /// Custom copy constructor is necessary since sdsl's select support contains a pointer to upper
-      LearnedLinear& operator=(const LearnedLinear& other) noexcept {
-         if (this != &other) {
-            neg_intercept = other.neg_intercept;
-            bitvec = other.bitvec;
-            rank = other.rank;
+      /// Read-only LearnedLinear operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         Data neg_intercept = 0;
+         support::Bitvector<std::uint64_t, support::MappedArray> bitvec{};
 
-            // reset vector as otherwise rank contains broken pointer
-            rank.set_vector(&bitvec);
-         }
-
-         return *this;
-      }
+        public:
+         View() = default;
 
-      /// Custom copy constructor is necessary since sdsl's select support contains a pointer to upper
-      LearnedLinear& operator=(LearnedLinear&& other) noexcept {
-         neg_intercept = other.neg_intercept;
-         bitvec = other.bitvec;
-         rank = other.rank;
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<LearnedLinear>());
+            deserialize(in);
+         }
 
-         // reset vector as otherwise rank contains broken pointer
-         rank.set_vector(&bitvec);
+         /// Reads sections written by serialize(). They remain owned by in's file
+         void deserialize(support::Deserializer& in) {
+            neg_intercept = in.read<Data>();
+            bitvec.deserialize(in);
+         }
 
-         return *this;
-      }
+         forceinline size_t operator()(const Data& key) const {
+            return rank(neg_intercept, bitvec, key);
+         }
 
-      // Destructor does not have to do any special work
-      ~LearnedLinear() noexcept = default;
+         size_t byte_size() const {
+            return bitvec.byte_size() + sizeof(decltype(neg_intercept));
+         }
+      };
    };
 } // namespace exotic_hashing
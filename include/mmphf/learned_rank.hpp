@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <limits>
 #include <random>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -12,6 +14,12 @@
 #include <learned_hashing.hpp>
 
 #include "../support/elias_fano_list.hpp"
+#include "../support/parallel.hpp"
+#include "../support/partitioned_elias_fano_list.hpp"
+#include "../support/pgm_model.hpp"
+#include "../support/rmi_model.hpp"
+#include "../support/serialization.hpp"
+#include "../support/simd_search.hpp"
 #include "../support/support.hpp"
 
 // Order important
@@ -19,28 +27,108 @@
 
 namespace exotic_hashing {
    namespace last_level_search {
+      /**
+       * index of the first element >= searched, searched with the dataset's
+       * bounded lower_bound(searched, lo, hi) within a window of radius
+       * elements on either side of pred_ind. As long as the result lies
+       * outside, the window is moved towards it, doubling radius each time
+       * if Gallop. Each step costs one bounded search instead of an access
+       * per probed element
+       */
+      template<bool Gallop, class Dataset, class Key>
+      forceinline size_t windowed_lower_bound(const Dataset& dataset, size_t pred_ind, const Key& searched,
+                                              size_t radius) {
+         const auto dataset_size = dataset.size();
+         pred_ind = std::min(pred_ind, dataset_size);
+
+         size_t lo = pred_ind - std::min(pred_ind, radius), hi = std::min(dataset_size, pred_ind + radius);
+         size_t res = dataset.lower_bound(searched, lo, hi);
+
+         // dataset[lo] >= searched, i.e., result is at most lo
+         if (res == lo)
+            while (res == lo && lo > 0) {
+               if constexpr (Gallop)
+                  radius *= 2;
+               hi = lo;
+               lo -= std::min(lo, radius);
+               res = dataset.lower_bound(searched, lo, hi);
+            }
+         // dataset[hi - 1] < searched, i.e., result is at least hi
+         else if (res == hi)
+            while (res == hi && hi < dataset_size) {
+               if constexpr (Gallop)
+                  radius *= 2;
+               lo = hi;
+               hi += std::min(dataset_size - hi, radius);
+               res = dataset.lower_bound(searched, lo, hi);
+            }
+
+         return res;
+      }
+
+      /**
+       * window radius for windowed_lower_bound covering most predictions,
+       * i.e., twice predictor's average error measured on a sample of
+       * dataset (or its guaranteed bound if predictor is error bounded)
+       */
+      template<class Dataset, class Predictor>
+      size_t window_radius(const Dataset& dataset, const Predictor& predictor) {
+         if constexpr (requires { predictor.max_error(); })
+            return predictor.max_error() + 1;
+
+         // sampling keeps this cheap compared to training
+         constexpr size_t stride = 64;
+         size_t total_error = 0, samples = 0;
+         for (size_t i = 0; i < dataset.size(); i += stride, samples++) {
+            const size_t pred = predictor(dataset[i]);
+            total_error += pred >= i ? pred - i : i - pred;
+         }
+         return samples == 0 ? 1 : 2 * total_error / samples + 1;
+      }
+
       template<class Key>
       struct SequentialRangeLookup {
+         /// window size (each side) for datasets with native lower_bound, slid on misses
+         size_t radius = 1;
+
+         /// holds no arrays, i.e., operates on mapped files as is
+         using Mapped = SequentialRangeLookup;
+
          SequentialRangeLookup() = default;
 
          template<class Dataset, class Predictor>
-         SequentialRangeLookup(const Dataset& dataset, const Predictor& predictor) {
-            UNUSED(dataset);
-            UNUSED(predictor);
+         SequentialRangeLookup(const Dataset& dataset, const Predictor& predictor)
+             : radius(window_radius(dataset, predictor)) {}
+
+         static std::string name() {
+            return "Sequential";
          }
 
          forceinline size_t byte_size() const {
-            return 0;
+            return sizeof(decltype(radius));
+         }
+
+         void serialize(support::Serializer& out) const {
+            out.write(static_cast<std::uint64_t>(radius));
+         }
+
+         void deserialize(support::Deserializer& in) {
+            radius = in.read<std::uint64_t>();
          }
 
          template<class Dataset>
          forceinline size_t operator()(size_t pred_ind, Key searched, const Dataset& dataset) const {
             size_t actual_ind = pred_ind;
 
-            while (actual_ind > 0 && dataset[actual_ind] > searched)
-               actual_ind--;
-            while (actual_ind < dataset.size() && dataset[actual_ind] < searched)
-               actual_ind++;
+            // scanning would access each element individually, i.e., slide a window searched natively instead
+            if constexpr (support::NativeLowerBound<Dataset, Key>)
+               actual_ind = windowed_lower_bound<false>(dataset, pred_ind, searched, radius);
+            else {
+               while (actual_ind > 0 && dataset[actual_ind] > searched)
+                  actual_ind--;
+               while (actual_ind < dataset.size() && dataset[actual_ind] < searched)
+                  actual_ind++;
+            }
 
             assert(actual_ind == dataset.size() || dataset[actual_ind] >= searched);
             assert(actual_ind >= 0);
@@ -68,46 +156,71 @@ namespace exotic_hashing {
 
       template<class Key>
       struct ExponentialRangeLookup {
+         /// initial window size (each side) for datasets with native lower_bound, doubled on misses
+         size_t radius = 1;
+
+         /// holds no arrays, i.e., operates on mapped files as is
+         using Mapped = ExponentialRangeLookup;
+
          ExponentialRangeLookup() = default;
 
          template<class Dataset, class Predictor>
-         ExponentialRangeLookup(const Dataset& dataset, const Predictor& predictor) {
-            UNUSED(dataset);
-            UNUSED(predictor);
+         ExponentialRangeLookup(const Dataset& dataset, const Predictor& predictor)
+             : radius(window_radius(dataset, predictor)) {}
+
+         static std::string name() {
+            return "Exponential";
          }
 
          forceinline size_t byte_size() const {
-            return 0;
+            return sizeof(decltype(radius));
+         }
+
+         void serialize(support::Serializer& out) const {
+            out.write(static_cast<std::uint64_t>(radius));
+         }
+
+         void deserialize(support::Deserializer& in) {
+            radius = in.read<std::uint64_t>();
          }
 
          template<class Dataset>
          forceinline size_t operator()(size_t pred_ind, Key searched, const Dataset& dataset) const {
-            // fast path correct predictions
-            if (dataset[pred_ind] == searched)
-               return pred_ind;
-
-            const auto dataset_size = dataset.size();
-            size_t interval_start = pred_ind, interval_end = pred_ind + 1;
-
-            size_t err = 1;
-            while (interval_start > 0 && dataset[interval_start] > searched) {
-               interval_end = interval_start;
-               interval_start -= std::min(err, interval_start);
-               err *= 2;
-            }
-            err = 1;
-            while (interval_end < dataset_size && dataset[interval_end] < searched) {
-               interval_start = interval_end;
-               interval_end += std::min(err, dataset_size - interval_end);
-               err *= 2;
+            size_t actual_ind;
+
+            // each probe would be a full access, i.e., gallop with windows searched natively instead
+            if constexpr (support::NativeLowerBound<Dataset, Key>)
+               actual_ind = windowed_lower_bound<true>(dataset, pred_ind, searched, radius);
+            else {
+               const auto dataset_size = dataset.size();
+               pred_ind = std::min(pred_ind, dataset_size - 1);
+
+               // fast path correct predictions
+               if (dataset[pred_ind] == searched)
+                  return pred_ind;
+
+               size_t interval_start = pred_ind, interval_end = pred_ind + 1;
+
+               size_t err = 1;
+               while (interval_start > 0 && dataset[interval_start] > searched) {
+                  interval_end = interval_start;
+                  interval_start -= std::min(err, interval_start);
+                  err *= 2;
+               }
+               err = 1;
+               while (interval_end < dataset_size && dataset[interval_end] < searched) {
+                  interval_start = interval_end;
+                  interval_end += std::min(err, dataset_size - interval_end);
+                  err *= 2;
+               }
+
+               assert(interval_start >= 0);
+               assert(interval_end >= interval_start);
+               assert(interval_end <= dataset.size());
+
+               actual_ind = support::lower_bound(interval_start, interval_end, searched, dataset);
             }
 
-            assert(interval_start >= 0);
-            assert(interval_end >= interval_start);
-            assert(interval_end <= dataset.size());
-
-            const size_t actual_ind = support::lower_bound(interval_start, interval_end, searched, dataset);
-
 #if NDEBUG == 0
             // tricking the compiler like this should be illegal...
             auto self = (std::remove_const_t<std::remove_pointer_t<decltype(this)>>*) (this);
@@ -132,20 +245,41 @@ namespace exotic_hashing {
       struct BinaryRangeLookup {
          size_t max_error = 0;
 
+         /// holds no arrays, i.e., operates on mapped files as is
+         using Mapped = BinaryRangeLookup;
+
          BinaryRangeLookup() = default;
 
          template<class Dataset, class Predictor>
          BinaryRangeLookup(const Dataset& dataset, const Predictor& predictor) {
+            // error bounded models, e.g., support::PGMModel, guarantee their bound without measuring it
+            if constexpr (requires { predictor.max_error(); }) {
+               max_error = predictor.max_error();
+               return;
+            }
+
             for (size_t i = 0; i < dataset.size(); i++) {
                const size_t pred = predictor(dataset[i]);
                max_error = std::max(max_error, pred >= i ? pred - i : i - pred);
             }
          }
 
+         static std::string name() {
+            return "Binary";
+         }
+
          forceinline size_t byte_size() const {
             return sizeof(decltype(max_error));
          }
 
+         void serialize(support::Serializer& out) const {
+            out.write(static_cast<std::uint64_t>(max_error));
+         }
+
+         void deserialize(support::Deserializer& in) {
+            max_error = in.read<std::uint64_t>();
+         }
+
          template<class Dataset>
          forceinline size_t operator()(size_t pred_ind, Key searched, const Dataset& dataset) const {
             // compute interval bounds
@@ -169,6 +303,299 @@ namespace exotic_hashing {
             return actual_ind;
          }
 
+#if NDEBUG == 0
+         double avg_error() const {
+            return static_cast<double>(total_error) / static_cast<double>(queries);
+         }
+
+        private:
+         size_t total_error = 0, queries = 0;
+#endif
+      };
+
+      /**
+       * Like BinaryRangeLookup, but with one search window per bucket of
+       * BucketSize consecutive predictions instead of one global max_error,
+       * i.e., a badly predicted region only widens its own buckets' windows.
+       *
+       * Bucket b's window [lo, hi] spans from the first key predicted into
+       * a bucket >= b to the first key predicted into a bucket > b. For
+       * monotone models (e.g., MonotoneRMIHash), this provably contains the
+       * lower bound of any key predicted into b. Otherwise, results on
+       * window borders are verified and corrected if necessary
+       *
+       * @tparam Container storage of the windows. MappedArray yields a
+       *   read-only lookup operating on a mapped file, see deserialize()
+       */
+      template<class Key, size_t BucketSize = 64, template<class> class Container = std::vector>
+      struct BucketedRangeLookup {
+         static_assert(BucketSize > 0);
+
+         struct Window {
+            std::uint32_t lo, hi;
+         };
+         Container<Window> windows;
+
+         /// read-only lookup operating on a mapped file, see deserialize()
+         using Mapped = BucketedRangeLookup<Key, BucketSize, support::MappedArray>;
+
+         BucketedRangeLookup() = default;
+
+         template<class Dataset, class Predictor>
+         BucketedRangeLookup(const Dataset& dataset, const Predictor& predictor) {
+            if (dataset.size() >= std::numeric_limits<std::uint32_t>::max())
+               throw std::runtime_error("Failed to build BucketedRangeLookup: dataset exceeds 2^32 - 1 keys");
+
+            const size_t bucket_cnt = dataset.size() / BucketSize + 1;
+            std::vector<size_t> buckets(dataset.size());
+            for (size_t i = 0; i < dataset.size(); i++)
+               buckets[i] = std::min(predictor(dataset[i]) / BucketSize, bucket_cnt - 1);
+
+            windows.assign(bucket_cnt, {static_cast<std::uint32_t>(dataset.size()), 0});
+            // lo: first index of any key predicted into bucket >= b, i.e., suffix minimum
+            for (size_t i = dataset.size(); i-- > 0;)
+               windows[buckets[i]].lo = static_cast<std::uint32_t>(i);
+            for (size_t b = bucket_cnt - 1; b-- > 0;)
+               windows[b].lo = std::min(windows[b].lo, windows[b + 1].lo);
+            // hi: one past the last index of any key predicted into bucket <= b, i.e., prefix maximum
+            for (size_t i = 0; i < dataset.size(); i++)
+               windows[buckets[i]].hi = static_cast<std::uint32_t>(i + 1);
+            for (size_t b = 1; b < bucket_cnt; b++)
+               windows[b].hi = std::max(windows[b].hi, windows[b - 1].hi);
+
+            windows.shrink_to_fit();
+         }
+
+         static std::string name() {
+            return "Bucketed";
+         }
+
+         forceinline size_t byte_size() const {
+            return sizeof(Window) * windows.size() + sizeof(decltype(windows));
+         }
+
+         void serialize(support::Serializer& out) const {
+            out.write_array(windows.data(), windows.size());
+         }
+
+         void deserialize(support::Deserializer& in) {
+            in.read_array(windows);
+         }
+
+         template<class Dataset>
+         forceinline size_t operator()(size_t pred_ind, Key searched, const Dataset& dataset) const {
+            const auto& window = windows[std::min(pred_ind / BucketSize, windows.size() - 1)];
+            const size_t lo = std::min<size_t>(window.lo, window.hi);
+
+            size_t actual_ind = support::lower_bound(lo, window.hi, searched, dataset);
+
+            // only non monotone models may predict keys outside their window
+            if (unlikely((actual_ind == lo && lo > 0 && dataset[lo - 1] >= searched) ||
+                         (actual_ind == window.hi && actual_ind < dataset.size() && dataset[actual_ind] < searched)))
+               actual_ind = support::lower_bound(0, dataset.size(), searched, dataset);
+
+#if NDEBUG == 0
+            // tricking the compiler like this should be illegal...
+            auto self = (std::remove_const_t<std::remove_pointer_t<decltype(this)>>*) (this);
+            self->total_error += actual_ind > pred_ind ? actual_ind - pred_ind : pred_ind - actual_ind;
+            self->queries++;
+#endif
+
+            return actual_ind;
+         }
+
+#if NDEBUG == 0
+         double avg_error() const {
+            return static_cast<double>(total_error) / static_cast<double>(queries);
+         }
+
+        private:
+         size_t total_error = 0, queries = 0;
+#endif
+      };
+      /**
+       * Like BinaryRangeLookup, but linearly scans the max_error window
+       * outwards from the prediction in blocks of one cache line, comparing
+       * all keys of a block at once (see support::simd_lower_bound). Cost is
+       * proportional to the actual instead of the maximum error, i.e., best
+       * suited for accurate models. Beyond MaxBlocks blocks, the remaining
+       * window is binary searched.
+       *
+       * Compressed datasets providing decode(), e.g., support::EliasFanoList,
+       * are decoded block wise instead of accessing each element individually
+       */
+      template<class Key, size_t MaxBlocks = 8>
+      struct SIMDLinearRangeLookup {
+         size_t max_error = 0;
+
+         /// holds no arrays, i.e., operates on mapped files as is
+         using Mapped = SIMDLinearRangeLookup;
+
+         SIMDLinearRangeLookup() = default;
+
+         template<class Dataset, class Predictor>
+         SIMDLinearRangeLookup(const Dataset& dataset, const Predictor& predictor)
+             : max_error(BinaryRangeLookup<Key>(dataset, predictor).max_error) {}
+
+         static std::string name() {
+            return "SIMDLinear";
+         }
+
+         forceinline size_t byte_size() const {
+            return sizeof(decltype(max_error));
+         }
+
+         void serialize(support::Serializer& out) const {
+            out.write(static_cast<std::uint64_t>(max_error));
+         }
+
+         void deserialize(support::Deserializer& in) {
+            max_error = in.read<std::uint64_t>();
+         }
+
+         template<class Dataset>
+         forceinline size_t operator()(size_t pred_ind, Key searched, const Dataset& dataset) const {
+            const auto interval_start = (pred_ind > max_error) * (pred_ind - max_error);
+            const auto interval_end = std::min(pred_ind + max_error, dataset.size() - 1) + 1;
+
+            const size_t actual_ind =
+               support::simd_lower_bound(dataset, interval_start, interval_end, pred_ind, searched, MaxBlocks);
+
+#if NDEBUG == 0
+            // tricking the compiler like this should be illegal...
+            auto self = (std::remove_const_t<std::remove_pointer_t<decltype(this)>>*) (this);
+            self->total_error += actual_ind > pred_ind ? actual_ind - pred_ind : pred_ind - actual_ind;
+            self->queries++;
+#endif
+
+            return actual_ind;
+         }
+
+#if NDEBUG == 0
+         double avg_error() const {
+            return static_cast<double>(total_error) / static_cast<double>(queries);
+         }
+
+        private:
+         size_t total_error = 0, queries = 0;
+#endif
+      };
+
+      /**
+       * Narrows the max_error window by probing one cache line sized block
+       * per step until at most two blocks remain, which are scanned via
+       * SIMDLinearRangeLookup's block compares. The first probe is centered
+       * on the prediction, all further ones interpolate between the
+       * window's borders. Whenever interpolation fails to halve the window,
+       * e.g., on skewed data, the next probe bisects it instead.
+       *
+       * Suited for models with large maximum errors, where linear scans
+       * become too expensive
+       */
+      template<class Key>
+      struct InterpolationSIMDRangeLookup {
+         size_t max_error = 0;
+
+         /// holds no arrays, i.e., operates on mapped files as is
+         using Mapped = InterpolationSIMDRangeLookup;
+
+         InterpolationSIMDRangeLookup() = default;
+
+         template<class Dataset, class Predictor>
+         InterpolationSIMDRangeLookup(const Dataset& dataset, const Predictor& predictor)
+             : max_error(BinaryRangeLookup<Key>(dataset, predictor).max_error) {}
+
+         static std::string name() {
+            return "InterpolationSIMD";
+         }
+
+         forceinline size_t byte_size() const {
+            return sizeof(decltype(max_error));
+         }
+
+         void serialize(support::Serializer& out) const {
+            out.write(static_cast<std::uint64_t>(max_error));
+         }
+
+         void deserialize(support::Deserializer& in) {
+            max_error = in.read<std::uint64_t>();
+         }
+
+         template<class Dataset>
+         forceinline size_t operator()(size_t pred_ind, Key searched, const Dataset& dataset) const {
+            constexpr size_t block = support::simd_block<Key>;
+
+            // result is within [lo, hi]
+            size_t lo = (pred_ind > max_error) * (pred_ind - max_error);
+            size_t hi = std::min(pred_ind + max_error, dataset.size() - 1) + 1;
+
+            // interpolation points (index, key) with left key < searched <= right key, known from earlier probes
+            size_t left_ind = 0, right_ind = 0;
+            Key left_key{}, right_key{};
+            bool left_known = false, right_known = false;
+
+            size_t probe = pred_ind, actual_ind;
+            Key buffer[block];
+            while (true) {
+               if (hi - lo <= 2 * block) {
+                  actual_ind = support::simd_lower_bound(dataset, lo, hi, lo, searched);
+                  break;
+               }
+
+               const size_t window = hi - lo;
+               const auto first = std::clamp(probe, lo + block / 2, hi - block / 2) - block / 2;
+               const auto keys = support::load_block(dataset, first, block, buffer);
+               const auto rank = support::simd_rank(keys, searched);
+               if (rank > 0 && rank < block) {
+                  actual_ind = first + rank;
+                  break;
+               }
+               if (rank == 0) {
+                  hi = first;
+                  right_ind = first, right_key = keys[0], right_known = true;
+               } else {
+                  lo = first + block;
+                  left_ind = first + block - 1, left_key = keys[block - 1], left_known = true;
+               }
+               if (hi - lo <= 2 * block)
+                  continue;
+
+               // interpolation failed to halve the window
+               if (hi - lo > window / 2) {
+                  probe = lo + (hi - lo) / 2;
+                  continue;
+               }
+
+               if (!left_known) {
+                  left_ind = lo, left_key = dataset[lo], left_known = true;
+                  if (searched <= left_key) {
+                     actual_ind = lo;
+                     break;
+                  }
+               }
+               if (!right_known) {
+                  right_ind = hi - 1, right_key = dataset[hi - 1], right_known = true;
+                  if (searched > right_key) {
+                     actual_ind = hi;
+                     break;
+                  }
+               }
+               probe = left_ind +
+                  static_cast<size_t>(static_cast<double>(searched - left_key) /
+                                      static_cast<double>(right_key - left_key) *
+                                      static_cast<double>(right_ind - left_ind));
+            }
+
+#if NDEBUG == 0
+            // tricking the compiler like this should be illegal...
+            auto self = (std::remove_const_t<std::remove_pointer_t<decltype(this)>>*) (this);
+            self->total_error += actual_ind > pred_ind ? actual_ind - pred_ind : pred_ind - actual_ind;
+            self->queries++;
+#endif
+
+            return actual_ind;
+         }
+
 #if NDEBUG == 0
          double avg_error() const {
             return static_cast<double>(total_error) / static_cast<double>(queries);
@@ -180,6 +607,14 @@ namespace exotic_hashing {
       };
    } // namespace last_level_search
 
+   /// whether constructing on size keys with ThreadCount threads should overlap compaction with model training
+   template<size_t ThreadCount>
+   static forceinline bool overlap_compaction(const size_t size) {
+      // small datasets do not amortize thread creation, a single hardware thread only pays for the extra copy
+      const auto threads = std::min(support::resolve_thread_count(ThreadCount), support::resolve_thread_count(0));
+      return threads > 1 && size >= (1 << 16);
+   }
+
    template<class Data, class Model = learned_hashing::MonotoneRMIHash<Data, 1000000>,
             class LastLevelSearch = last_level_search::ExponentialRangeLookup<Data>>
    class UnoptimizedLearnedRank {
@@ -260,8 +695,23 @@ namespace exotic_hashing {
 #endif
    };
 
+   /**
+    * Learned rank MMPHF, storing every second key in sorted order.
+    *
+    * save() and View require Model and LastLevelSearch to provide
+    * serialize(), deserialize() and Mapped, e.g., support::PGMModel or
+    * support::RMIModel and any last_level_search lookup.
+    * learned_hashing's models, e.g., MonotoneRMIHash, are not serializable
+    *
+    * @tparam ThreadCount amount of threads used for construction (0 uses all
+    *   hardware threads). Unless 1 (or the machine only has one hardware
+    *   thread), compacting the dataset to every second key overlaps with
+    *   training the model on the full dataset, at the cost of temporarily
+    *   storing the compacted keys separately. Parallel model training is
+    *   configured on the model, e.g., support::RMIModel
+    */
    template<class Data, class Model = learned_hashing::MonotoneRMIHash<Data, 1000000>,
-            class LastLevelSearch = last_level_search::ExponentialRangeLookup<Data>>
+            class LastLevelSearch = last_level_search::ExponentialRangeLookup<Data>, size_t ThreadCount = 1>
    class LearnedRank {
       std::vector<Data> dataset;
       Model model{};
@@ -277,17 +727,35 @@ namespace exotic_hashing {
          // median of dataset (since is_sorted)
          const size_t half_size = dataset.size() / 2;
 
-         // train on full data
-         model.train(dataset.begin(), dataset.end(), half_size);
-
-         // omit every second element, deleting junk and ensuring the final dataset
-         // vector is minimal, i.e., does not waste any additional space
-         size_t i = 0;
-         for (size_t j = 1; j < dataset.size(); j += 2)
-            dataset[i++] = dataset[j];
-         assert(i == half_size);
-         dataset.erase(dataset.begin() + half_size, dataset.end());
-         dataset.resize(dataset.size());
+         if (overlap_compaction<ThreadCount>(dataset.size())) {
+            // compact into a separate, minimal vector while training on full data
+            std::vector<Data> compacted(half_size);
+            // task 0 (training) runs on the calling thread, task 1 (compaction) on a worker
+            support::parallel_for(
+               0, 2, 2,
+               [&](const size_t, const size_t, const size_t task) {
+                  if (task == 0) {
+                     model.train(dataset.begin(), dataset.end(), half_size);
+                     return;
+                  }
+                  for (size_t i = 0; i < half_size; i++)
+                     compacted[i] = dataset[2 * i + 1];
+               },
+               1);
+            dataset = std::move(compacted);
+         } else {
+            // train on full data
+            model.train(dataset.begin(), dataset.end(), half_size);
+
+            // omit every second element, deleting junk and ensuring the final dataset
+            // vector is minimal, i.e., does not waste any additional space
+            size_t i = 0;
+            for (size_t j = 1; j < dataset.size(); j += 2)
+               dataset[i++] = dataset[j];
+            assert(i == half_size);
+            dataset.erase(dataset.begin() + half_size, dataset.end());
+            dataset.resize(dataset.size());
+         }
          assert(dataset.size() == half_size);
          assert(std::is_sorted(dataset.begin(), dataset.end()));
 
@@ -295,6 +763,26 @@ namespace exotic_hashing {
          lls = LastLevelSearch(dataset, model);
       }
 
+      /// shared by LearnedRank and View, i.e., members are either owning or their mapped counterparts
+      template<class M, class L, class Dataset>
+      static forceinline size_t rank(const M& model, const L& lls, const Dataset& dataset, const Data& key) {
+         // predict using RMI
+         const auto pred_ind = model(key);
+
+         // Last level search to find actual index
+         const auto actual_ind = lls(pred_ind, key, dataset);
+
+         assert(actual_ind == dataset.size() || dataset[actual_ind] >= key);
+         assert(actual_ind == 0 || dataset[actual_ind - 1] < key);
+
+         // edge case last element ('unlikely'?)
+         if (unlikely(actual_ind == dataset.size()))
+            return 2 * actual_ind;
+
+         // all others
+         return 2 * actual_ind + (dataset[actual_ind] == key) * 0x1;
+      }
+
      public:
       LearnedRank() noexcept = default;
 
@@ -331,21 +819,7 @@ namespace exotic_hashing {
       }
 
       forceinline size_t operator()(const Data& key) const {
-         // predict using RMI
-         const auto pred_ind = model(key);
-
-         // Last level search to find actual index
-         const auto actual_ind = lls(pred_ind, key, dataset);
-
-         assert(actual_ind == dataset.size() || dataset[actual_ind] >= key);
-         assert(actual_ind == 0 || dataset[actual_ind - 1] < key);
-
-         // edge case last element ('unlikely'?)
-         if (unlikely(actual_ind == dataset.size()))
-            return 2 * actual_ind;
-
-         // all others
-         return 2 * actual_ind + (dataset[actual_ind] == key) * 0x1;
+         return rank(model, lls, dataset, key);
       }
 
       size_t byte_size() const {
@@ -358,12 +832,62 @@ namespace exotic_hashing {
          return lls.avg_error();
       }
 #endif
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<LearnedRank>());
+         out.write_array(dataset.data(), dataset.size());
+         model.serialize(out);
+         lls.serialize(out);
+         out.finish();
+      }
+
+      /// Read-only LearnedRank operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         support::MappedArray<Data> dataset;
+         support::mapped_t<Model> model;
+         support::mapped_t<LastLevelSearch> lls;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<LearnedRank>());
+            in.read_array(dataset);
+            model.deserialize(in);
+            lls.deserialize(in);
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return rank(model, lls, dataset, key);
+         }
+
+         size_t byte_size() const {
+            return sizeof(file) + sizeof(dataset) + dataset.size() * sizeof(Data) + model.byte_size() +
+               lls.byte_size();
+         }
+      };
    };
 
+   /**
+    * LearnedRank storing every second key in compressed form.
+    *
+    * save() and View additionally require MonotoneList to provide
+    * serialize(), deserialize() and Mapped, as support::EliasFanoList and
+    * support::PartitionedEliasFanoList do, see LearnedRank
+    *
+    * @tparam MonotoneList compressed storage of the sorted keys, e.g.,
+    *   support::EliasFanoList or support::PartitionedEliasFanoList for
+    *   clustered keysets
+    * @tparam ThreadCount amount of threads used for construction (0 uses all
+    *   hardware threads). Unless 1 (or the machine only has one hardware
+    *   thread), compacting the dataset and encoding MonotoneList overlap
+    *   with training the model on the full dataset
+    */
    template<class Data, class Model = learned_hashing::MonotoneRMIHash<Data, 1000000>,
-            class LastLevelSearch = last_level_search::ExponentialRangeLookup<Data>>
+            class LastLevelSearch = last_level_search::ExponentialRangeLookup<Data>,
+            class MonotoneList = support::EliasFanoList<Data>, size_t ThreadCount = 1>
    class CompressedLearnedRank {
-      support::EliasFanoList<Data> efl{};
+      MonotoneList efl{};
       Model model{};
       LastLevelSearch lls;
 
@@ -376,6 +900,28 @@ namespace exotic_hashing {
          // median of dataset (since is_sorted)
          const size_t half_size = dataset.size() / 2;
 
+         if (overlap_compaction<ThreadCount>(dataset.size())) {
+            // compact into a separate vector and encode it while training on full data
+            std::vector<Data> compacted(half_size);
+            // task 0 (training) runs on the calling thread, task 1 (compaction, encoding) on a worker
+            support::parallel_for(
+               0, 2, 2,
+               [&](const size_t, const size_t, const size_t task) {
+                  if (task == 0) {
+                     model.train(dataset.begin(), dataset.end(), half_size);
+                     return;
+                  }
+                  for (size_t i = 0; i < half_size; i++)
+                     compacted[i] = dataset[2 * i + 1];
+                  efl = decltype(efl)(compacted.begin(), compacted.end());
+               },
+               1);
+
+            // train lls using reduced dataset
+            lls = LastLevelSearch(compacted, model);
+            return;
+         }
+
          // train on full data
          model.train(dataset.begin(), dataset.end(), half_size);
 
@@ -397,6 +943,26 @@ namespace exotic_hashing {
          efl = decltype(efl)(dataset.begin(), dataset.end());
       }
 
+      /// shared by CompressedLearnedRank and View, i.e., members are either owning or their mapped counterparts
+      template<class M, class L, class List>
+      static forceinline size_t rank(const M& model, const L& lls, const List& efl, const Data& key) {
+         // predict using RMI
+         const auto pred_ind = model(key);
+
+         // Last level search to find actual index
+         const auto actual_ind = lls(pred_ind, key, efl);
+
+         assert(actual_ind == efl.size() || efl[actual_ind] >= key);
+         assert(actual_ind == 0 || efl[actual_ind - 1] < key);
+
+         // edge case last element ('unlikely'?)
+         if (unlikely(actual_ind == efl.size()))
+            return 2 * actual_ind;
+
+         // all others
+         return 2 * actual_ind + (efl[actual_ind] == key) * 0x1;
+      }
+
      public:
       CompressedLearnedRank() noexcept = default;
 
@@ -429,25 +995,14 @@ namespace exotic_hashing {
       }
 
       static std::string name() {
-         return "CompressedLearnedRank<" + Model::name() + ">";
+         if constexpr (std::is_same_v<MonotoneList, support::EliasFanoList<Data>>)
+            return "CompressedLearnedRank<" + Model::name() + ">";
+         else
+            return "CompressedLearnedRank<" + Model::name() + ", " + MonotoneList::name() + ">";
       }
 
       forceinline size_t operator()(const Data& key) const {
-         // predict using RMI
-         const auto pred_ind = model(key);
-
-         // Last level search to find actual index
-         const auto actual_ind = lls(pred_ind, key, efl);
-
-         assert(actual_ind == efl.size() || efl[actual_ind] >= key);
-         assert(actual_ind == 0 || efl[actual_ind - 1] < key);
-
-         // edge case last element ('unlikely'?)
-         if (unlikely(actual_ind == efl.size()))
-            return 2 * actual_ind;
-
-         // all others
-         return 2 * actual_ind + (efl[actual_ind] == key) * 0x1;
+         return rank(model, lls, efl, key);
       }
 
       size_t byte_size() const {
@@ -460,5 +1015,38 @@ namespace exotic_hashing {
          return lls.avg_error();
       }
 #endif
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<CompressedLearnedRank>());
+         efl.serialize(out);
+         model.serialize(out);
+         lls.serialize(out);
+         out.finish();
+      }
+
+      /// Read-only CompressedLearnedRank operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         support::mapped_t<MonotoneList> efl;
+         support::mapped_t<Model> model;
+         support::mapped_t<LastLevelSearch> lls;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<CompressedLearnedRank>());
+            efl.deserialize(in);
+            model.deserialize(in);
+            lls.deserialize(in);
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return rank(model, lls, efl, key);
+         }
+
+         size_t byte_size() const {
+            return sizeof(file) + efl.byte_size() + model.byte_size() + lls.byte_size();
+         }
+      };
    };
 } // namespace exotic_hashing
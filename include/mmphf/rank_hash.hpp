@@ -2,9 +2,14 @@
 
 #include <algorithm>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "include/convenience/builtins.hpp"
+#include "include/support/elias_fano_list.hpp"
+#include "include/support/partitioned_elias_fano_list.hpp"
+#include "include/support/serialization.hpp"
+#include "include/support/static_search_tree.hpp"
 #include "include/support/support.hpp"
 
 namespace exotic_hashing {
@@ -16,20 +21,52 @@ namespace exotic_hashing {
     * this is only justified if space is also smaller.
     *
     * Using more space than this function is not desirable.
+    *
+    * @tparam Layout storage of the sorted keys. Either a plain sorted
+    *   std::vector, searched via std::lower_bound, or a search optimized
+    *   layout like support::StaticSearchTree. Layouts must support
+    *   operator[], size(), byte_size() and lower_bound(key). save() and View
+    *   additionally require serialize(), deserialize() and Layout::Mapped
     */
-   template<class Data>
+   template<class Data, class Layout = std::vector<Data>>
    class RankHash {
-      std::vector<Data> dataset;
+      static constexpr bool sorted_vector = std::is_same_v<Layout, std::vector<Data>>;
+
+      Layout dataset;
 
-      /// assumes sorted *full* data is in dataset
-      void construct() {
+      /// assumes sorted *full* data is in sorted & requires capability to make modifications
+      void construct(std::vector<Data>& sorted) {
          // omit every second element, deleting junk and ensuring the final dataset
          // vector is minimal, i.e., does not waste any additional space
-         for (size_t i = 1, j = 2; j < dataset.size(); i++, j += 2)
-            dataset[i] = dataset[j];
-         const size_t middle = (dataset.size() / 2) + (dataset.size() & 0x1);
-         dataset.erase(dataset.begin() + middle, dataset.end());
-         dataset.resize(dataset.size());
+         for (size_t i = 1, j = 2; j < sorted.size(); i++, j += 2)
+            sorted[i] = sorted[j];
+         const size_t middle = (sorted.size() / 2) + (sorted.size() & 0x1);
+         sorted.erase(sorted.begin() + middle, sorted.end());
+         sorted.resize(sorted.size());
+
+         if constexpr (sorted_vector)
+            dataset = std::move(sorted);
+         else
+            dataset = Layout(sorted.begin(), sorted.end());
+      }
+
+      /// shared by RankHash and View, i.e., Dataset is either Layout or its mapped counterpart
+      template<class Dataset>
+      static forceinline size_t rank(const Dataset& dataset, const Data& key) {
+         // primitively compute rank of key by:
+         // 1. searching it in the sorted, compressed dataset
+         size_t iter_pos;
+         if constexpr (sorted_vector)
+            iter_pos = std::distance(dataset.begin(), std::lower_bound(dataset.begin(), dataset.end(), key));
+         else
+            iter_pos = dataset.lower_bound(key);
+
+         // 2. computing its rank based on the compressed keyset. If key does
+         //    not match iter assume it was removed during compression and its
+         //    index therefore is 2*iter_pos-1
+         if (unlikely(iter_pos == dataset.size()))
+            return 2 * iter_pos - 1;
+         return 2 * iter_pos - (dataset[iter_pos] == key ? 0 : 1);
       }
 
      public:
@@ -46,12 +83,12 @@ namespace exotic_hashing {
       /**
        * Constructs on arbitrarily ordered keyset
        */
-      explicit RankHash(const std::vector<Data>& d) : dataset(d) {
+      explicit RankHash(std::vector<Data> d) {
          // sort the dataset
-         std::sort(dataset.begin(), dataset.end());
+         std::sort(d.begin(), d.end());
 
          // construct on internal dataset
-         construct();
+         construct(d);
       }
 
       /**
@@ -59,31 +96,62 @@ namespace exotic_hashing {
        */
       template<class RandomIt>
       void construct(const RandomIt& begin, const RandomIt& end) {
-         dataset = decltype(dataset)(begin, end);
-         construct();
+         std::vector<Data> sorted(begin, end);
+         construct(sorted);
       }
 
       static std::string name() {
-         return "RankHash";
+         if constexpr (sorted_vector)
+            return "RankHash";
+         else
+            return "RankHash<" + Layout::name() + ">";
       }
 
       forceinline size_t operator()(const Data& key) const {
-         // primitively compute rank of key by:
-         // 1. binary searching it in the sorted, compressed dataset
-         const auto iter = std::lower_bound(dataset.begin(), dataset.end(), key);
+         return rank(dataset, key);
+      }
 
-         // 2. computing its rank based on the compressed keyset. If key does
-         //    not match iter assume it was removed during compression and its
-         //    index therefore is 2*iter_pos-1
-         const size_t iter_pos = std::distance(dataset.begin(), iter);
+      size_t byte_size() const {
+         if constexpr (sorted_vector)
+            return dataset.size() * sizeof(Data) + sizeof(std::vector<Data>);
+         else
+            return dataset.byte_size();
+      };
 
-         if (unlikely(iter == dataset.end()))
-            return 2 * iter_pos - 1;
-         return 2 * iter_pos - (*iter == key ? 0 : 1);
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<RankHash>());
+         if constexpr (sorted_vector)
+            out.write_array(dataset.data(), dataset.size());
+         else
+            dataset.serialize(out);
+         out.finish();
       }
 
-      size_t byte_size() const {
-         return dataset.size() * sizeof(Data) + sizeof(std::vector<Data>);
+      /// Read-only RankHash operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         support::mapped_t<Layout> dataset;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<RankHash>());
+            if constexpr (sorted_vector)
+               in.read_array(dataset);
+            else
+               dataset.deserialize(in);
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return rank(dataset, key);
+         }
+
+         size_t byte_size() const {
+            if constexpr (sorted_vector)
+               return sizeof(*this) + dataset.size() * sizeof(Data);
+            else
+               return sizeof(file) + dataset.byte_size();
+         }
       };
    };
 
@@ -97,10 +165,17 @@ namespace exotic_hashing {
     * this is only justified if space is also smaller.
     *
     * Using more space than this function is not desirable.
+    *
+    * @tparam MonotoneList compressed storage of the sorted keys, e.g.,
+    *   support::EliasFanoList or support::PartitionedEliasFanoList for
+    *   clustered keysets. Must support operator[], size() and lower_bound(key).
+    *   save() and View additionally require serialize(), deserialize() and
+    *   MonotoneList::Mapped, as provided by support::EliasFanoList and
+    *   support::PartitionedEliasFanoList
     */
-   template<class Data>
+   template<class Data, class MonotoneList = support::EliasFanoList<Data>>
    class CompressedRankHash {
-      support::EliasFanoList<Data> efl{};
+      MonotoneList efl{};
 
       /// assumes sorted *full* data is in dataset & requires capability to make modifications
       void construct(std::vector<Data>& dataset) {
@@ -116,6 +191,19 @@ namespace exotic_hashing {
          efl = decltype(efl)(dataset.begin(), dataset.end());
       }
 
+      /// shared by CompressedRankHash and View, i.e., List is either MonotoneList or its mapped counterpart
+      template<class List>
+      static constexpr forceinline size_t rank(const List& efl, const Data& key) {
+         // compute rank of key via successor search in sorted dataset
+         const auto index = efl.lower_bound(key);
+
+         if (index == efl.size())
+            return 2 * index - 1;
+
+         // account for sorted dataset omitting every second key
+         return 2 * index - (efl[index] == key ? 0 : 1);
+      }
+
      public:
       CompressedRankHash() noexcept = default;
 
@@ -148,22 +236,45 @@ namespace exotic_hashing {
       }
 
       static std::string name() {
-         return "CompressedRankHash";
+         if constexpr (std::is_same_v<MonotoneList, support::EliasFanoList<Data>>)
+            return "CompressedRankHash";
+         else
+            return "CompressedRankHash<" + MonotoneList::name() + ">";
       }
 
       constexpr forceinline size_t operator()(const Data& key) const {
-         // compute rank of key by binary searching in sorted dataset
-         const auto index = support::lower_bound(0, efl.size(), key, efl);
-
-         if (index == efl.size())
-            return 2 * index - 1;
-
-         // account for sorted dataset omitting every second key
-         return 2 * index - (efl[index] == key ? 0 : 1);
+         return rank(efl, key);
       }
 
       size_t byte_size() const {
          return efl.byte_size();
       };
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<CompressedRankHash>());
+         efl.serialize(out);
+         out.finish();
+      }
+
+      /// Read-only CompressedRankHash operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         support::mapped_t<MonotoneList> efl;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<CompressedRankHash>());
+            efl.deserialize(in);
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return rank(efl, key);
+         }
+
+         size_t byte_size() const {
+            return sizeof(file) + efl.byte_size();
+         }
+      };
    };
 } // namespace exotic_hashing
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "include/phf/bit_mwhc.hpp"
+#include "include/support/batch.hpp"
+#include "include/support/serialization.hpp"
+
+// order is important
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing {
+   /**
+    * Minimal perfect hash function in the spirit of BDZ, see Botelho et al.,
+    * "Simple and space-efficient minimal perfect hash functions" (2007).
+    *
+    * BitMWHC maps each key to its hinge vertex, i.e., exactly n of the
+    * ~1.23n vertices are assigned (value != 3). Ranking the hinge among all
+    * assigned vertices yields a minimal perfect hash into [0, n).
+    *
+    * The 2-bit vertex values and the rank directory are interleaved: each
+    * cache line holds 240 vertex values plus a 32-bit rank sample, i.e., the
+    * rank lookup never causes an additional cache miss. Space is ~2.62 bits
+    * per key (1.23 * 512 / 240).
+    */
+   template<class Data, class Hasher, class HyperGraph>
+   class MinimalBitMWHC {
+      using _BitMWHC = BitMWHC<Data, Hasher, HyperGraph>;
+
+      static constexpr size_t values_per_block = 240;
+      static constexpr size_t sample_bits = 32;
+
+      struct alignas(64) Block {
+         std::array<std::uint64_t, 8> words{};
+      };
+
+      Hasher hasher;
+      std::vector<Block> blocks;
+
+      /// Blocks is either an std::vector or a mapped std::span, see View
+      template<class Blocks>
+      static forceinline size_t value(const Blocks& blocks, const size_t vertex) {
+         const auto& block = blocks[vertex / values_per_block];
+         const auto offset = vertex % values_per_block;
+         return (block.words[offset >> 5] >> ((offset & 0x1F) << 1)) & 0x3;
+      }
+
+      /// amount of assigned (i.e., != 3) vertices before vertex
+      template<class Blocks>
+      static forceinline size_t rank(const Blocks& blocks, const size_t vertex) {
+         const auto& block = blocks[vertex / values_per_block];
+         const auto offset = vertex % values_per_block;
+         const auto end = static_cast<std::int64_t>(offset << 1);
+
+         // count unassigned vertices before offset branch free, since offset is essentially random
+         size_t unassigned = 0;
+         for (size_t w = 0; w < block.words.size(); w++) {
+            const auto bits = static_cast<std::uint64_t>(std::clamp<std::int64_t>(end - 64 * w, 0, 64));
+            const auto mask = ((0x1LLU << (bits & 0x3F)) - 1) | (0x0LLU - (bits >> 6));
+            const auto x = block.words[w] & mask;
+            unassigned += __builtin_popcountll(x & (x >> 1) & 0x5555555555555555LLU);
+         }
+
+         return (block.words.back() >> (64 - sample_bits)) + offset - unassigned;
+      }
+
+      template<class Blocks>
+      static forceinline size_t resolve(const Blocks& blocks, const std::tuple<size_t, size_t, size_t>& hs) {
+         const auto [h0, h1, h2] = hs;
+         size_t hash = value(blocks, h0);
+         hash += (h1 != h0) * value(blocks, h1);
+         hash += (h2 != h1 && h2 != h0) * value(blocks, h2);
+
+         const std::array<size_t, 3> hashs{h0, h1, h2};
+         return rank(blocks, hashs[hash % 3]);
+      }
+
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         return resolve(blocks, hs);
+      }
+
+     public:
+      MinimalBitMWHC() noexcept = default;
+
+      template<class RandomIt>
+      MinimalBitMWHC(const RandomIt& begin, const RandomIt& end) {
+         construct(begin, end);
+      }
+
+      explicit MinimalBitMWHC(const std::vector<Data>& dataset) : MinimalBitMWHC(dataset.begin(), dataset.end()) {}
+
+      template<class RandomIt>
+      void construct(const RandomIt& begin, const RandomIt& end) {
+         if (static_cast<std::uint64_t>(std::distance(begin, end)) >> sample_bits)
+            throw std::runtime_error("Failed to construct MinimalBitMWHC: rank samples only support up to 2^" +
+                                     std::to_string(sample_bits) + " keys");
+
+         const _BitMWHC bit_mwhc(begin, end);
+         hasher = bit_mwhc.hasher;
+
+         // interleave vertex values & rank samples
+         const auto& values = bit_mwhc.vertex_values;
+         blocks.assign((values.size() + values_per_block - 1) / values_per_block, Block());
+         size_t assigned = 0;
+         for (size_t b = 0; b < blocks.size(); b++) {
+            auto& block = blocks[b];
+            block.words.back() = static_cast<std::uint64_t>(assigned) << (64 - sample_bits);
+
+            for (size_t offset = 0; offset < values_per_block; offset++) {
+               const size_t vertex = b * values_per_block + offset;
+               // unused trailing vertices are unassigned
+               const std::uint64_t val = vertex < values.size() ? static_cast<std::uint64_t>(values[vertex]) : 3;
+               block.words[offset >> 5] |= val << ((offset & 0x1F) << 1);
+               assigned += val != 3;
+            }
+         }
+         assert(assigned == static_cast<size_t>(std::distance(begin, end)));
+      }
+
+      static std::string name() {
+         return "MinimalBitMWHC";
+      }
+
+      forceinline size_t operator()(const Data& key) const {
+         return resolve(hasher(key));
+      }
+
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). Blocks
+       * of upcoming keys are prefetched while the current window is resolved
+       * (see support::lookup_batch)
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const auto hs = hasher(key);
+               support::prefetch_element(blocks, std::get<0>(hs) / values_per_block);
+               support::prefetch_element(blocks, std::get<1>(hs) / values_per_block);
+               support::prefetch_element(blocks, std::get<2>(hs) / values_per_block);
+               return hs;
+            },
+            [&](const auto& hs) { return resolve(hs); });
+      }
+
+      size_t byte_size() const {
+         return sizeof(hasher) + sizeof(decltype(blocks)) + sizeof(Block) * blocks.size();
+      }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<MinimalBitMWHC>());
+         hasher.serialize(out);
+         out.write_array(blocks.data(), blocks.size());
+         out.finish();
+      }
+
+      /**
+       * Read-only MinimalBitMWHC operating directly on a memory mapped file
+       * written by save(). Blocks remain cache line aligned in the mapping
+       */
+      class View {
+         support::MappedFile file;
+         Hasher hasher;
+         std::span<const Block> blocks;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<MinimalBitMWHC>());
+            hasher.deserialize(in);
+            blocks = in.read_array<Block>();
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return resolve(blocks, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + sizeof(Block) * blocks.size();
+         }
+      };
+   };
+} // namespace exotic_hashing
@@ -1,16 +1,24 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <optional>
 #include <queue>
 #include <random>
 #include <sdsl/bit_vector_il.hpp>
 #include <sdsl/io.hpp>
 #include <sdsl/rrr_vector.hpp>
 #include <sdsl/vectors.hpp>
+#include <span>
 #include <stack>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -20,10 +28,31 @@
 
 #include <hashing.hpp>
 
+#include "../support/batch.hpp"
+#include "../support/bitvector.hpp"
+#include "../support/fixed_width_vector.hpp"
+#include "../support/interleaved_compacted_vector.hpp"
+#include "../support/parallel.hpp"
+#include "../support/serialization.hpp"
+
+// Order important
 #include "../convenience/builtins.hpp"
 
 namespace exotic_hashing {
    namespace support {
+      /// expands a 64-bit seed into the 128-bit seed format expected by AquaHash
+      static forceinline __m128i make_seed(const std::uint64_t lower, const std::uint64_t upper = 0) {
+         return _mm_setr_epi8(static_cast<char>((upper >> 56) & 0xFF), static_cast<char>((upper >> 48) & 0xFF),
+                              static_cast<char>((upper >> 40) & 0xFF), static_cast<char>((upper >> 32) & 0xFF),
+                              static_cast<char>((upper >> 24) & 0xFF), static_cast<char>((upper >> 16) & 0xFF),
+                              static_cast<char>((upper >> 8) & 0xFF), static_cast<char>((upper >> 0) & 0xFF),
+
+                              static_cast<char>((lower >> 56) & 0xFF), static_cast<char>((lower >> 48) & 0xFF),
+                              static_cast<char>((lower >> 40) & 0xFF), static_cast<char>((lower >> 32) & 0xFF),
+                              static_cast<char>((lower >> 24) & 0xFF), static_cast<char>((lower >> 16) & 0xFF),
+                              static_cast<char>((lower >> 8) & 0xFF), static_cast<char>((lower >> 0) & 0xFF));
+      }
+
       template<class Data>
       class Hasher {
          const hashing::AquaHash<Data> hashfn;
@@ -32,18 +61,6 @@ namespace exotic_hashing {
 
          void seed_hashfns() {}
 
-         forceinline __m128i make_seed(const std::uint64_t lower, const std::uint64_t upper = 0) const {
-            return _mm_setr_epi8(static_cast<char>((upper >> 56) & 0xFF), static_cast<char>((upper >> 48) & 0xFF),
-                                 static_cast<char>((upper >> 40) & 0xFF), static_cast<char>((upper >> 32) & 0xFF),
-                                 static_cast<char>((upper >> 24) & 0xFF), static_cast<char>((upper >> 16) & 0xFF),
-                                 static_cast<char>((upper >> 8) & 0xFF), static_cast<char>((upper >> 0) & 0xFF),
-
-                                 static_cast<char>((lower >> 56) & 0xFF), static_cast<char>((lower >> 48) & 0xFF),
-                                 static_cast<char>((lower >> 40) & 0xFF), static_cast<char>((lower >> 32) & 0xFF),
-                                 static_cast<char>((lower >> 24) & 0xFF), static_cast<char>((lower >> 16) & 0xFF),
-                                 static_cast<char>((lower >> 8) & 0xFF), static_cast<char>((lower >> 0) & 0xFF));
-         }
-
         public:
          explicit Hasher(const size_t& N = 1) : reducer(N) {
             // Randomly seed hash functions
@@ -87,6 +104,18 @@ namespace exotic_hashing {
             return *this;
          }
 
+         void serialize(Serializer& out) const {
+            out.write(std::array<std::uint64_t, 4>{static_cast<std::uint64_t>(reducer.N), s0, s1, s2});
+         }
+
+         void deserialize(Deserializer& in) {
+            const auto state = in.read<std::array<std::uint64_t, 4>>();
+            reducer = hashing::reduction::FastModulo<Data>(state[0]);
+            s0 = state[1];
+            s1 = state[2];
+            s2 = state[3];
+         }
+
          forceinline std::tuple<size_t, size_t, size_t> operator()(const Data& d) const {
             return std::make_tuple(reducer(hashfn(d, make_seed(s0))), //
                                    reducer(hashfn(d, make_seed(s1))), //
@@ -94,7 +123,181 @@ namespace exotic_hashing {
          }
       };
 
-      template<class Data, class Hasher, class RandomIt = typename std::vector<Data>::const_iterator>
+      /**
+       * Hasher computing a single 64-bit hash per key. The three vertices
+       * are derived by multiplying the hash with distinct odd constants
+       * (multiply-shift), followed by multiply-shift range reduction into
+       * [0, N), i.e., no modulo and only one hash function evaluation.
+       * The seed is kept in its precomputed __m128i representation.
+       */
+      template<class Data>
+      class MultiplyShiftHasher {
+         const hashing::AquaHash<Data> hashfn;
+         __m128i seed;
+         size_t N;
+
+         static forceinline size_t reduce(const std::uint64_t x, const size_t& n) {
+            return (static_cast<__uint128_t>(x) * n) >> 64;
+         }
+
+        public:
+         explicit MultiplyShiftHasher(const size_t& N = 1) : N(N) {
+            std::random_device r;
+            std::default_random_engine rng(r());
+            std::uniform_int_distribution<std::uint64_t> dist;
+            seed = make_seed(dist(rng), dist(rng));
+         }
+
+         ~MultiplyShiftHasher() = default;
+         MultiplyShiftHasher(const MultiplyShiftHasher& other) : seed(other.seed), N(other.N) {}
+         MultiplyShiftHasher& operator=(const MultiplyShiftHasher& other) {
+            seed = other.seed;
+            N = other.N;
+            return *this;
+         }
+
+         void serialize(Serializer& out) const {
+            out.write(seed);
+            out.write(static_cast<std::uint64_t>(N));
+         }
+
+         void deserialize(Deserializer& in) {
+            seed = in.read<__m128i>();
+            N = in.read<std::uint64_t>();
+         }
+
+         forceinline std::tuple<size_t, size_t, size_t> operator()(const Data& d) const {
+            const std::uint64_t h = hashfn(d, seed);
+            return std::make_tuple(reduce(h, N), //
+                                   reduce(h * 0x9E3779B97F4A7C15LLU, N), //
+                                   reduce(h * 0xC2B2AE3D27D4EB4FLLU, N));
+         }
+      };
+
+      /**
+       * Spatially coupled ("binary fuse") hasher, see Graf & Lemire,
+       * "Binary Fuse Filters: Fast and Smaller Than Xor Filters" (2022).
+       *
+       * Vertices are split into power of two sized segments. Each edge picks
+       * a random window of three consecutive segments and one vertex within
+       * each of them, i.e., an edge's vertices are always distinct and lie at
+       * most 3 segments apart. Such hypergraphs still peel with high
+       * probability at ~1.125n vertices for large n (see vertices_count())
+       * while lookups and peeling touch far fewer distinct pages.
+       *
+       * Only a single hash value is computed per key.
+       */
+      template<class Data>
+      class FuseHasher {
+         static constexpr size_t max_segment_length = 1 << 18;
+
+         const hashing::AquaHash<Data> hashfn;
+         std::uint64_t seed;
+         size_t segment_length_mask = 0, span = 0;
+
+         static size_t segment_length(const size_t& size) {
+            if (size <= 1)
+               return 4;
+            const auto bits = static_cast<size_t>(std::floor(std::log(size) / std::log(3.33) + 2.25));
+            return std::min(static_cast<size_t>(1) << bits, max_segment_length);
+         }
+
+         static long double size_factor(const size_t& size) {
+            if (size <= 1)
+               return 3.;
+            return std::max(1.125L, 0.875L + 0.25L * std::log(1000000.L) / std::log(static_cast<long double>(size)));
+         }
+
+        public:
+         /**
+          * Amount of vertices necessary to peel a fuse graph of dataset_size
+          * edges with high probability. Always an odd multiple of the segment
+          * length, which allows the constructor to recover the segment length
+          * as the largest power of two dividing the vertex count
+          */
+         static size_t vertices_count(const size_t& dataset_size) {
+            const auto capacity = static_cast<size_t>(std::ceil(size_factor(dataset_size) * dataset_size));
+
+            auto seg_len = segment_length(dataset_size);
+            while (seg_len > 1 && capacity / seg_len < 3)
+               seg_len >>= 1;
+
+            auto segment_cnt = std::max((capacity + seg_len - 1) / seg_len, static_cast<size_t>(3));
+            segment_cnt |= 0x1;
+            return segment_cnt * seg_len;
+         }
+
+         /**
+          * @param N amount of vertices. Should be obtained from vertices_count(),
+          *   otherwise the segment length might degenerate
+          */
+         explicit FuseHasher(const size_t& N = 1) {
+            auto seg_len = std::min(N & (~N + 1), max_segment_length);
+            while (seg_len > 1 && N / seg_len < 3)
+               seg_len >>= 1;
+            segment_length_mask = seg_len - 1;
+            span = N / seg_len >= 3 ? (N / seg_len - 2) * seg_len : 0;
+
+            std::random_device r;
+            std::default_random_engine rng(r());
+            seed = std::uniform_int_distribution<std::uint64_t>()(rng);
+         }
+
+         ~FuseHasher() = default;
+         FuseHasher(const FuseHasher& other)
+            : seed(other.seed), segment_length_mask(other.segment_length_mask), span(other.span) {}
+         FuseHasher& operator=(const FuseHasher& other) {
+            seed = other.seed;
+            segment_length_mask = other.segment_length_mask;
+            span = other.span;
+            return *this;
+         }
+
+         void serialize(Serializer& out) const {
+            out.write(std::array<std::uint64_t, 3>{seed, static_cast<std::uint64_t>(segment_length_mask),
+                                                   static_cast<std::uint64_t>(span)});
+         }
+
+         void deserialize(Deserializer& in) {
+            const auto state = in.read<std::array<std::uint64_t, 3>>();
+            seed = state[0];
+            segment_length_mask = state[1];
+            span = state[2];
+         }
+
+         forceinline std::tuple<size_t, size_t, size_t> operator()(const Data& d) const {
+            const std::uint64_t h = hashfn(d, make_seed(seed));
+
+            // window start, then one vertex per segment of the window
+            const size_t h0 = (static_cast<__uint128_t>(h) * span) >> 64;
+            const size_t h1 = (h0 + segment_length_mask + 1) ^ ((h >> 18) & segment_length_mask);
+            const size_t h2 = (h0 + 2 * (segment_length_mask + 1)) ^ (h & segment_length_mask);
+            return std::make_tuple(h0, h1, h2);
+         }
+      };
+
+      /// whether a Hasher dictates the amount of vertices necessary for n keys
+      template<class Hasher>
+      concept ProvidesVertexCount = requires(const size_t& n) {
+         { Hasher::vertices_count(n) } -> std::convertible_to<size_t>;
+      };
+
+      /**
+       * Sequential hypergraph construction & peeling. Each key is hashed
+       * exactly once into a compact array of edge triples, which is then
+       * used for insertion, peeling and vertex value assignment (see
+       * vertices_of()), i.e., the dataset is only ever streamed through once.
+       *
+       * Insertion and peeling are ordered by vertex locality: edge endpoints
+       * are radix partitioned by vertex block (chunk by chunk to bound
+       * temporary memory) such that each block's degree/XOR updates stay
+       * cache resident.
+       *
+       * @tparam VertexIndex datatype used to store edge triples. Must be able
+       *   to represent N-1. Defaults to std::uint32_t (< 2^32 vertices)
+       */
+      template<class Data, class Hasher, class RandomIt = typename std::vector<Data>::const_iterator,
+               class VertexIndex = std::uint32_t>
       class HyperGraph {
          struct Vertex {
             /// limiting to 8 bytes might be sufficient in practice, however, max degree
@@ -134,36 +337,52 @@ namespace exotic_hashing {
             }
          };
 
-         std::vector<Vertex> vertices;
+         /// 2^15 vertices * 8 byte = 256 KiB per block, i.e., a block fits into L2
+         static constexpr size_t block_bits = 15;
+         static constexpr size_t block_mask = (0x1ULL << block_bits) - 1;
 
-         const RandomIt begin, end;
-         const Hasher& hasher;
+         /// amount of edges partitioned at once. Bounds temporary memory to 3 * 8 * 2^22 byte = 96 MiB
+         static constexpr size_t chunk_size = 0x1ULL << 22;
 
-        public:
-         HyperGraph(RandomIt begin, RandomIt end, const Hasher& hasher, const size_t& N)
-            : vertices(N), begin(begin), end(end), hasher(hasher) {
-            // Construct random hypergraph using hasher
-            const size_t dataset_size = std::distance(begin, end);
-            for (size_t i = 0; i < dataset_size; i++) {
-               // TODO(dominik): remove these random cache accesses
-               const auto [h0, h1, h2] = hasher(*(begin + i));
-               vertices[h0].add_edge(i);
-               vertices[h1].add_edge(i);
-               vertices[h2].add_edge(i);
-            }
-         }
+         std::vector<Vertex> vertices;
+         std::vector<std::array<VertexIndex, 3>> edges;
 
          /**
-          * Peels the hypergraph as described Majewski, Bohdan S., et al. in "A
-          * family of perfect hashing methods." The Computer Journal 39.6
-          * (1996): 547-554. Enhanced to reduce space usage during construction
-          * as much as possible, effectively speeding up construction & enabling
-          * more use cases.
-          *
-          * @return peel order, i.e., traversal order of the acyclicity check.
-          *         Empty if hypergraph contains a cycle.
+          * invokes fn(vertex, edge) for all incidences of the cnt edges
+          * edge_at(0), ..., edge_at(cnt - 1), ordered by vertex block
           */
-         std::vector<size_t> peel() {
+         template<class EdgeAt, class Fn>
+         void for_each_incidence_partitioned(const size_t cnt, const EdgeAt& edge_at,
+                                             std::vector<size_t>& bucket_offsets,
+                                             std::vector<std::uint64_t>& incidences, const Fn& fn) {
+            const size_t block_cnt = bucket_offsets.size() - 1;
+
+            // 1. count incidences per vertex block
+            std::fill(bucket_offsets.begin(), bucket_offsets.end(), 0);
+            for (size_t j = 0; j < cnt; j++)
+               for (const auto h : edges[edge_at(j)])
+                  bucket_offsets[(h >> block_bits) + 1]++;
+            for (size_t b = 0; b < block_cnt; b++)
+               bucket_offsets[b + 1] += bucket_offsets[b];
+
+            // 2. scatter incidences, each encoded as 'edge | block local vertex index'
+            for (size_t j = 0; j < cnt; j++) {
+               const size_t edge = edge_at(j);
+               for (const auto h : edges[edge])
+                  incidences[bucket_offsets[h >> block_bits]++] = (static_cast<std::uint64_t>(edge) << block_bits) |
+                     (h & block_mask);
+            }
+
+            // 3. apply block by block. After scattering, bucket_offsets[b] denotes the end of bucket b
+            for (size_t b = 0, inc_ind = 0; b < block_cnt; b++)
+               for (; inc_ind < bucket_offsets[b]; inc_ind++) {
+                  const auto inc = incidences[inc_ind];
+                  fn((b << block_bits) | (inc & block_mask), inc >> block_bits);
+               }
+         }
+
+         /// peels by recursively following vertices that dropped to degree 1, see peel()
+         std::vector<size_t> peel_recursive() {
             // doubles as container for work items during traversal
             // (vertices = 'preliminary section') & final peeling order (edges, denoted as indices into the dataset)
             std::vector<size_t> peel_order;
@@ -182,7 +401,7 @@ namespace exotic_hashing {
                for (size_t curr_ind = peel_order.size() - 1; curr_ind < peel_order.size(); curr_ind++) {
                   // Obtain next vertex to peel from preliminary section of peel_order
                   const auto vind = peel_order[curr_ind];
-                  auto& vertex_to_peel = vertices[vind]; // TODO(dominik): random cache access into vertices
+                  auto& vertex_to_peel = vertices[vind];
 
                   // Between being added to preliminary section of peel_order
                   // and now the peeling of another vertex might have also
@@ -191,11 +410,10 @@ namespace exotic_hashing {
                   // remove from peel_order (through override - see below).
                   if (vertex_to_peel.degree != 1)
                      continue;
-                  // Obtain edge to peel & adjacent vertices
+                  // Obtain edge to peel & adjacent vertices (cached, i.e., no dataset access)
                   const auto edge = vertex_to_peel.retrieve_last();
-                  const auto [h0, h1, h2] = hasher(*(begin + edge)); // TODO(dominik): random cache access into dataset
-                  auto &v0 = vertices[h0], &v1 = vertices[h1],
-                       &v2 = vertices[h2]; // TODO(dominik): random cache accesses into vertices
+                  const auto [h0, h1, h2] = edges[edge];
+                  auto &v0 = vertices[h0], &v1 = vertices[h1], &v2 = vertices[h2];
 
                   // Remove edge from all adjacent vertices
                   v0.remove_edge(edge);
@@ -218,22 +436,382 @@ namespace exotic_hashing {
             // 2. Trim remaining preliminary section containing vertices
             //    such that only the edges are left
             peel_order.resize(completed_ind);
+            return peel_order;
+         }
+
+         /**
+          * peels in rounds, each of which peels all edges incident to a
+          * degree 1 vertex at once. Instead of following random vertices,
+          * each round's claimed edges are radix partitioned by edge block
+          * (deduplicating edges claimed by multiple vertices) and their
+          * incidences by vertex block, i.e., all reads and degree/XOR updates
+          * stay within one cache resident block at a time
+          */
+         std::vector<size_t> peel_partitioned() {
+            std::vector<size_t> peel_order;
+            peel_order.reserve(edges.size());
+
+            const size_t vertex_blocks = (vertices.size() + block_mask) >> block_bits;
+            const size_t edge_blocks = (edges.size() + block_mask) >> block_bits;
+            std::vector<size_t> vertex_offsets(vertex_blocks + 1), edge_offsets(edge_blocks + 1);
+            std::vector<std::uint64_t> incidences(3 * std::min(chunk_size, edges.size()));
+            std::vector<std::uint64_t> claimed, partitioned;
+            std::array<std::uint64_t, (block_mask + 1) / 64> seen{};
+
+            // 1. Initial frontier consists of all vertices with degree 1, ascending
+            std::vector<size_t> frontier, next_frontier;
+            for (size_t v = 0; v < vertices.size(); v++)
+               if (vertices[v].degree == 1)
+                  frontier.push_back(v);
+
+            while (!frontier.empty()) {
+               // 2. Each degree 1 vertex claims its edge. Frontier is ordered by vertex block
+               claimed.clear();
+               for (const auto v : frontier)
+                  if (vertices[v].degree == 1)
+                     claimed.push_back(vertices[v].retrieve_last());
+
+               // 3. Partition claimed edges by edge block and commit each edge once
+               std::fill(edge_offsets.begin(), edge_offsets.end(), 0);
+               for (const auto edge : claimed)
+                  edge_offsets[(edge >> block_bits) + 1]++;
+               for (size_t b = 0; b < edge_blocks; b++)
+                  edge_offsets[b + 1] += edge_offsets[b];
+               partitioned.resize(claimed.size());
+               for (const auto edge : claimed)
+                  partitioned[edge_offsets[edge >> block_bits]++] = edge;
+
+               const size_t round_begin = peel_order.size();
+               for (size_t b = 0, i = 0; b < edge_blocks; b++) {
+                  const size_t bucket_begin = i;
+                  for (; i < edge_offsets[b]; i++) {
+                     const auto local = partitioned[i] & block_mask;
+                     if (seen[local >> 6] & (0x1ULL << (local & 0x3F)))
+                        continue;
+                     seen[local >> 6] |= 0x1ULL << (local & 0x3F);
+                     peel_order.push_back(partitioned[i]);
+                  }
+                  for (size_t j = bucket_begin; j < i; j++)
+                     seen[(partitioned[j] & block_mask) >> 6] = 0;
+               }
+               const size_t round_end = peel_order.size();
+
+               // 4. Remove this round's edges chunk by chunk, collecting vertices that dropped to degree 1
+               next_frontier.clear();
+               for (size_t from = round_begin; from < round_end; from += chunk_size)
+                  for_each_incidence_partitioned(
+                     std::min(chunk_size, round_end - from), [&](const size_t j) { return peel_order[from + j]; },
+                     vertex_offsets, incidences, [&](const size_t v, const size_t edge) {
+                        vertices[v].remove_edge(edge);
+                        // a vertex drops to degree 1 exactly once since degrees only decrease
+                        if (vertices[v].degree == 1)
+                           next_frontier.push_back(v);
+                     });
+               std::swap(frontier, next_frontier);
+            }
+
+            return peel_order;
+         }
+
+        public:
+         HyperGraph(RandomIt begin, RandomIt end, const Hasher& hasher, const size_t& N) : vertices(N) {
+            if (unlikely(N - 1 > std::numeric_limits<VertexIndex>::max()))
+               throw std::runtime_error("Failed to construct HyperGraph: " + std::to_string(N) +
+                                        " vertices exceed VertexIndex");
+
+            // 1. Hash each key exactly once
+            const size_t dataset_size = std::distance(begin, end);
+            edges.resize(dataset_size);
+            for (size_t i = 0; i < dataset_size; i++) {
+               const auto [h0, h1, h2] = hasher(*(begin + i));
+               edges[i] = {static_cast<VertexIndex>(h0), static_cast<VertexIndex>(h1), static_cast<VertexIndex>(h2)};
+            }
+
+            // 2. Construct random hypergraph. Small graphs fit into cache anyways
+            const size_t block_cnt = (N + block_mask) >> block_bits;
+            if (block_cnt <= 1) {
+               for (size_t i = 0; i < dataset_size; i++)
+                  for (const auto h : edges[i])
+                     vertices[h].add_edge(i);
+               return;
+            }
+
+            std::vector<size_t> bucket_offsets(block_cnt + 1);
+            std::vector<std::uint64_t> incidences(3 * std::min(chunk_size, dataset_size));
+            for (size_t chunk_begin = 0; chunk_begin < dataset_size; chunk_begin += chunk_size)
+               for_each_incidence_partitioned(
+                  std::min(chunk_size, dataset_size - chunk_begin), [&](const size_t j) { return chunk_begin + j; },
+                  bucket_offsets, incidences, [&](const size_t v, const size_t edge) { vertices[v].add_edge(edge); });
+         }
+
+         /**
+          * Peels the hypergraph as described Majewski, Bohdan S., et al. in "A
+          * family of perfect hashing methods." The Computer Journal 39.6
+          * (1996): 547-554. Enhanced to reduce space usage during construction
+          * as much as possible, effectively speeding up construction & enabling
+          * more use cases.
+          *
+          * Graphs exceeding a single vertex block are peeled in locality
+          * ordered rounds (see peel_partitioned()), small ones by following
+          * vertices that dropped to degree 1 (see peel_recursive())
+          *
+          * @return peel order, i.e., traversal order of the acyclicity check.
+          *         Empty if hypergraph contains a cycle.
+          */
+         std::vector<size_t> peel() {
+            auto peel_order = vertices.size() <= block_mask + 1 ? peel_recursive() : peel_partitioned();
+
+            // Check if there are any edges left. If so, the acyclicity test has failed.
+            // Since we started with dataset.size() edges, checking whether this exact
+            // amount has been peeled is sufficient
+            if (peel_order.size() != edges.size())
+               return {};
+
+            return peel_order;
+         }
+
+         /**
+          * @return the vertices (h0, h1, h2) of a given edge, i.e., of the
+          *   edge-th key, without rehashing it
+          */
+         forceinline std::tuple<size_t, size_t, size_t> vertices_of(const size_t edge) const {
+            const auto& e = edges[edge];
+            return std::make_tuple(e[0], e[1], e[2]);
+         }
+      };
+
+      /**
+       * Drop in replacement for HyperGraph that constructs and peels using
+       * multiple threads. Edges are inserted concurrently using atomic
+       * XOR/degree updates and peeling proceeds in rounds, each of which
+       * peels all degree 1 vertices at once.
+       *
+       * Since the 2-core of a hypergraph is unique, peeling succeeds
+       * exactly when sequential peeling would for the same Hasher.
+       *
+       * Like HyperGraph, each key is hashed exactly once (during the parallel
+       * insertion) into a compact array of edge triples, which peeling and
+       * vertex value assignment read instead of rehashing.
+       *
+       * @tparam ThreadCount amount of worker threads. 0 uses all hardware threads
+       * @tparam VertexIndex datatype used to store edge triples. Must be able
+       *   to represent N-1. Defaults to std::uint32_t (< 2^32 vertices)
+       */
+      template<class Data, class Hasher, class RandomIt = typename std::vector<Data>::const_iterator,
+               size_t ThreadCount = 0, class VertexIndex = std::uint32_t>
+      class ParallelHyperGraph {
+         /// vertex layout equivalent to HyperGraph::Vertex, i.e., 16 bit degree
+         /// in upper bits and 48 bit edge XOR in lower bits, packed into a
+         /// single word to enable atomic updates
+         using Vertex = std::atomic<std::uint64_t>;
+         static constexpr std::uint64_t degree_one = 0x1ULL << 48;
+         static constexpr std::uint64_t edges_mask = degree_one - 1;
+
+         std::vector<Vertex> vertices;
+         std::vector<std::array<VertexIndex, 3>> edges;
+         std::vector<size_t> round_offsets;
+         std::vector<std::uint8_t> hinge_slots;
+
+         const size_t threads = resolve_thread_count(ThreadCount);
+
+         forceinline static void add_edge(Vertex& v, const size_t edge) {
+            // degree and edge bits are disjoint, hence two independent
+            // atomic operations yield a consistent final state
+            v.fetch_add(degree_one, std::memory_order_relaxed);
+            v.fetch_xor(edge & edges_mask, std::memory_order_relaxed);
+         }
+
+         /// @return degree after removal
+         forceinline static size_t remove_edge(Vertex& v, const size_t edge) {
+            const auto prev = v.fetch_sub(degree_one, std::memory_order_relaxed);
+            v.fetch_xor(edge & edges_mask, std::memory_order_relaxed);
+
+            assert((prev >> 48) > 0);
+            return (prev >> 48) - 1;
+         }
+
+         forceinline static size_t degree(const Vertex& v) {
+            return v.load(std::memory_order_relaxed) >> 48;
+         }
+
+         forceinline static size_t retrieve_last(const Vertex& v) {
+            // retrieving the last edge only works when degree == 1 due to XOR-trick
+            assert(degree(v) == 1);
+            return v.load(std::memory_order_relaxed) & edges_mask;
+         }
 
-            // 3. Check if there are any edges left. If so, the acyclicity test has failed.
-            //    Since we started with dataset.size() edges, checking whether this exact
-            //    amount has been peeled is sufficient
+        public:
+         ParallelHyperGraph(RandomIt begin, RandomIt end, const Hasher& hasher, const size_t& N) : vertices(N) {
+            if (unlikely(N - 1 > std::numeric_limits<VertexIndex>::max()))
+               throw std::runtime_error("Failed to construct ParallelHyperGraph: " + std::to_string(N) +
+                                        " vertices exceed VertexIndex");
+
+            // Construct random hypergraph using hasher, hashing each key exactly once and inserting edges concurrently
             const size_t dataset_size = std::distance(begin, end);
-            if (peel_order.size() != dataset_size)
+            edges.resize(dataset_size);
+            parallel_for(0, dataset_size, threads, [&](const size_t from, const size_t to, const size_t) {
+               for (size_t i = from; i < to; i++) {
+                  const auto [h0, h1, h2] = hasher(*(begin + i));
+                  edges[i] = {static_cast<VertexIndex>(h0), static_cast<VertexIndex>(h1),
+                              static_cast<VertexIndex>(h2)};
+                  add_edge(vertices[h0], i);
+                  add_edge(vertices[h1], i);
+                  add_edge(vertices[h2], i);
+               }
+            });
+         }
+
+         /**
+          * Peels the hypergraph in parallel rounds. Each round first
+          * determines, for every edge incident to a degree 1 vertex, its
+          * hinge, i.e., its first vertex of degree 1 (read only). Afterwards
+          * all such edges are removed concurrently, collecting vertices that
+          * dropped to degree 1 for the next round.
+          *
+          * @return peel order, i.e., traversal order of the acyclicity check
+          *         with edges grouped by round (see rounds()). Empty if
+          *         hypergraph contains a cycle.
+          */
+         std::vector<size_t> peel() {
+            std::vector<size_t> peel_order;
+            round_offsets = {0};
+            hinge_slots.clear();
+
+            // per chunk scratch space, concatenated in chunk order
+            std::vector<std::vector<size_t>> frontiers(threads);
+            std::vector<std::vector<std::pair<size_t, std::uint8_t>>> peeled(threads);
+
+            std::vector<size_t> frontier;
+            const auto gather_frontier = [&](const size_t chunk_cnt) {
+               frontier.clear();
+               for (size_t c = 0; c < chunk_cnt; c++) {
+                  frontier.insert(frontier.end(), frontiers[c].begin(), frontiers[c].end());
+                  frontiers[c].clear();
+               }
+            };
+
+            // 1. Initial frontier consists of all vertices with degree 1
+            auto chunks = parallel_for(0, vertices.size(), threads, [&](const size_t from, const size_t to,
+                                                                         const size_t c) {
+               for (size_t v = from; v < to; v++)
+                  if (degree(vertices[v]) == 1)
+                     frontiers[c].push_back(v);
+            });
+            gather_frontier(chunks);
+
+            while (!frontier.empty()) {
+               // 2. Determine edges to peel this round (read only). Each edge is
+               //    peeled by exactly one vertex, i.e., its first degree 1 vertex
+               chunks = parallel_for(0, frontier.size(), threads, [&](const size_t from, const size_t to,
+                                                                      const size_t c) {
+                  for (size_t i = from; i < to; i++) {
+                     const auto v = frontier[i];
+                     if (degree(vertices[v]) != 1)
+                        continue;
+
+                     const auto edge = retrieve_last(vertices[v]);
+                     const auto& hs = edges[edge];
+                     const std::uint8_t slot =
+                        degree(vertices[hs[0]]) == 1 ? 0 : (degree(vertices[hs[1]]) == 1 ? 1 : 2);
+                     if (hs[slot] == v)
+                        peeled[c].emplace_back(edge, slot);
+                  }
+               });
+
+               const size_t round_begin = peel_order.size();
+               for (size_t c = 0; c < chunks; c++) {
+                  for (const auto& [edge, slot] : peeled[c]) {
+                     peel_order.push_back(edge);
+                     hinge_slots.push_back(slot);
+                  }
+                  peeled[c].clear();
+               }
+               const size_t round_end = peel_order.size();
+               if (round_begin == round_end)
+                  break;
+               round_offsets.push_back(round_end);
+
+               // 3. Concurrently remove this round's edges from the hypergraph
+               chunks = parallel_for(round_begin, round_end, threads, [&](const size_t from, const size_t to,
+                                                                          const size_t c) {
+                  for (size_t i = from; i < to; i++) {
+                     const auto edge = peel_order[i];
+                     const auto [h0, h1, h2] = edges[edge];
+
+                     // a vertex drops to degree 1 exactly once since degrees only decrease
+                     if (remove_edge(vertices[h0], edge) == 1)
+                        frontiers[c].push_back(h0);
+                     if (remove_edge(vertices[h1], edge) == 1)
+                        frontiers[c].push_back(h1);
+                     if (remove_edge(vertices[h2], edge) == 1)
+                        frontiers[c].push_back(h2);
+                  }
+               });
+
+               gather_frontier(chunks);
+            }
+
+            // 4. Check if there are any edges left. If so, the acyclicity test has failed.
+            if (peel_order.size() != edges.size()) {
+               round_offsets = {0};
+               hinge_slots.clear();
                return {};
+            }
 
             return peel_order;
          }
+
+         /**
+          * Round boundaries of the last successful peel, i.e., round i
+          * consists of peel_order[rounds()[i], rounds()[i+1]). Edges of the
+          * same round never share their hinge vertex and their non hinge
+          * vertices are only ever hinges of edges peeled in later rounds,
+          * hence vertex values can be assigned concurrently per round.
+          */
+         const std::vector<size_t>& rounds() const {
+            return round_offsets;
+         }
+
+         /**
+          * hinges()[i] denotes which of h0, h1, h2 (0, 1, 2) of edge
+          * peel_order[i] was of degree 1 when it was peeled
+          */
+         const std::vector<std::uint8_t>& hinges() const {
+            return hinge_slots;
+         }
+
+         /**
+          * @return the vertices (h0, h1, h2) of a given edge, i.e., of the
+          *   edge-th key, without rehashing it
+          */
+         forceinline std::tuple<size_t, size_t, size_t> vertices_of(const size_t edge) const {
+            const auto& e = edges[edge];
+            return std::make_tuple(e[0], e[1], e[2]);
+         }
+
+         /// amount of worker threads used for construction
+         static size_t thread_count() {
+            return resolve_thread_count(ThreadCount);
+         }
+      };
+
+      /// whether a HyperGraph implementation peels in rounds, exposing rounds() and hinges()
+      template<class HyperGraph>
+      concept RoundPeeling = requires(const HyperGraph& g) {
+         g.rounds();
+         g.hinges();
+         HyperGraph::thread_count();
       };
    } // namespace support
 
    template<class Data, class Hasher = support::Hasher<Data>, class HyperGraph = support::HyperGraph<Data, Hasher>>
    class MWHC;
 
+   /**
+    * MWHC whose unset (i.e., 0 or N) vertex values only take a single bit.
+    * Set values are packed densely, located via rank on an interleaved
+    * bitvector. See InterleavedCompactedMWHC for a faster, but larger layout
+    */
    template<class Data, class Hasher = support::Hasher<Data>, class HyperGraph = support::HyperGraph<Data, Hasher>>
    class CompactedMWHC {
       using _MWHC = MWHC<Data, Hasher, HyperGraph>;
@@ -244,6 +822,27 @@ namespace exotic_hashing {
       typename decltype(bit_vec)::rank_1_type bit_vec_rank;
       sdsl::int_vector<> vertex_values;
 
+      /**
+       * shared by CompactedMWHC and View, i.e., occupancy is either an sdsl
+       * bitvector with separate rank support or a mapped support::Bitvector
+       */
+      template<class Occupancy, class Rank, class Values>
+      static forceinline size_t resolve(const Occupancy& occupancy, const Rank& rank, const Values& vertex_values,
+                                        const hashing::reduction::FastModulo<std::uint64_t>& mod_N,
+                                        const std::tuple<size_t, size_t, size_t>& hs) {
+         const auto [h0, h1, h2] = hs;
+
+         // 0 and mod_N.N (i.e. unset values) are compressed by a 0 bit in occupancy
+         const auto v0 = occupancy[h0] * vertex_values[rank(h0)];
+         const auto v1 = occupancy[h1] * vertex_values[rank(h1)];
+         const auto v2 = occupancy[h2] * vertex_values[rank(h2)];
+
+         size_t hash = v0;
+         hash += (h1 != h0) * v1;
+         hash += (h2 != h1 && h2 != h0) * v2;
+         return mod_N(hash);
+      }
+
      public:
       CompactedMWHC() noexcept {};
 
@@ -308,17 +907,36 @@ namespace exotic_hashing {
       }
 
       forceinline size_t operator()(const Data& key) const {
-         const auto [h0, h1, h2] = hasher(key);
-
-         // 0 and mod_N.N (i.e. unset values) are compressed by a 0 bit in bit_vec
-         const auto v0 = bit_vec[h0] * vertex_values[bit_vec_rank(h0)];
-         const auto v1 = bit_vec[h1] * vertex_values[bit_vec_rank(h1)];
-         const auto v2 = bit_vec[h2] * vertex_values[bit_vec_rank(h2)];
+         return resolve(bit_vec, bit_vec_rank, vertex_values, mod_N, hasher(key));
+      }
 
-         size_t hash = v0;
-         hash += (h1 != h0) * v1;
-         hash += (h2 != h1 && h2 != h0) * v2;
-         return mod_N(hash);
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). Vertex
+       * values of upcoming keys are prefetched while the current window is
+       * resolved (see support::lookup_batch)
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         // unset vertices point to the trailing vertex value, which is either 0 or N, i.e., 0 mod N
+         const size_t unset = vertex_values.size() - 1;
+         const auto position = [&](const size_t h) { return bit_vec[h] ? bit_vec_rank(h) : unset; };
+
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const auto [h0, h1, h2] = hasher(key);
+               const std::array<size_t, 4> probe{position(h0), position(h1), position(h2),
+                                                 static_cast<size_t>(h1 != h0) | ((h2 != h1 && h2 != h0) << 1)};
+               support::prefetch_element(vertex_values, probe[0]);
+               support::prefetch_element(vertex_values, probe[1]);
+               support::prefetch_element(vertex_values, probe[2]);
+               return probe;
+            },
+            [&](const std::array<size_t, 4>& probe) {
+               size_t hash = vertex_values[probe[0]];
+               hash += (probe[3] & 0x1) * vertex_values[probe[1]];
+               hash += (probe[3] >> 1) * vertex_values[probe[2]];
+               return mod_N(hash);
+            });
       }
 
       static std::string name() {
@@ -329,6 +947,160 @@ namespace exotic_hashing {
          return sizeof(hasher) + sizeof(mod_N) + sdsl::size_in_bytes(bit_vec) + sdsl::size_in_bytes(bit_vec_rank) +
             sdsl::size_in_bytes(vertex_values);
       }
+
+      /**
+       * Writes this function to path, see support::Serializer. Load via View.
+       * Occupancy bits are stored as a support::Bitvector including its rank
+       * directory, i.e., are not compressed by sdsl's interleaved layout
+       */
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<CompactedMWHC>());
+         out.write(static_cast<std::uint64_t>(mod_N.N));
+         hasher.serialize(out);
+
+         support::Bitvector<> occupancy(bit_vec.size(), [&](const size_t& i) { return bit_vec[i]; });
+         occupancy.init_rank_select();
+         occupancy.serialize(out);
+
+         out.write_packed(vertex_values, vertex_values.width());
+         out.finish();
+      }
+
+      /// Read-only CompactedMWHC operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         hashing::reduction::FastModulo<std::uint64_t> mod_N{1};
+         Hasher hasher;
+         support::Bitvector<std::uint64_t, support::MappedArray> occupancy;
+         support::PackedView vertex_values;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<CompactedMWHC>());
+            mod_N = decltype(mod_N)(in.read<std::uint64_t>());
+            hasher.deserialize(in);
+            occupancy.deserialize(in);
+            vertex_values = in.read_packed();
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return resolve(
+               occupancy, [&](const size_t i) { return occupancy.rank(i); }, vertex_values, mod_N, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + occupancy.byte_size() - sizeof(occupancy) + vertex_values.byte_size();
+         }
+      };
+   };
+
+   /**
+    * CompactedMWHC whose vertex values are stored in a
+    * support::InterleavedCompactedVector, i.e., resolving a vertex touches a
+    * single cache line containing its occupancy bit, rank information and
+    * value. Considerably faster than CompactedMWHC, especially batched, at
+    * the cost of about two additional bits per vertex
+    */
+   template<class Data, class Hasher = support::Hasher<Data>, class HyperGraph = support::HyperGraph<Data, Hasher>>
+   class InterleavedCompactedMWHC {
+      using _MWHC = MWHC<Data, Hasher, HyperGraph>;
+      Hasher hasher;
+      hashing::reduction::FastModulo<std::uint64_t> mod_N{1};
+
+      support::InterleavedCompactedVector<> vertex_values;
+
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         return _MWHC::resolve(vertex_values, mod_N, hs);
+      }
+
+     public:
+      InterleavedCompactedMWHC() noexcept {};
+
+      template<class RandomIt>
+      InterleavedCompactedMWHC(const RandomIt& begin, const RandomIt& end) {
+         construct(begin, end);
+      }
+
+      explicit InterleavedCompactedMWHC(const std::vector<Data>& dataset)
+         : InterleavedCompactedMWHC(dataset.begin(), dataset.end()) {}
+
+      template<class RandomIt>
+      void construct(const RandomIt& begin, const RandomIt& end) {
+         const _MWHC mwhc(begin, end);
+
+         // copy unchanged fields
+         hasher = mwhc.hasher;
+         mod_N = mwhc.mod_N;
+
+         // unset values (0 and N, i.e., 0 mod N) are compressed to a single 0 bit
+         std::vector<size_t> values(mwhc.vertex_values.size());
+         for (size_t i = 0; i < values.size(); i++)
+            values[i] = mwhc.vertex_values[i] == mod_N.N ? 0 : mwhc.vertex_values[i];
+         vertex_values = decltype(vertex_values)(values);
+      }
+
+      forceinline size_t operator()(const Data& key) const {
+         return resolve(hasher(key));
+      }
+
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). Vertex
+       * blocks of upcoming keys are prefetched while the current window is
+       * resolved (see support::lookup_batch)
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const auto hs = hasher(key);
+               vertex_values.prefetch(std::get<0>(hs));
+               vertex_values.prefetch(std::get<1>(hs));
+               vertex_values.prefetch(std::get<2>(hs));
+               return hs;
+            },
+            [&](const auto& hs) { return resolve(hs); });
+      }
+
+      static std::string name() {
+         return "InterleavedCompactedMWHC";
+      }
+
+      size_t byte_size() const {
+         return sizeof(hasher) + sizeof(mod_N) + vertex_values.byte_size();
+      }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<InterleavedCompactedMWHC>());
+         out.write(static_cast<std::uint64_t>(mod_N.N));
+         hasher.serialize(out);
+         vertex_values.serialize(out);
+         out.finish();
+      }
+
+      /// Read-only InterleavedCompactedMWHC operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         hashing::reduction::FastModulo<std::uint64_t> mod_N{1};
+         Hasher hasher;
+         support::InterleavedCompactedVector<support::MappedArray> vertex_values;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<InterleavedCompactedMWHC>());
+            mod_N = decltype(mod_N)(in.read<std::uint64_t>());
+            hasher.deserialize(in);
+            vertex_values.deserialize(in);
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return _MWHC::resolve(vertex_values, mod_N, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + vertex_values.byte_size() - sizeof(vertex_values);
+         }
+      };
    };
 
    template<class Data, class Hasher = support::Hasher<Data>, class HyperGraph = support::HyperGraph<Data, Hasher>>
@@ -339,6 +1111,10 @@ namespace exotic_hashing {
       hashing::reduction::FastModulo<std::uint64_t> mod_N{1};
       sdsl::int_vector<> vertex_values;
 
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         return _MWHC::resolve(vertex_values, mod_N, hs);
+      }
+
      public:
       CompressedMWHC() noexcept {};
 
@@ -378,11 +1154,25 @@ namespace exotic_hashing {
       }
 
       forceinline size_t operator()(const Data& key) const {
-         const auto [h0, h1, h2] = hasher(key);
-         size_t hash = vertex_values[h0];
-         hash += (h1 != h0) * vertex_values[h1];
-         hash += (h2 != h1 && h2 != h0) * vertex_values[h2];
-         return mod_N(hash);
+         return resolve(hasher(key));
+      }
+
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). Vertex
+       * values of upcoming keys are prefetched while the current window is
+       * resolved (see support::lookup_batch)
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const auto hs = hasher(key);
+               support::prefetch_element(vertex_values, std::get<0>(hs));
+               support::prefetch_element(vertex_values, std::get<1>(hs));
+               support::prefetch_element(vertex_values, std::get<2>(hs));
+               return hs;
+            },
+            [&](const auto& hs) { return resolve(hs); });
       }
 
       static std::string name() {
@@ -392,6 +1182,173 @@ namespace exotic_hashing {
       size_t byte_size() const {
          return sizeof(hasher) + sizeof(mod_N) + sdsl::size_in_bytes(vertex_values);
       }
+
+      /// Writes this function's sections, e.g., as part of an enclosing structure. See save()
+      void serialize(support::Serializer& out) const {
+         out.write(static_cast<std::uint64_t>(mod_N.N));
+         hasher.serialize(out);
+         out.write_packed(vertex_values, vertex_values.width());
+      }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<CompressedMWHC>());
+         serialize(out);
+         out.finish();
+      }
+
+      /// Read-only CompressedMWHC operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         hashing::reduction::FastModulo<std::uint64_t> mod_N{1};
+         Hasher hasher;
+         support::PackedView vertex_values;
+
+        public:
+         View() = default;
+
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<CompressedMWHC>());
+            deserialize(in);
+         }
+
+         /// Reads sections written by serialize(). They remain owned by in's file
+         void deserialize(support::Deserializer& in) {
+            mod_N = decltype(mod_N)(in.read<std::uint64_t>());
+            hasher.deserialize(in);
+            vertex_values = in.read_packed();
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return _MWHC::resolve(vertex_values, mod_N, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + vertex_values.byte_size();
+         }
+      };
+   };
+
+   /**
+    * MWHC storing vertex values in a FixedWidthVector, i.e., each vertex
+    * value occupies exactly Bits bits and is extracted with a single load,
+    * shift & mask. Bits must be chosen at compile time such that all vertex
+    * values (< N, i.e., ~1.23n for the default Hasher) fit, for example as
+    * std::bit_width(N - 1) of the largest expected keyset.
+    *
+    * lookup_batch() resolves eight keys at a time with AVX2 gathers and
+    * branch free collision handling if available.
+    */
+   template<class Data, size_t Bits, class Hasher = support::Hasher<Data>,
+            class HyperGraph = support::HyperGraph<Data, Hasher>>
+   class FixedWidthMWHC {
+      using _MWHC = MWHC<Data, Hasher, HyperGraph>;
+
+      Hasher hasher;
+      hashing::reduction::FastModulo<std::uint64_t> mod_N{1};
+      support::FixedWidthVector<Bits> vertex_values;
+
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         return _MWHC::resolve(vertex_values, mod_N, hs);
+      }
+
+     public:
+      FixedWidthMWHC() noexcept {};
+
+      template<class RandomIt>
+      FixedWidthMWHC(const RandomIt& begin, const RandomIt& end) {
+         construct(begin, end);
+      }
+
+      explicit FixedWidthMWHC(const std::vector<Data>& dataset) : FixedWidthMWHC(dataset.begin(), dataset.end()) {}
+
+      template<class RandomIt>
+      void construct(const RandomIt& begin, const RandomIt& end) {
+         const auto N = _MWHC::vertices_count(std::distance(begin, end));
+         if (N > 0 && N - 1 > decltype(vertex_values)::max_value)
+            throw std::runtime_error("Failed to construct FixedWidthMWHC: " + std::to_string(N) +
+                                     " vertices exceed " + std::to_string(Bits) + " bit vertex values");
+
+         // generate mwhc
+         const _MWHC mwhc(begin, end);
+
+         // copy unchanged fields
+         hasher = mwhc.hasher;
+         mod_N = mwhc.mod_N;
+
+         // copy vertex values. Unset values (0 and N) are stored as 0
+         vertex_values = decltype(vertex_values)(mwhc.vertex_values.size());
+         for (size_t i = 0; i < mwhc.vertex_values.size(); i++) {
+            const auto val = mwhc.vertex_values[i];
+            if (val != 0 && val != mod_N.N)
+               vertex_values.set(i, val);
+         }
+      }
+
+      forceinline size_t operator()(const Data& key) const {
+         return resolve(hasher(key));
+      }
+
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). With
+       * AVX2, blocks of eight keys are resolved via gathers, remaining keys
+       * (and all keys without AVX2) use the prefetching support::lookup_batch
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::gather_lookup_batch(
+            keys, n, out, hasher, vertex_values,
+            [&](const auto& v0, const auto& v1, const auto& v2) {
+               const auto N = _mm256_set1_epi64x(static_cast<long long>(mod_N.N));
+               const auto max_val = _mm256_set1_epi64x(static_cast<long long>(mod_N.N - 1));
+
+               // hash < 3N, i.e., two conditional subtractions compute hash mod N
+               auto hash = _mm256_add_epi64(_mm256_add_epi64(v0, v1), v2);
+               hash = _mm256_sub_epi64(hash, _mm256_and_si256(_mm256_cmpgt_epi64(hash, max_val), N));
+               return _mm256_sub_epi64(hash, _mm256_and_si256(_mm256_cmpgt_epi64(hash, max_val), N));
+            },
+            [&](const auto& hs) { return resolve(hs); });
+      }
+
+      static std::string name() {
+         return "FixedWidthMWHC<" + std::to_string(Bits) + ">";
+      }
+
+      size_t byte_size() const {
+         return sizeof(hasher) + sizeof(mod_N) + vertex_values.byte_size();
+      }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<FixedWidthMWHC>());
+         out.write(static_cast<std::uint64_t>(mod_N.N));
+         hasher.serialize(out);
+         vertex_values.serialize(out);
+         out.finish();
+      }
+
+      /// Read-only FixedWidthMWHC operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         hashing::reduction::FastModulo<std::uint64_t> mod_N{1};
+         Hasher hasher;
+         support::FixedWidthVector<Bits, support::MappedArray> vertex_values;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<FixedWidthMWHC>());
+            mod_N = decltype(mod_N)(in.read<std::uint64_t>());
+            hasher.deserialize(in);
+            vertex_values.deserialize(in);
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return _MWHC::resolve(vertex_values, mod_N, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + vertex_values.byte_size() - sizeof(vertex_values);
+         }
+      };
    };
 
    template<class Data, class Hasher, class HyperGraph>
@@ -401,12 +1358,34 @@ namespace exotic_hashing {
 
       std::vector<size_t> vertex_values;
 
+      /// shared by MWHC and View, i.e., Values is either an std::vector or a mapped std::span
+      template<class Values>
+      static forceinline size_t resolve(const Values& vertex_values,
+                                        const hashing::reduction::FastModulo<std::uint64_t>& mod_N,
+                                        const std::tuple<size_t, size_t, size_t>& hs) {
+         const auto [h0, h1, h2] = hs;
+         size_t hash = vertex_values[h0];
+         hash += (h1 != h0) * vertex_values[h1];
+         hash += (h2 != h1 && h2 != h0) * vertex_values[h2];
+         return mod_N(hash);
+      }
+
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         return resolve(vertex_values, mod_N, hs);
+      }
+
       static forceinline size_t vertices_count(const size_t& dataset_size, const long double& overalloc = 1.23) {
+         if constexpr (support::ProvidesVertexCount<Hasher>)
+            return Hasher::vertices_count(dataset_size);
          return std::ceil(overalloc * dataset_size);
       }
 
       friend CompressedMWHC<Data, Hasher, HyperGraph>;
       friend CompactedMWHC<Data, Hasher, HyperGraph>;
+      friend InterleavedCompactedMWHC<Data, Hasher, HyperGraph>;
+
+      template<class, size_t, class, class>
+      friend class FixedWidthMWHC;
 
      public:
       MWHC() noexcept {};
@@ -424,23 +1403,51 @@ namespace exotic_hashing {
          hasher = decltype(hasher)(mod_N.N);
          vertex_values = decltype(vertex_values)(mod_N.N, mod_N.N);
 
+         std::optional<HyperGraph> g;
          std::vector<size_t> peel_order;
          while (peel_order.empty()) {
             // 1. Generate random Hypergraph
             hasher = Hasher(mod_N.N);
-            HyperGraph g(begin, end, hasher, mod_N.N);
+            g.emplace(begin, end, hasher, mod_N.N);
 
             // 2. Peel (i.e., check for acyclicity)
-            peel_order = g.peel();
+            peel_order = g->peel();
          }
 
          // 3. Assign values to vertices depending on reverse peel order
+         if constexpr (support::RoundPeeling<HyperGraph>) {
+            // rounds are independent of each other, i.e., each edge only
+            // ever has to assign its hinge vertex (see HyperGraph::rounds())
+            const auto& rounds = g->rounds();
+            const auto& hinges = g->hinges();
+            for (size_t r = rounds.size() - 1; r > 0; r--)
+               support::parallel_for(rounds[r - 1], rounds[r], HyperGraph::thread_count(),
+                                     [&](const size_t from, const size_t to, const size_t) {
+                                        for (size_t i = from; i < to; i++) {
+                                           const auto edge_ind = peel_order[i];
+                                           const auto [h0, h1, h2] = g->vertices_of(edge_ind);
+                                           const std::array<size_t, 3> hs{h0, h1, h2};
+
+                                           // unset vertices (== mod_N.N) contribute 0
+                                           size_t current_val = vertex_values[h0];
+                                           if (h1 != h0)
+                                              current_val += vertex_values[h1];
+                                           if (h2 != h0 && h2 != h1)
+                                              current_val += vertex_values[h2];
+                                           current_val = mod_N(current_val);
+
+                                           vertex_values[hs[hinges[i]]] = mod_N(mod_N.N + edge_ind - current_val);
+                                        }
+                                     });
+            return;
+         }
+
          for (auto it = peel_order.rbegin(); it != peel_order.rend(); it++) {
             // get next edge
             const auto edge_ind = *it;
 
             // lookup vertices of this edge
-            const auto [h0, h1, h2] = hasher(*(begin + edge_ind));
+            const auto [h0, h1, h2] = g->vertices_of(edge_ind);
 
             // compute vertex assign value. Handle the case that there are collisions, i.e. same h value twice
             size_t current_val = vertex_values[h0];
@@ -471,11 +1478,25 @@ namespace exotic_hashing {
       }
 
       forceinline size_t operator()(const Data& key) const {
-         const auto [h0, h1, h2] = hasher(key);
-         size_t hash = vertex_values[h0];
-         hash += (h1 != h0) * vertex_values[h1];
-         hash += (h2 != h1 && h2 != h0) * vertex_values[h2];
-         return mod_N(hash);
+         return resolve(hasher(key));
+      }
+
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). Vertex
+       * values of upcoming keys are prefetched while the current window is
+       * resolved (see support::lookup_batch)
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const auto hs = hasher(key);
+               support::prefetch_element(vertex_values, std::get<0>(hs));
+               support::prefetch_element(vertex_values, std::get<1>(hs));
+               support::prefetch_element(vertex_values, std::get<2>(hs));
+               return hs;
+            },
+            [&](const auto& hs) { return resolve(hs); });
       }
 
       static std::string name() {
@@ -486,5 +1507,41 @@ namespace exotic_hashing {
          return sizeof(hasher) + sizeof(mod_N) + sizeof(decltype(vertex_values)) +
             sizeof(size_t) * vertex_values.size();
       }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<MWHC>());
+         out.write(static_cast<std::uint64_t>(mod_N.N));
+         hasher.serialize(out);
+         out.write_array(vertex_values.data(), vertex_values.size());
+         out.finish();
+      }
+
+      /**
+       * Read-only MWHC operating directly on a memory mapped file written by
+       * save(), i.e., opening a View is independent of the dataset's size
+       */
+      class View {
+         support::MappedFile file;
+         hashing::reduction::FastModulo<std::uint64_t> mod_N{1};
+         Hasher hasher;
+         std::span<const size_t> vertex_values;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<MWHC>());
+            mod_N = decltype(mod_N)(in.read<std::uint64_t>());
+            hasher.deserialize(in);
+            vertex_values = in.read_array<size_t>();
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return resolve(vertex_values, mod_N, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + sizeof(size_t) * vertex_values.size();
+         }
+      };
    };
 } // namespace exotic_hashing
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "../sf/sf_mwhc.hpp"
+#include "../support/serialization.hpp"
+
+// Order important
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing {
+   /**
+    * Sharded, order preserving MWHC built on top of PartitionedSFMWHC.
+    * Instead of assigning vertex values modulo each shard's vertex count,
+    * every key stores its global index as payload. Vertex values therefore
+    * require ceil(log2(n)) bits each, i.e., space matches CompressedMWHC,
+    * while construction is entirely shard local (see PartitionedSFMWHC).
+    *
+    * @tparam ShardSize expected amount of keys per shard
+    * @tparam ThreadCount amount of threads used to build shards. 0 means 'all hardware threads'
+    */
+   template<class Data, size_t ShardSize = 2048, class Hasher = support::Hasher<Data>,
+            class HyperGraph = support::HyperGraph<Data, Hasher>, size_t ThreadCount = 0>
+   class PartitionedMWHC {
+      using SF = PartitionedSFMWHC<Data, std::uint64_t, ShardSize, Hasher, HyperGraph, ThreadCount>;
+      SF sf;
+
+     public:
+      PartitionedMWHC() noexcept {};
+
+      template<class RandomIt>
+      PartitionedMWHC(const RandomIt& begin, const RandomIt& end) {
+         construct(begin, end);
+      }
+
+      explicit PartitionedMWHC(const std::vector<Data>& dataset) : PartitionedMWHC(dataset.begin(), dataset.end()) {}
+
+      template<class RandomIt>
+      void construct(const RandomIt& begin, const RandomIt& end) {
+         // i-th key maps to i
+         sf.construct(begin, end, std::views::iota(static_cast<std::uint64_t>(0)).begin());
+      }
+
+      static std::string name() {
+         return "PartitionedMWHC<" + std::to_string(ShardSize) + ">";
+      }
+
+      forceinline size_t operator()(const Data& key) const {
+         return sf(key);
+      }
+
+      /// Looks up n keys at once, i.e., out[i] = operator()(keys[i]) (see PartitionedSFMWHC::lookup_batch)
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         sf.lookup_batch(keys, n, out);
+      }
+
+      size_t byte_size() const {
+         return sf.byte_size();
+      }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<PartitionedMWHC>());
+         sf.serialize(out);
+         out.finish();
+      }
+
+      /// Read-only PartitionedMWHC operating on a memory mapped file written by save(), see PartitionedSFMWHC::View
+      class View {
+         support::MappedFile file;
+         typename SF::View sf;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<PartitionedMWHC>());
+            sf.deserialize(in);
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return sf(key);
+         }
+
+         size_t byte_size() const {
+            return sizeof(file) + sf.byte_size();
+         }
+      };
+   };
+} // namespace exotic_hashing
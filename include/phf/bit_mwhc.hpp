@@ -5,6 +5,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <queue>
 #include <random>
 #include <sdsl/bit_vector_il.hpp>
@@ -22,11 +23,17 @@
 #include <hashing.hpp>
 
 #include "include/omphf/mwhc.hpp"
+#include "include/support/batch.hpp"
+#include "include/support/bitvector.hpp"
+#include "include/support/serialization.hpp"
 
 // order is important
 #include "../convenience/builtins.hpp"
 
 namespace exotic_hashing {
+   template<class Data, class Hasher = support::Hasher<Data>, class HyperGraph = support::HyperGraph<Data, Hasher>>
+   class MinimalBitMWHC;
+
    template<class Data, class Hasher = support::Hasher<Data>, class HyperGraph = support::HyperGraph<Data, Hasher>>
    class BitMWHC {
       hashing::reduction::FastModulo<std::uint64_t> mod_N{1};
@@ -34,7 +41,27 @@ namespace exotic_hashing {
 
       sdsl::int_vector<2> vertex_values;
 
+      /// shared by BitMWHC and View, i.e., Values is either an sdsl::int_vector<2> or a mapped support::PackedView
+      template<class Values>
+      static forceinline size_t resolve(const Values& vertex_values, const std::tuple<size_t, size_t, size_t>& hs) {
+         const auto [h0, h1, h2] = hs;
+         size_t hash = vertex_values[h0];
+         if (h1 != h0)
+            hash += vertex_values[h1];
+         if (h2 != h1 && h2 != h0)
+            hash += vertex_values[h2];
+
+         const std::array<size_t, 3> hashs{h0, h1, h2};
+         return hashs[hash % 3];
+      }
+
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         return resolve(vertex_values, hs);
+      }
+
       static forceinline size_t vertices_count(const size_t& dataset_size, const long double& overalloc = 1.23) {
+         if constexpr (support::ProvidesVertexCount<Hasher>)
+            return Hasher::vertices_count(dataset_size);
          return std::ceil(overalloc * dataset_size);
       }
 
@@ -56,42 +83,73 @@ namespace exotic_hashing {
          vertex_values = decltype(vertex_values)(n, 3);
 
          // Find suitable peel order
+         std::optional<HyperGraph> g;
          std::vector<size_t> peel_order;
          while (peel_order.empty()) {
             // 1. Generate random Hypergraph
             hasher = Hasher(mod_N.N);
-            HyperGraph g(begin, end, hasher, mod_N.N);
+            g.emplace(begin, end, hasher, mod_N.N);
 
             // 2. Peel (i.e., check for acyclicity)
-            peel_order = g.peel();
+            peel_order = g->peel();
          }
 
          // 3. Assign values to vertices depending on reverse peel order
+         if constexpr (support::RoundPeeling<HyperGraph>) {
+            // concurrent writes to a packed int_vector<2> would race,
+            // therefore assign into a byte per vertex and pack afterwards
+            std::vector<std::uint8_t> values(n, 3);
+
+            // rounds are independent of each other, i.e., each edge only
+            // ever has to assign its hinge vertex (see HyperGraph::rounds())
+            const auto& rounds = g->rounds();
+            const auto& hinges = g->hinges();
+            for (size_t r = rounds.size() - 1; r > 0; r--)
+               support::parallel_for(rounds[r - 1], rounds[r], HyperGraph::thread_count(),
+                                     [&](const size_t from, const size_t to, const size_t) {
+                                        for (size_t i = from; i < to; i++) {
+                                           const auto [h0, h1, h2] = g->vertices_of(peel_order[i]);
+                                           const std::array<size_t, 3> hs{h0, h1, h2};
+
+                                           // unset vertices (== 3) contribute 0
+                                           const size_t curr_value = (values[h0] + (h1 != h0) * values[h1] +
+                                                                      (h2 != h1 && h2 != h0) * values[h2]) %
+                                              3;
+                                           values[hs[hinges[i]]] = (3 + hinges[i] - curr_value) % 3;
+                                        }
+                                     });
+
+            for (size_t i = 0; i < n; i++)
+               vertex_values[i] = values[i];
+            return;
+         }
+
+         // non hinge vertices retain 3 (i.e., 0 mod 3), s.t. exactly the
+         // hinge vertices are assigned (see MinimalBitMWHC)
+         support::Bitvector<> settable(n, true);
          for (auto it = peel_order.rbegin(); it != peel_order.rend(); it++) {
             // get next edge
             const auto edge_ind = *it;
 
             // lookup vertices of this edge
-            const auto [h0, h1, h2] = hasher(*(begin + edge_ind));
+            const auto [h0, h1, h2] = g->vertices_of(edge_ind);
 
             // compute vertex assign value. Handle the case that there are collisions, i.e. same h value twice
             const size_t curr_value =
                (vertex_values[h0] + (h1 != h0) * vertex_values[h1] + (h2 != h1 && h2 != h0) * vertex_values[h2]) % 3;
 
-            // assign vertex values
+            // assign hinge (i.e., first settable) vertex value
+            const std::array<size_t, 3> hs{h0, h1, h2};
             bool assigned = false;
-            if (vertex_values[h0] == 3) {
-               vertex_values[h0] = (3 + 0 - curr_value) % 3;
-               assigned = true;
-            }
+            for (size_t j = 0; j < hs.size(); j++) {
+               if (!settable[hs[j]])
+                  continue;
 
-            if (vertex_values[h1] == 3) {
-               vertex_values[h1] = assigned ? 0 : (3 + 1 - curr_value) % 3;
+               settable[hs[j]] = false;
+               if (!assigned)
+                  vertex_values[hs[j]] = (3 + j - curr_value) % 3;
                assigned = true;
             }
-
-            if (vertex_values[h2] == 3)
-               vertex_values[h2] = assigned ? 0 : (3 + 2 - curr_value) % 3;
          }
       }
 
@@ -100,19 +158,61 @@ namespace exotic_hashing {
       }
 
       forceinline size_t operator()(const Data& key) const {
-         const auto [h0, h1, h2] = hasher(key);
-         size_t hash = vertex_values[h0];
-         if (h1 != h0)
-            hash += vertex_values[h1];
-         if (h2 != h1 && h2 != h0)
-            hash += vertex_values[h2];
+         return resolve(hasher(key));
+      }
 
-         const std::array<size_t, 3> hashs{h0, h1, h2};
-         return hashs[hash % 3];
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). Vertex
+       * values of upcoming keys are prefetched while the current window is
+       * resolved (see support::lookup_batch)
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const auto hs = hasher(key);
+               support::prefetch_element(vertex_values, std::get<0>(hs));
+               support::prefetch_element(vertex_values, std::get<1>(hs));
+               support::prefetch_element(vertex_values, std::get<2>(hs));
+               return hs;
+            },
+            [&](const auto& hs) { return resolve(hs); });
       }
 
       size_t byte_size() const {
          return sizeof(hasher) + sizeof(mod_N) + sdsl::size_in_bytes(vertex_values);
       }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<BitMWHC>());
+         hasher.serialize(out);
+         out.write_packed(vertex_values, 2);
+         out.finish();
+      }
+
+      /// Read-only BitMWHC operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         Hasher hasher;
+         support::PackedView vertex_values;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<BitMWHC>());
+            hasher.deserialize(in);
+            vertex_values = in.read_packed();
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return resolve(vertex_values, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + vertex_values.byte_size();
+         }
+      };
+
+      friend MinimalBitMWHC<Data, Hasher, HyperGraph>;
    };
 } // namespace exotic_hashing
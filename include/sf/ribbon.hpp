@@ -0,0 +1,344 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ratio>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <emmintrin.h>
+
+#include <hashing.hpp>
+
+#include "include/omphf/mwhc.hpp"
+#include "include/support/batch.hpp"
+#include "include/support/parallel.hpp"
+#include "include/support/serialization.hpp"
+
+// order is important
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing {
+   /**
+    * Static function based on standard ribbon retrieval, see Dillinger &
+    * Walzer, "Ribbon filter: practically smaller than Bloom and Xor" (2021).
+    *
+    * Each key contributes one equation to a banded linear system over GF(2):
+    * 64 consecutive coefficients starting at a hashed slot, whose solution's
+    * dot product with the coefficients yields the key's payload. The system
+    * is solved by on-the-fly gaussian elimination and back substitution into
+    * an interleaved (block-wise column major) layout, i.e., a lookup is one
+    * popcount per payload bit on two consecutive 64-bit words.
+    *
+    * Keys are routed to independent shards of ~ShardSize keys whose banding
+    * storage stays cache resident. Shards are solved in parallel and only
+    * failing shards retry (with a new seed and slightly more slots). Space is
+    * (1 + Overhead) * r bits per key for r bit payloads (+ 64 slots per shard).
+    *
+    * @tparam Overhead relative amount of additional slots, e.g., 5%
+    * @tparam ShardSize expected amount of keys per shard
+    * @tparam ThreadCount amount of threads used to solve shards. 0 means 'all hardware threads'
+    */
+   template<class Data, class Payload = std::uint64_t, class Overhead = std::ratio<5, 100>,
+            size_t ShardSize = (1 << 15), size_t ThreadCount = 0>
+   class RibbonSF {
+      static_assert(ShardSize > 0);
+      static constexpr size_t width = 64;
+      static constexpr size_t max_attempts = 64;
+
+      hashing::AquaHash<Data> hashfn;
+      __m128i seed = _mm_setzero_si128();
+      size_t result_bits = 1;
+
+      std::vector<std::uint64_t> shard_seeds;
+      /// shard s occupies blocks [block_offsets[s], block_offsets[s+1]), each block are 64 slots
+      std::vector<std::uint64_t> block_offsets;
+      /// result_bits words per block, word k containing bit k of each slot's solution
+      std::vector<std::uint64_t> solution;
+
+      static forceinline std::uint64_t mix(std::uint64_t x) {
+         x ^= x >> 33;
+         x *= 0xff51afd7ed558ccdLLU;
+         x ^= x >> 33;
+         x *= 0xc4ceb9fe1a85ec53LLU;
+         x ^= x >> 33;
+         return x;
+      }
+
+      static forceinline size_t reduce(const std::uint64_t x, const size_t n) {
+         return (static_cast<__uint128_t>(x) * n) >> 64;
+      }
+
+      /// start slot & (normalized) coefficients of an equation in a shard of the given amount of slots
+      static forceinline std::pair<size_t, std::uint64_t> equation(const std::uint64_t h, const std::uint64_t shard_seed,
+                                                                   const size_t slots) {
+         const auto local = mix(h ^ shard_seed);
+         return {reduce(local, slots - width + 1), mix(local + 0x9E3779B97F4A7C15LLU) | 0x1};
+      }
+
+      static size_t slots_count(const size_t& shard_size, const size_t& attempt) {
+         // grow by an additional 1% every 4 failed attempts
+         const long double overhead =
+            static_cast<long double>(Overhead::num) / Overhead::den + 0.01L * static_cast<long double>(attempt / 4);
+         const auto slots = static_cast<size_t>(std::ceil((1.L + overhead) * shard_size));
+         return ((slots + width - 1) / width + 1) * width;
+      }
+
+      /**
+       * Solves a shard's system, i.e., bands all equations and back
+       * substitutes into blocks. Returns false iff banding failed
+       */
+      bool solve_shard(const std::vector<std::uint64_t>& hashes, const std::vector<std::uint64_t>& payloads,
+                       const std::uint64_t shard_seed, const size_t slots, std::vector<std::uint64_t>& coeff_rows,
+                       std::vector<std::uint64_t>& result_rows, std::vector<std::uint64_t>& blocks) const {
+         coeff_rows.assign(slots, 0);
+         result_rows.assign(slots, 0);
+
+         // 1. On-the-fly gaussian elimination. Row i always has its leading coefficient at bit 0
+         for (size_t e = 0; e < hashes.size(); e++) {
+            auto [i, coeff] = equation(hashes[e], shard_seed, slots);
+            auto result = payloads[e];
+            while (true) {
+               if (coeff_rows[i] == 0) {
+                  coeff_rows[i] = coeff;
+                  result_rows[i] = result;
+                  break;
+               }
+
+               coeff ^= coeff_rows[i];
+               result ^= result_rows[i];
+               if (coeff == 0) {
+                  // linearly dependent equation, i.e., consistent iff results match
+                  if (result != 0)
+                     return false;
+                  break;
+               }
+
+               const auto shift = support::ctz(coeff);
+               i += shift;
+               coeff >>= shift;
+            }
+         }
+
+         // 2. Back substitution, state[k] bit j holding bit k of slot i + j's solution
+         const size_t block_cnt = slots / width;
+         blocks.assign(block_cnt * result_bits, 0);
+         std::vector<std::uint64_t> state(result_bits, 0);
+         for (size_t b = block_cnt; b-- > 0;) {
+            for (size_t i = (b + 1) * width; i-- > b * width;) {
+               const auto coeff = coeff_rows[i];
+               const auto result = result_rows[i];
+               for (size_t k = 0; k < result_bits; k++) {
+                  const auto tmp = state[k] << 1;
+                  state[k] = tmp | ((__builtin_popcountll(tmp & coeff) ^ (result >> k)) & 0x1);
+               }
+            }
+            std::copy(state.begin(), state.end(), blocks.begin() + b * result_bits);
+         }
+
+         return true;
+      }
+
+      /// shared by RibbonSF and View, i.e., arguments either refer to std::vectors or to a mapped file
+      static forceinline size_t resolve(const std::span<const std::uint64_t> shard_seeds,
+                                        const std::span<const std::uint64_t> block_offsets,
+                                        const std::span<const std::uint64_t> solution, const size_t result_bits,
+                                        const std::uint64_t h) {
+         const auto shard = reduce(h, shard_seeds.size());
+         const auto block_begin = block_offsets[shard];
+         const auto [start, coeff] =
+            equation(h, shard_seeds[shard], (block_offsets[shard + 1] - block_begin) * width);
+
+         const auto* words = solution.data() + (block_begin + start / width) * result_bits;
+         const auto offset = start % width;
+
+         size_t res = 0;
+         for (size_t k = 0; k < result_bits; k++) {
+            // shifting twice avoids undefined behaviour for offset == 0. Last block is followed by padding
+            const auto segment = (words[k] >> offset) | ((words[result_bits + k] << (width - 1 - offset)) << 1);
+            res |= static_cast<size_t>(__builtin_popcountll(segment & coeff) & 0x1) << k;
+         }
+         return res;
+      }
+
+      forceinline size_t resolve(const std::uint64_t h) const {
+         return resolve(shard_seeds, block_offsets, solution, result_bits, h);
+      }
+
+     public:
+      RibbonSF() noexcept {};
+
+      template<class KeyIt, class PayloadIt>
+      RibbonSF(const KeyIt& keys_begin, const KeyIt& keys_end, const PayloadIt& payloads_begin) {
+         construct(keys_begin, keys_end, payloads_begin);
+      }
+
+      explicit RibbonSF(const std::vector<Data>& keys, const std::vector<Payload>& payloads)
+         : RibbonSF(keys.begin(), keys.end(), payloads.begin()) {
+         assert(keys.size() == payloads.size());
+      }
+
+      template<class KeyIt, class PayloadIt>
+      void construct(const KeyIt& keys_begin, const KeyIt& keys_end, const PayloadIt& payloads_begin) {
+         const size_t n = std::distance(keys_begin, keys_end);
+         const size_t shard_cnt = std::max((n + ShardSize - 1) / ShardSize, static_cast<size_t>(1));
+
+         std::random_device r;
+         std::default_random_engine rng(r());
+         std::uniform_int_distribution<std::uint64_t> dist;
+         seed = support::make_seed(dist(rng));
+
+         // result width is determined by the largest payload
+         std::uint64_t max_payload = 0;
+         for (size_t i = 0; i < n; i++)
+            max_payload = std::max(max_payload, static_cast<std::uint64_t>(*(payloads_begin + i)));
+         result_bits = std::max(static_cast<size_t>(64 - support::clz(max_payload | 0x1)), static_cast<size_t>(1));
+
+         // 1. Hash once & counting sort (hash, payload) pairs by shard
+         std::vector<std::uint64_t> hashes(n);
+         std::vector<size_t> shard_begin(shard_cnt + 1, 0);
+         for (size_t i = 0; i < n; i++) {
+            hashes[i] = hashfn(*(keys_begin + i), seed);
+            shard_begin[reduce(hashes[i], shard_cnt) + 1]++;
+         }
+         for (size_t s = 0; s < shard_cnt; s++)
+            shard_begin[s + 1] += shard_begin[s];
+
+         std::vector<std::uint64_t> sorted_hashes(n), sorted_payloads(n);
+         {
+            auto fill = shard_begin;
+            for (size_t i = 0; i < n; i++) {
+               const auto pos = fill[reduce(hashes[i], shard_cnt)]++;
+               sorted_hashes[pos] = hashes[i];
+               sorted_payloads[pos] = static_cast<std::uint64_t>(*(payloads_begin + i));
+            }
+         }
+         hashes.clear();
+         hashes.shrink_to_fit();
+
+         // 2. Solve shards independently
+         shard_seeds.assign(shard_cnt, 0);
+         std::vector<std::vector<std::uint64_t>> shard_blocks(shard_cnt);
+         std::vector<size_t> failed(shard_cnt, 0);
+         const auto base_seed = dist(rng);
+         support::parallel_for(
+            0, shard_cnt, support::resolve_thread_count(ThreadCount),
+            [&](const size_t from, const size_t to, const size_t) {
+               std::vector<std::uint64_t> hs, ps, coeff_rows, result_rows;
+               for (size_t s = from; s < to; s++) {
+                  hs.assign(sorted_hashes.begin() + shard_begin[s], sorted_hashes.begin() + shard_begin[s + 1]);
+                  ps.assign(sorted_payloads.begin() + shard_begin[s], sorted_payloads.begin() + shard_begin[s + 1]);
+
+                  size_t attempt = 0;
+                  while (true) {
+                     // deterministic per (shard, attempt) seeds, i.e., independent of thread scheduling
+                     const auto shard_seed = mix(base_seed + s * max_attempts + attempt);
+                     if (solve_shard(hs, ps, shard_seed, slots_count(hs.size(), attempt), coeff_rows, result_rows,
+                                     shard_blocks[s])) {
+                        shard_seeds[s] = shard_seed;
+                        break;
+                     }
+
+                     if (++attempt == max_attempts) {
+                        failed[s] = 1;
+                        break;
+                     }
+                  }
+               }
+            },
+            1);
+
+         if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+            throw std::runtime_error("Failed to construct RibbonSF: shard unsolvable after " +
+                                     std::to_string(max_attempts) + " attempts (duplicate keys?)");
+
+         // 3. Concatenate shard solutions. Trailing padding block allows
+         // branch free access to a start's successor block
+         block_offsets.assign(shard_cnt + 1, 0);
+         for (size_t s = 0; s < shard_cnt; s++)
+            block_offsets[s + 1] = block_offsets[s] + shard_blocks[s].size() / result_bits;
+
+         solution.assign((block_offsets[shard_cnt] + 1) * result_bits, 0);
+         for (size_t s = 0; s < shard_cnt; s++)
+            std::copy(shard_blocks[s].begin(), shard_blocks[s].end(),
+                      solution.begin() + block_offsets[s] * result_bits);
+      }
+
+      static std::string name() {
+         return "RibbonSF<" + std::to_string(Overhead::num) + "/" + std::to_string(Overhead::den) + ">";
+      }
+
+      forceinline size_t operator()(const Data& key) const {
+         return resolve(hashfn(key, seed));
+      }
+
+      /// Looks up n keys at once, i.e., out[i] = operator()(keys[i]) (see support::lookup_batch)
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const std::uint64_t h = hashfn(key, seed);
+               const auto shard = reduce(h, shard_seeds.size());
+               const auto [start, coeff] = equation(h, shard_seeds[shard],
+                                                    (block_offsets[shard + 1] - block_offsets[shard]) * width);
+               UNUSED(coeff);
+               support::prefetch_element(solution, (block_offsets[shard] + start / width) * result_bits);
+               return h;
+            },
+            [&](const std::uint64_t& h) { return resolve(h); });
+      }
+
+      size_t byte_size() const {
+         return sizeof(hashfn) + sizeof(seed) + sizeof(result_bits) +
+            sizeof(std::uint64_t) * (shard_seeds.size() + block_offsets.size() + solution.size());
+      }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<RibbonSF>());
+         out.write(seed);
+         out.write(static_cast<std::uint64_t>(result_bits));
+         out.write_array(shard_seeds.data(), shard_seeds.size());
+         out.write_array(block_offsets.data(), block_offsets.size());
+         out.write_array(solution.data(), solution.size());
+         out.finish();
+      }
+
+      /// Read-only RibbonSF operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         hashing::AquaHash<Data> hashfn;
+         __m128i seed = _mm_setzero_si128();
+         size_t result_bits = 1;
+         std::span<const std::uint64_t> shard_seeds, block_offsets, solution;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<RibbonSF>());
+            seed = in.read<__m128i>();
+            result_bits = in.read<std::uint64_t>();
+            shard_seeds = in.read_array<std::uint64_t>();
+            block_offsets = in.read_array<std::uint64_t>();
+            solution = in.read_array<std::uint64_t>();
+            if (block_offsets.size() != shard_seeds.size() + 1 ||
+                solution.size() != (block_offsets.back() + 1) * result_bits)
+               throw std::runtime_error("Failed to load " + name() + ": inconsistent shard layout");
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return resolve(shard_seeds, block_offsets, solution, result_bits, hashfn(key, seed));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) +
+               sizeof(std::uint64_t) * (shard_seeds.size() + block_offsets.size() + solution.size());
+         }
+      };
+   };
+} // namespace exotic_hashing
@@ -6,15 +6,19 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <optional>
 #include <queue>
 #include <random>
 #include <sdsl/bit_vector_il.hpp>
 #include <sdsl/io.hpp>
 #include <sdsl/rrr_vector.hpp>
 #include <sdsl/vectors.hpp>
+#include <span>
 #include <stack>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include <emmintrin.h>
@@ -23,7 +27,12 @@
 #include <hashing.hpp>
 
 #include "include/omphf/mwhc.hpp"
+#include "include/support/batch.hpp"
 #include "include/support/bitvector.hpp"
+#include "include/support/elias_fano_list.hpp"
+#include "include/support/fixed_width_vector.hpp"
+#include "include/support/parallel.hpp"
+#include "include/support/serialization.hpp"
 
 // order is important
 #include "../convenience/builtins.hpp"
@@ -33,6 +42,15 @@ namespace exotic_hashing {
             class HyperGraph = support::HyperGraph<Data, Hasher>>
    class CompressedSFMWHC;
 
+   template<class Data, class Payload = std::uint64_t, size_t ShardSize = 2048,
+            class Hasher = support::Hasher<Data>, class HyperGraph = support::HyperGraph<Data, Hasher>,
+            size_t ThreadCount = 0>
+   class PartitionedSFMWHC;
+
+   template<class Data, size_t Bits, class Payload = std::uint64_t, class Hasher = support::Hasher<Data>,
+            class HyperGraph = support::HyperGraph<Data, Hasher>>
+   class FixedWidthSFMWHC;
+
    template<class Data, class Payload = std::uint64_t, class Hasher = support::Hasher<Data>,
             class HyperGraph = support::HyperGraph<Data, Hasher>>
    class SFMWHC {
@@ -41,7 +59,25 @@ namespace exotic_hashing {
 
       std::vector<Payload> vertex_values;
 
+      /// shared by SFMWHC and View, i.e., Values is either an std::vector or a mapped std::span
+      template<class Values>
+      static forceinline size_t resolve(const Values& vertex_values, const std::tuple<size_t, size_t, size_t>& hs) {
+         const auto [h0, h1, h2] = hs;
+         size_t hash = vertex_values[h0];
+         if (likely(h1 != h0))
+            hash ^= vertex_values[h1];
+         if (likely(h2 != h1 && h2 != h0))
+            hash ^= vertex_values[h2];
+         return hash;
+      }
+
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         return resolve(vertex_values, hs);
+      }
+
       static forceinline size_t vertices_count(const size_t& dataset_size, const long double& overalloc = 1.23) {
+         if constexpr (support::ProvidesVertexCount<Hasher>)
+            return Hasher::vertices_count(dataset_size);
          return std::ceil(overalloc * dataset_size);
       }
 
@@ -64,18 +100,45 @@ namespace exotic_hashing {
          vertex_values = decltype(vertex_values)(n, 0);
 
          // Find suitable peel order
+         std::optional<HyperGraph> g;
          std::vector<size_t> peel_order;
          while (peel_order.empty()) {
             // 1. Generate random Hypergraph
             hasher = Hasher(mod_N.N);
-            HyperGraph g(keys_begin, keys_end, hasher, mod_N.N);
+            g.emplace(keys_begin, keys_end, hasher, mod_N.N);
 
             // 2. Peel (i.e., check for acyclicity)
-            peel_order = g.peel();
+            peel_order = g->peel();
          }
 
          // 3. Assign values to vertices depending on reverse peel order
          assert(peel_order.size() == static_cast<size_t>(std::distance(keys_begin, keys_end)));
+         if constexpr (support::RoundPeeling<HyperGraph>) {
+            // rounds are independent of each other, i.e., each edge only
+            // ever has to assign its hinge vertex (see HyperGraph::rounds())
+            const auto& rounds = g->rounds();
+            const auto& hinges = g->hinges();
+            for (size_t r = rounds.size() - 1; r > 0; r--)
+               support::parallel_for(rounds[r - 1], rounds[r], HyperGraph::thread_count(),
+                                     [&](const size_t from, const size_t to, const size_t) {
+                                        for (size_t i = from; i < to; i++) {
+                                           const auto edge_ind = peel_order[i];
+                                           const auto [h0, h1, h2] = g->vertices_of(edge_ind);
+                                           const std::array<size_t, 3> hs{h0, h1, h2};
+
+                                           // unset vertices are 0, i.e., don't contribute
+                                           Payload current_val = vertex_values[h0];
+                                           if (h1 != h0)
+                                              current_val ^= vertex_values[h1];
+                                           if (h2 != h0 && h2 != h1)
+                                              current_val ^= vertex_values[h2];
+
+                                           vertex_values[hs[hinges[i]]] = *(payloads_begin + edge_ind) ^ current_val;
+                                        }
+                                     });
+            return;
+         }
+
          support::Bitvector<> settable(mod_N.N, true);
          for (size_t i = peel_order.size() - 1; i >= 0 && i < peel_order.size(); i--) {
             // get next edge
@@ -86,7 +149,7 @@ namespace exotic_hashing {
             const auto payload = *(payloads_begin + edge_ind);
 
             // lookup vertices of this edge
-            const auto [h0, h1, h2] = hasher(key);
+            const auto [h0, h1, h2] = g->vertices_of(edge_ind);
             assert(settable[h0] || settable[h1] || settable[h2]);
 
             // compute vertex assign value. Handle the case that there are collisions, i.e. same h value twice
@@ -131,13 +194,25 @@ namespace exotic_hashing {
       }
 
       forceinline size_t operator()(const Data& key) const {
-         const auto [h0, h1, h2] = hasher(key);
-         size_t hash = vertex_values[h0];
-         if (likely(h1 != h0))
-            hash ^= vertex_values[h1];
-         if (likely(h2 != h1 && h2 != h0))
-            hash ^= vertex_values[h2];
-         return hash;
+         return resolve(hasher(key));
+      }
+
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). Vertex
+       * values of upcoming keys are prefetched while the current window is
+       * resolved (see support::lookup_batch)
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const auto hs = hasher(key);
+               support::prefetch_element(vertex_values, std::get<0>(hs));
+               support::prefetch_element(vertex_values, std::get<1>(hs));
+               support::prefetch_element(vertex_values, std::get<2>(hs));
+               return hs;
+            },
+            [&](const auto& hs) { return resolve(hs); });
       }
 
       size_t byte_size() const {
@@ -145,7 +220,43 @@ namespace exotic_hashing {
             sizeof(size_t) * vertex_values.size();
       }
 
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<SFMWHC>());
+         hasher.serialize(out);
+         out.write_array(vertex_values.data(), vertex_values.size());
+         out.finish();
+      }
+
+      /// Read-only SFMWHC operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         Hasher hasher;
+         std::span<const Payload> vertex_values;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<SFMWHC>());
+            hasher.deserialize(in);
+            vertex_values = in.template read_array<Payload>();
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return resolve(vertex_values, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + sizeof(Payload) * vertex_values.size();
+         }
+      };
+
       friend CompressedSFMWHC<Data, Payload, Hasher, HyperGraph>;
+
+      template<class, class, size_t, class, class, size_t>
+      friend class PartitionedSFMWHC;
+
+      template<class, size_t, class, class, class>
+      friend class FixedWidthSFMWHC;
    };
 
    template<class Data, class Payload, class Hasher, class HyperGraph>
@@ -156,6 +267,10 @@ namespace exotic_hashing {
       Hasher hasher;
       sdsl::int_vector<> vertex_values;
 
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         return _SFMWHC::resolve(vertex_values, hs);
+      }
+
      public:
       CompressedSFMWHC() noexcept {};
 
@@ -178,17 +293,12 @@ namespace exotic_hashing {
          hasher = mwhc.hasher;
          mod_N = mwhc.mod_N;
 
-         // helper to decide whether or not a value is set
-         const auto is_set = [&](const auto& val) { return val != 0 && val != mod_N.N; };
-
-         // copy & compress vertex values. Bit compression seems to be most efficient
-         // since vertex_values are all < N
+         // copy & compress vertex values. Unset values are already 0, i.e., contrary
+         // to MWHC, N is a regular vertex value that must be retained
          sdsl::int_vector<> vec(mwhc.vertex_values.size(), 0);
          assert(vec.size() == mwhc.vertex_values.size());
-         for (size_t i = 0; i < vec.size(); i++) {
-            const auto val = mwhc.vertex_values[i];
-            vec[i] = is_set(val) * val;
-         }
+         for (size_t i = 0; i < vec.size(); i++)
+            vec[i] = mwhc.vertex_values[i];
          sdsl::util::bit_compress(vec);
          vertex_values = vec;
       }
@@ -198,7 +308,119 @@ namespace exotic_hashing {
       }
 
       forceinline size_t operator()(const Data& key) const {
-         const auto [h0, h1, h2] = hasher(key);
+         return resolve(hasher(key));
+      }
+
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). Vertex
+       * values of upcoming keys are prefetched while the current window is
+       * resolved (see support::lookup_batch)
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const auto hs = hasher(key);
+               support::prefetch_element(vertex_values, std::get<0>(hs));
+               support::prefetch_element(vertex_values, std::get<1>(hs));
+               support::prefetch_element(vertex_values, std::get<2>(hs));
+               return hs;
+            },
+            [&](const auto& hs) { return resolve(hs); });
+      }
+
+      size_t byte_size() const {
+         return sizeof(hasher) + sizeof(mod_N) + sdsl::size_in_bytes(vertex_values);
+      }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<CompressedSFMWHC>());
+         hasher.serialize(out);
+         out.write_packed(vertex_values, vertex_values.width());
+         out.finish();
+      }
+
+      /// Read-only CompressedSFMWHC operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         Hasher hasher;
+         support::PackedView vertex_values;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<CompressedSFMWHC>());
+            hasher.deserialize(in);
+            vertex_values = in.read_packed();
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return _SFMWHC::resolve(vertex_values, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + vertex_values.byte_size();
+         }
+      };
+   };
+
+   /**
+    * Sharded SFMWHC. Keys are routed to shards of roughly ShardSize keys
+    * by the upper bits of a single routing hash. Each shard is an independent
+    * SFMWHC whose hypergraph comfortably fits into cache, i.e., construction
+    * never randomly accesses more than a few KiB, shards are built in
+    * parallel and a failing peel only retries the affected shard.
+    *
+    * Vertex values of all shards are stored back to back in a single bit
+    * compressed vector, the start offset of each shard's vertex range is
+    * kept in an EliasFanoList.
+    *
+    * @tparam ShardSize expected amount of keys per shard
+    * @tparam ThreadCount amount of threads used to build shards. 0 means 'all hardware threads'
+    */
+   template<class Data, class Payload, size_t ShardSize, class Hasher, class HyperGraph, size_t ThreadCount>
+   class PartitionedSFMWHC {
+      static_assert(ShardSize > 0);
+      using _SFMWHC = SFMWHC<Data, Payload, Hasher, HyperGraph>;
+
+      hashing::AquaHash<Data> route_hashfn;
+      std::uint64_t route_seed = 0;
+      size_t shard_cnt = 1;
+
+      std::vector<Hasher> hashers;
+      support::EliasFanoList<size_t> vertex_offsets;
+      sdsl::int_vector<> vertex_values;
+
+      /// shared by PartitionedSFMWHC and View
+      static forceinline size_t shard_of(const hashing::AquaHash<Data>& route_hashfn, const std::uint64_t route_seed,
+                                         const size_t shard_cnt, const Data& key) {
+         const std::uint64_t h = route_hashfn(key, _mm_set_epi64x(0, static_cast<long long>(route_seed)));
+         return (static_cast<__uint128_t>(h) * shard_cnt) >> 64;
+      }
+
+      forceinline size_t shard_of(const Data& key) const {
+         return shard_of(route_hashfn, route_seed, shard_cnt, key);
+      }
+
+      /**
+       * vertices of key's edge within shard, offset by the shard's vertex range start.
+       * Shared by PartitionedSFMWHC and View, i.e., Offsets is either an owning or a mapped EliasFanoList
+       */
+      template<class Offsets>
+      static forceinline std::tuple<size_t, size_t, size_t>
+      global_vertices_of(const std::vector<Hasher>& hashers, const Offsets& vertex_offsets, const size_t shard,
+                         const Data& key) {
+         const auto offset = vertex_offsets[shard];
+         const auto [h0, h1, h2] = hashers[shard](key);
+         return std::make_tuple(offset + h0, offset + h1, offset + h2);
+      }
+
+      forceinline std::tuple<size_t, size_t, size_t> global_vertices_of(const Data& key) const {
+         return global_vertices_of(hashers, vertex_offsets, shard_of(key), key);
+      }
+
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         const auto [h0, h1, h2] = hs;
          size_t hash = vertex_values[h0];
          if (likely(h1 != h0))
             hash ^= vertex_values[h1];
@@ -207,8 +429,355 @@ namespace exotic_hashing {
          return hash;
       }
 
+     public:
+      PartitionedSFMWHC() noexcept {};
+
+      template<class KeyIt, class PayloadIt>
+      PartitionedSFMWHC(const KeyIt& keys_begin, const KeyIt& keys_end, const PayloadIt& payloads_begin) {
+         construct(keys_begin, keys_end, payloads_begin);
+      }
+
+      explicit PartitionedSFMWHC(const std::vector<Data>& keys, const std::vector<Payload>& payloads)
+         : PartitionedSFMWHC(keys.begin(), keys.end(), payloads.begin()) {
+         assert(keys.size() == payloads.size());
+      }
+
+      template<class KeyIt, class PayloadIt>
+      void construct(const KeyIt& keys_begin, const KeyIt& keys_end, const PayloadIt& payloads_begin) {
+         const size_t n = std::distance(keys_begin, keys_end);
+         shard_cnt = std::max((n + ShardSize - 1) / ShardSize, static_cast<size_t>(1));
+
+         std::random_device r;
+         std::default_random_engine rng(r());
+         route_seed = std::uniform_int_distribution<std::uint64_t>()(rng);
+
+         // 1. Stable counting sort of key indices by shard
+         std::vector<size_t> shard_begin(shard_cnt + 1, 0);
+         for (auto it = keys_begin; it < keys_end; it++)
+            shard_begin[shard_of(*it) + 1]++;
+         for (size_t s = 0; s < shard_cnt; s++)
+            shard_begin[s + 1] += shard_begin[s];
+
+         std::vector<size_t> order(n);
+         {
+            auto fill = shard_begin;
+            for (size_t i = 0; i < n; i++)
+               order[fill[shard_of(*(keys_begin + i))]++] = i;
+         }
+
+         // 2. Lay out vertex ranges. Empty shards still receive three
+         // (unused) vertices such that lookups of non keys stay in bounds
+         constexpr size_t empty_shard_vertices = 3;
+         std::vector<size_t> offsets(shard_cnt + 1, 0);
+         for (size_t s = 0; s < shard_cnt; s++) {
+            const auto shard_size = shard_begin[s + 1] - shard_begin[s];
+            offsets[s + 1] =
+               offsets[s] + (shard_size == 0 ? empty_shard_vertices : _SFMWHC::vertices_count(shard_size));
+         }
+
+         // 3. Build shards independently. Each shard writes to a disjoint
+         // range of values, hence no synchronization is necessary
+         std::vector<Payload> values(offsets[shard_cnt], 0);
+         hashers.assign(shard_cnt, Hasher(empty_shard_vertices));
+         support::parallel_for(
+            0, shard_cnt, support::resolve_thread_count(ThreadCount),
+            [&](const size_t from, const size_t to, const size_t) {
+               std::vector<Data> keys;
+               std::vector<Payload> payloads;
+               for (size_t s = from; s < to; s++) {
+                  if (shard_begin[s] == shard_begin[s + 1])
+                     continue;
+
+                  keys.clear();
+                  payloads.clear();
+                  for (size_t i = shard_begin[s]; i < shard_begin[s + 1]; i++) {
+                     keys.push_back(*(keys_begin + order[i]));
+                     payloads.push_back(*(payloads_begin + order[i]));
+                  }
+
+                  const _SFMWHC shard(keys, payloads);
+                  assert(shard.vertex_values.size() == offsets[s + 1] - offsets[s]);
+                  hashers[s] = shard.hasher;
+                  std::copy(shard.vertex_values.begin(), shard.vertex_values.end(), values.begin() + offsets[s]);
+               }
+            },
+            1);
+
+         // 4. Compress vertex values & shard offsets
+         vertex_values = sdsl::int_vector<>(values.size(), 0);
+         for (size_t i = 0; i < values.size(); i++)
+            vertex_values[i] = values[i];
+         sdsl::util::bit_compress(vertex_values);
+
+         offsets.pop_back();
+         vertex_offsets = decltype(vertex_offsets)(offsets.begin(), offsets.end());
+      }
+
+      static std::string name() {
+         return "PartitionedSFMWHC<" + std::to_string(ShardSize) + ">";
+      }
+
+      forceinline size_t operator()(const Data& key) const {
+         return resolve(global_vertices_of(key));
+      }
+
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). Vertex
+       * values of upcoming keys are prefetched while the current window is
+       * resolved (see support::lookup_batch)
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::lookup_batch(
+            keys, n, out,
+            [&](const Data& key) {
+               const auto hs = global_vertices_of(key);
+               support::prefetch_element(vertex_values, std::get<0>(hs));
+               support::prefetch_element(vertex_values, std::get<1>(hs));
+               support::prefetch_element(vertex_values, std::get<2>(hs));
+               return hs;
+            },
+            [&](const auto& hs) { return resolve(hs); });
+      }
+
       size_t byte_size() const {
-         return sizeof(hasher) + sizeof(mod_N) + sdsl::size_in_bytes(vertex_values);
+         return sizeof(route_hashfn) + sizeof(route_seed) + sizeof(shard_cnt) + sizeof(Hasher) * hashers.size() +
+            vertex_offsets.byte_size() + sdsl::size_in_bytes(vertex_values);
       }
+
+      /// Writes this function's sections, e.g., as part of an enclosing structure. See save()
+      void serialize(support::Serializer& out) const {
+         out.write(std::array<std::uint64_t, 2>{route_seed, shard_cnt});
+         for (const auto& hasher : hashers)
+            hasher.serialize(out);
+         vertex_offsets.serialize(out);
+         out.write_packed(vertex_values, vertex_values.width());
+      }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<PartitionedSFMWHC>());
+         serialize(out);
+         out.finish();
+      }
+
+      /**
+       * Read-only PartitionedSFMWHC operating on a memory mapped file
+       * written by save(). Only the shards' hashers are copied on open, i.e.,
+       * opening a View costs O(shard count)
+       */
+      class View {
+         support::MappedFile file;
+         hashing::AquaHash<Data> route_hashfn;
+         std::uint64_t route_seed = 0;
+         size_t shard_cnt = 1;
+
+         std::vector<Hasher> hashers;
+         support::EliasFanoList<size_t, support::MappedArray> vertex_offsets;
+         support::PackedView vertex_values;
+
+        public:
+         View() = default;
+
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<PartitionedSFMWHC>());
+            deserialize(in);
+         }
+
+         /// Reads sections written by serialize(). They remain owned by in's file
+         void deserialize(support::Deserializer& in) {
+            const auto routing = in.read<std::array<std::uint64_t, 2>>();
+            route_seed = routing[0];
+            shard_cnt = routing[1];
+            hashers = std::vector<Hasher>(shard_cnt);
+            for (auto& hasher : hashers)
+               hasher.deserialize(in);
+            vertex_offsets.deserialize(in);
+            vertex_values = in.read_packed();
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            const auto shard = shard_of(route_hashfn, route_seed, shard_cnt, key);
+            return _SFMWHC::resolve(vertex_values, global_vertices_of(hashers, vertex_offsets, shard, key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + sizeof(Hasher) * hashers.size() + vertex_offsets.byte_size() -
+               sizeof(vertex_offsets) + vertex_values.byte_size();
+         }
+      };
    };
+
+   /**
+    * SFMWHC storing vertex values in a FixedWidthVector, i.e., each vertex
+    * value occupies exactly Bits bits and is extracted with a single load,
+    * shift & mask. All payloads must be representable in Bits bits. Space
+    * is Bits * vertices_count(n) / n, i.e., ~1.23 Bits bits per key for
+    * the default Hasher and ~1.13 Bits bits per key with FuseHasher.
+    *
+    * Vertex values are assigned directly into packed storage, i.e., the
+    * construction footprint beyond the hypergraph is Bits bits per vertex.
+    *
+    * lookup_batch() resolves eight keys at a time with AVX2 gathers and
+    * branch free collision handling if available.
+    */
+   template<class Data, size_t Bits, class Payload, class Hasher, class HyperGraph>
+   class FixedWidthSFMWHC {
+      using _SFMWHC = SFMWHC<Data, Payload, Hasher, HyperGraph>;
+
+      Hasher hasher;
+      support::FixedWidthVector<Bits> vertex_values;
+
+      /// shared by FixedWidthSFMWHC and View, i.e., Values is either an owning or a mapped FixedWidthVector
+      template<class Values>
+      static forceinline size_t resolve(const Values& vertex_values, const std::tuple<size_t, size_t, size_t>& hs) {
+         const auto [h0, h1, h2] = hs;
+         size_t hash = vertex_values[h0];
+         hash ^= (h1 != h0) * vertex_values[h1];
+         hash ^= (h2 != h1 && h2 != h0) * vertex_values[h2];
+         return hash;
+      }
+
+      forceinline size_t resolve(const std::tuple<size_t, size_t, size_t>& hs) const {
+         return resolve(vertex_values, hs);
+      }
+
+     public:
+      FixedWidthSFMWHC() noexcept {};
+
+      template<class KeyIt, class PayloadIt>
+      FixedWidthSFMWHC(const KeyIt& keys_begin, const KeyIt& keys_end, const PayloadIt& payloads_begin) {
+         construct(keys_begin, keys_end, payloads_begin);
+      }
+
+      explicit FixedWidthSFMWHC(const std::vector<Data>& keys, const std::vector<Payload>& payloads)
+         : FixedWidthSFMWHC(keys.begin(), keys.end(), payloads.begin()) {
+         assert(keys.size() == payloads.size());
+      }
+
+      template<class KeyIt, class PayloadIt>
+      void construct(const KeyIt& keys_begin, const KeyIt& keys_end, const PayloadIt& payloads_begin) {
+         // vertex values are xors of payloads, i.e., fit iff all payloads fit
+         const size_t n = std::distance(keys_begin, keys_end);
+         for (size_t i = 0; i < n; i++)
+            if (static_cast<std::uint64_t>(*(payloads_begin + i)) > decltype(vertex_values)::max_value)
+               throw std::runtime_error("Failed to construct FixedWidthSFMWHC: payload " + std::to_string(i) +
+                                        " exceeds " + std::to_string(Bits) + " bits");
+
+         // Find suitable peel order. Values are assigned directly into packed
+         // storage, i.e., there is never a full width copy of all vertex values
+         const auto N = _SFMWHC::vertices_count(n);
+         vertex_values = decltype(vertex_values)(N);
+         if (n == 0)
+            return;
+
+         std::optional<HyperGraph> g;
+         std::vector<size_t> peel_order;
+         while (peel_order.empty()) {
+            hasher = Hasher(N);
+            g.emplace(keys_begin, keys_end, hasher, N);
+            peel_order = g->peel();
+         }
+
+         // Assign values in reverse peel order. Each edge has at least one
+         // vertex not yet claimed by a later edge, which absorbs its payload
+         support::Bitvector<> settable(N, true);
+         for (size_t i = peel_order.size(); i-- > 0;) {
+            const auto edge_ind = peel_order[i];
+            const auto [h0, h1, h2] = g->vertices_of(edge_ind);
+            assert(settable[h0] || settable[h1] || settable[h2]);
+
+            const auto x = static_cast<std::uint64_t>(*(payloads_begin + edge_ind)) ^ resolve({h0, h1, h2});
+            const auto hinge = settable[h0] ? h0 : (settable[h1] ? h1 : h2);
+            vertex_values.set(hinge, x);
+
+            settable[h0] = false;
+            settable[h1] = false;
+            settable[h2] = false;
+
+            assert(resolve({h0, h1, h2}) == static_cast<std::uint64_t>(*(payloads_begin + edge_ind)));
+         }
+      }
+
+      static std::string name() {
+         return "FixedWidthSFMWHC<" + std::to_string(Bits) + ">";
+      }
+
+      forceinline size_t operator()(const Data& key) const {
+         return resolve(hasher(key));
+      }
+
+      /**
+       * Looks up n keys at once, i.e., out[i] = operator()(keys[i]). With
+       * AVX2, blocks of eight keys are resolved via gathers, remaining keys
+       * (and all keys without AVX2) use the prefetching support::lookup_batch
+       */
+      void lookup_batch(const Data* keys, const size_t n, size_t* out) const {
+         support::gather_lookup_batch(
+            keys, n, out, hasher, vertex_values,
+            [](const auto& v0, const auto& v1, const auto& v2) {
+               return _mm256_xor_si256(_mm256_xor_si256(v0, v1), v2);
+            },
+            [&](const auto& hs) { return resolve(hs); });
+      }
+
+      size_t byte_size() const {
+         return sizeof(hasher) + vertex_values.byte_size();
+      }
+
+      /// Writes this function's sections, e.g., as part of an enclosing structure. See save()
+      void serialize(support::Serializer& out) const {
+         hasher.serialize(out);
+         vertex_values.serialize(out);
+      }
+
+      /// Writes this function to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<FixedWidthSFMWHC>());
+         serialize(out);
+         out.finish();
+      }
+
+      /// Read-only FixedWidthSFMWHC operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         Hasher hasher;
+         support::FixedWidthVector<Bits, support::MappedArray> vertex_values;
+
+        public:
+         View() = default;
+
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<FixedWidthSFMWHC>());
+            deserialize(in);
+         }
+
+         /// Reads sections written by serialize(). They remain owned by in's file
+         void deserialize(support::Deserializer& in) {
+            hasher.deserialize(in);
+            vertex_values.deserialize(in);
+         }
+
+         forceinline size_t operator()(const Data& key) const {
+            return resolve(vertex_values, hasher(key));
+         }
+
+         size_t byte_size() const {
+            return sizeof(*this) + vertex_values.byte_size() - sizeof(vertex_values);
+         }
+      };
+   };
+
+   /**
+    * Static retrieval data structure for Bits bit payloads, e.g., shard ids
+    * or flags, storing exactly Bits bits per vertex. Payloads are passed as
+    * the smallest unsigned integer type able to represent Bits bits.
+    */
+   template<class Key, size_t Bits, class Hasher = support::Hasher<Key>,
+            class HyperGraph = support::HyperGraph<Key, Hasher>>
+   using RetrievalMWHC = FixedWidthSFMWHC<
+      Key, Bits,
+      std::conditional_t<(Bits <= 8), std::uint8_t,
+                         std::conditional_t<(Bits <= 16), std::uint16_t,
+                                            std::conditional_t<(Bits <= 32), std::uint32_t, std::uint64_t>>>,
+      Hasher, HyperGraph>;
 } // namespace exotic_hashing
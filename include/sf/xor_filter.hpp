@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <emmintrin.h>
+
+#include <hashing.hpp>
+
+#include "include/omphf/mwhc.hpp"
+#include "include/sf/sf_mwhc.hpp"
+#include "include/support/serialization.hpp"
+
+// order is important
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing {
+   /**
+    * Approximate membership filter, see Graf & Lemire, "Xor Filters: Faster
+    * and Smaller Than Bloom and Cuckoo Filters" (2020). An xor filter is
+    * a retrieval data structure storing each key's fingerprint, i.e.,
+    * contains(key) compares the retrieved value with key's fingerprint.
+    * Members always match, other keys only match with probability
+    * 2^-FingerprintBits.
+    *
+    * Fingerprints are stored in a RetrievalMWHC, i.e., space is ~1.23
+    * FingerprintBits bits per key (~1.13 with support::FuseHasher, see
+    * BinaryFuseFilter).
+    *
+    * @tparam FingerprintBits width of each fingerprint, false positive rate is 2^-FingerprintBits
+    */
+   template<class Key, size_t FingerprintBits = 8, class Hasher = support::MultiplyShiftHasher<Key>,
+            class HyperGraph = support::HyperGraph<Key, Hasher>>
+   class XorFilter {
+      static_assert(FingerprintBits > 0 && FingerprintBits <= 32);
+      static constexpr std::uint64_t fingerprint_mask = (0x1LLU << FingerprintBits) - 1;
+
+      /// keys per contains_batch() chunk, bounds the retrieved fingerprint buffer
+      static constexpr size_t batch_chunk = 1024;
+
+      using Fingerprints = RetrievalMWHC<Key, FingerprintBits, Hasher, HyperGraph>;
+      using Fingerprint = std::conditional_t<(FingerprintBits <= 8), std::uint8_t,
+                                             std::conditional_t<(FingerprintBits <= 16), std::uint16_t, std::uint32_t>>;
+
+      hashing::AquaHash<Key> fingerprint_hashfn;
+      __m128i fingerprint_seed = _mm_setzero_si128();
+      Fingerprints fingerprints;
+
+      /// shared by XorFilter and View
+      static forceinline std::uint64_t fingerprint(const hashing::AquaHash<Key>& fingerprint_hashfn,
+                                                   const __m128i& fingerprint_seed, const Key& key) {
+         const std::uint64_t h = fingerprint_hashfn(key, fingerprint_seed);
+         return (h >> 32) & fingerprint_mask;
+      }
+
+      forceinline std::uint64_t fingerprint(const Key& key) const {
+         return fingerprint(fingerprint_hashfn, fingerprint_seed, key);
+      }
+
+     public:
+      XorFilter() noexcept {};
+
+      template<class RandomIt>
+      XorFilter(const RandomIt& begin, const RandomIt& end) {
+         construct(begin, end);
+      }
+
+      explicit XorFilter(const std::vector<Key>& keys) : XorFilter(keys.begin(), keys.end()) {}
+
+      template<class RandomIt>
+      void construct(const RandomIt& begin, const RandomIt& end) {
+         std::random_device r;
+         std::default_random_engine rng(r());
+         fingerprint_seed = support::make_seed(std::uniform_int_distribution<std::uint64_t>()(rng));
+
+         std::vector<Fingerprint> fps(std::distance(begin, end));
+         for (size_t i = 0; i < fps.size(); i++)
+            fps[i] = static_cast<Fingerprint>(fingerprint(*(begin + i)));
+
+         fingerprints.construct(begin, end, fps.begin());
+      }
+
+      static std::string name() {
+         if constexpr (support::ProvidesVertexCount<Hasher>)
+            return "BinaryFuseFilter<" + std::to_string(FingerprintBits) + ">";
+         return "XorFilter<" + std::to_string(FingerprintBits) + ">";
+      }
+
+      /// Whether key is (probably) a member of the filter's key set. Never false for members
+      forceinline bool contains(const Key& key) const {
+         return fingerprints(key) == fingerprint(key);
+      }
+
+      /**
+       * Checks n keys at once, i.e., out[i] = contains(keys[i]). Fingerprint
+       * lookups are batched (see FixedWidthSFMWHC::lookup_batch)
+       */
+      void contains_batch(const Key* keys, const size_t n, bool* out) const {
+         std::array<size_t, batch_chunk> retrieved;
+         for (size_t from = 0; from < n; from += batch_chunk) {
+            const size_t cnt = std::min(batch_chunk, n - from);
+            fingerprints.lookup_batch(keys + from, cnt, retrieved.data());
+            for (size_t i = 0; i < cnt; i++)
+               out[from + i] = retrieved[i] == fingerprint(keys[from + i]);
+         }
+      }
+
+      size_t byte_size() const {
+         return sizeof(fingerprint_hashfn) + sizeof(fingerprint_seed) + fingerprints.byte_size();
+      }
+
+      /// Writes this filter to path, see support::Serializer. Load via View
+      void save(const std::string& path) const {
+         support::Serializer out(path, name(), support::type_signature<XorFilter>());
+         out.write(fingerprint_seed);
+         fingerprints.serialize(out);
+         out.finish();
+      }
+
+      /// Read-only XorFilter operating directly on a memory mapped file written by save()
+      class View {
+         support::MappedFile file;
+         hashing::AquaHash<Key> fingerprint_hashfn;
+         __m128i fingerprint_seed = _mm_setzero_si128();
+         typename Fingerprints::View fingerprints;
+
+        public:
+         explicit View(const std::string& path) : file(path) {
+            support::Deserializer in(file, name(), support::type_signature<XorFilter>());
+            fingerprint_seed = in.read<__m128i>();
+            fingerprints.deserialize(in);
+         }
+
+         /// Whether key is (probably) a member of the filter's key set. Never false for members
+         forceinline bool contains(const Key& key) const {
+            return fingerprints(key) == fingerprint(fingerprint_hashfn, fingerprint_seed, key);
+         }
+
+         size_t byte_size() const {
+            return sizeof(file) + sizeof(fingerprint_hashfn) + sizeof(fingerprint_seed) + fingerprints.byte_size();
+         }
+      };
+   };
+
+   /**
+    * Binary fuse filter, see Graf & Lemire, "Binary Fuse Filters: Fast and
+    * Smaller Than Xor Filters" (2022), i.e., an XorFilter on a spatially
+    * coupled hypergraph with ~1.13 FingerprintBits bits per key for large key sets
+    */
+   template<class Key, size_t FingerprintBits = 8>
+   using BinaryFuseFilter = XorFilter<Key, FingerprintBits, support::FuseHasher<Key>>;
+} // namespace exotic_hashing
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <sdsl/int_vector.hpp>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /// Prefetches the cache line containing vec[i]
+   template<class T>
+   forceinline void prefetch_element(const std::vector<T>& vec, const size_t i) {
+      prefetchit(vec.data() + i, 0, 3);
+   }
+
+   /// Prefetches the cache line containing (the first bit of) vec[i]
+   template<std::uint8_t Width>
+   forceinline void prefetch_element(const sdsl::int_vector<Width>& vec, const size_t i) {
+      prefetchit(vec.data() + ((i * vec.width()) >> 6), 0, 3);
+   }
+
+   /**
+    * Software pipelined batch lookup driver, i.e., computes
+    * out[i] = resolve(probe(keys[i])) for all i in [0, n).
+    *
+    * probe(key) is expected to hash key and issue prefetches for all
+    * memory locations resolve() will touch. Keys are processed in windows of
+    * Window keys: the next window is probed before the current one is
+    * resolved, such that hashing and outstanding cache misses overlap
+    * instead of being paid for key by key.
+    *
+    * @tparam Window amount of keys in flight per pipeline stage
+    */
+   template<size_t Window = 16, class Data, class ProbeFn, class ResolveFn>
+   forceinline void lookup_batch(const Data* keys, const size_t n, size_t* out, const ProbeFn& probe,
+                                 const ResolveFn& resolve) {
+      static_assert(Window > 0);
+      using Probe = std::invoke_result_t<ProbeFn, const Data&>;
+
+      if (n == 0)
+         return;
+
+      std::array<Probe, 2 * Window> probes;
+      const auto stage = [&](const size_t from, Probe* dest) {
+         const size_t to = std::min(from + Window, n);
+         for (size_t i = from; i < to; i++)
+            dest[i - from] = probe(keys[i]);
+      };
+
+      stage(0, probes.data());
+      for (size_t from = 0, w = 0; from < n; from += Window, w ^= 1) {
+         if (from + Window < n)
+            stage(from + Window, probes.data() + (w ^ 1) * Window);
+
+         const auto* current = probes.data() + w * Window;
+         const size_t to = std::min(from + Window, n);
+         for (size_t i = from; i < to; i++)
+            out[i] = resolve(current[i - from]);
+      }
+   }
+
+   /**
+    * Batch lookup for 3-hypergraph based functions storing their vertex
+    * values in a support::FixedWidthVector, i.e., computes
+    * out[i] = resolve(hasher(keys[i])) for all i in [0, n).
+    *
+    * With AVX2, blocks of eight keys are hashed & prefetched one block ahead
+    * and resolved via gathers: finalize(v0, v1, v2) combines the gathered
+    * values of four keys' vertices, where duplicate vertices (h1 == h0,
+    * h2 == h0 || h2 == h1) are already zeroed. Remaining keys (and all keys
+    * without AVX2) use the prefetching lookup_batch driver
+    */
+   template<class Data, class Hasher, class Values, class FinalizeFn, class ResolveFn>
+   forceinline void gather_lookup_batch(const Data* keys, const size_t n, size_t* out, const Hasher& hasher,
+                                        const Values& values, const FinalizeFn& finalize, const ResolveFn& resolve) {
+      size_t i = 0;
+#ifdef __AVX2__
+      if (values.gatherable() && n >= 8) {
+         alignas(32) std::array<std::array<std::uint64_t, 8>, 2> h0, h1, h2;
+         const auto stage = [&](const size_t from, const size_t b) {
+            for (size_t j = 0; j < 8; j++) {
+               std::tie(h0[b][j], h1[b][j], h2[b][j]) = hasher(keys[from + j]);
+               values.prefetch(h0[b][j]);
+               values.prefetch(h1[b][j]);
+               values.prefetch(h2[b][j]);
+            }
+         };
+
+         stage(0, 0);
+         for (size_t b = 0; i + 8 <= n; i += 8, b ^= 1) {
+            if (i + 16 <= n)
+               stage(i + 8, b ^ 1);
+
+            for (size_t j = 0; j < 8; j += 4) {
+               const auto vh0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(h0[b].data() + j));
+               const auto vh1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(h1[b].data() + j));
+               const auto vh2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(h2[b].data() + j));
+
+               const auto v0 = values.gather4(vh0);
+               const auto v1 = _mm256_andnot_si256(_mm256_cmpeq_epi64(vh1, vh0), values.gather4(vh1));
+               const auto v2 =
+                  _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi64(vh2, vh0), _mm256_cmpeq_epi64(vh2, vh1)),
+                                      values.gather4(vh2));
+               _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + j), finalize(v0, v1, v2));
+            }
+         }
+      }
+#else
+      UNUSED(finalize);
+#endif
+
+      lookup_batch(
+         keys + i, n - i, out + i,
+         [&](const Data& key) {
+            const auto hs = hasher(key);
+            values.prefetch(std::get<0>(hs));
+            values.prefetch(std::get<1>(hs));
+            values.prefetch(std::get<2>(hs));
+            return hs;
+         },
+         resolve);
+   }
+} // namespace exotic_hashing::support
@@ -1,19 +1,28 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdint>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
+#include <immintrin.h>
+
 #include "../convenience/builtins.hpp"
+#include "serialization.hpp"
 #include "support.hpp"
 
 namespace exotic_hashing::support {
    template<size_t max_bitcnt, class Storage>
    class FixedBitvector;
 
-   template<class Storage = std::uint64_t>
+   /**
+    * @tparam Container storage of units and rank/select directories. MappedArray
+    *   yields a read-only bitvector operating on a mapped file, see deserialize()
+    */
+   template<class Storage = std::uint64_t, template<class> class Container = std::vector>
    class Bitvector {
       class Bitref {
          Storage& unit;
@@ -55,16 +64,15 @@ namespace exotic_hashing::support {
          storage.resize(unit_cnt);
          storage_size = unit_cnt;
 
-         // attempt to minimize bit access overhead by 'bulk loading' storage
+         // attempt to minimize bit access overhead by 'bulk loading' storage. Bits
+         // are shifted into place independently, i.e., without a dependency chain
          for (size_t u_ind = 0; u_ind < unit_cnt; u_ind++) {
             const size_t g_ind = u_ind * unit_bits();
-            const size_t msb = std::min(unit_bits(), bitcnt - g_ind) - 1;
+            const size_t cnt = std::min(unit_bits(), bitcnt - g_ind);
 
             Storage unit = 0x0;
-            for (size_t l_ind = 0; l_ind <= msb; l_ind++) {
-               unit <<= 1;
-               unit |= gen(g_ind + msb - l_ind) & 0x1;
-            }
+            for (size_t l_ind = 0; l_ind < cnt; l_ind++)
+               unit |= static_cast<Storage>(gen(g_ind + l_ind) & 0x1) << l_ind;
 
             storage[u_ind] = unit;
          }
@@ -85,6 +93,7 @@ namespace exotic_hashing::support {
 #endif
 #if __has_builtin(__builtin_bitreverse64)
          storage.push_back(__builtin_bitreverse64(data));
+         storage_size++;
 #else
    #warning "using custom bitreverse implementation in Bitvector(std::uint64_t)"
          Storage val = 0x0;
@@ -108,12 +117,17 @@ namespace exotic_hashing::support {
        * convenience initialize with specific size & all values set to a single value
        */
       explicit Bitvector(const size_t& bitcnt, const bool& value)
-         : Bitvector(bitcnt, [&](const size_t /*index*/) { return value; }) {}
+         : storage((bitcnt + unit_bits() - 1) / unit_bits(), value ? ~static_cast<Storage>(0x0) : 0x0),
+           bitcnt(bitcnt), storage_size(storage.size()) {
+         // bits beyond bitcnt must remain unset
+         if (value && unit_local_index(bitcnt) > 0)
+            storage.back() &= (static_cast<Storage>(0x1) << unit_local_index(bitcnt)) - 1;
+      }
 
       /**
        * zero parameter constructor
        */
-      explicit Bitvector() : Bitvector(0, false) {}
+      explicit Bitvector() = default;
 
       /**
        * provides read access to i-th bit
@@ -186,9 +200,7 @@ namespace exotic_hashing::support {
        * appends all bits from other bitstream to this bitstream
        */
       forceinline void append(const Bitvector& other) {
-         // TODO(dominik): optimize this operation
-         for (size_t i = 0; i < other.size(); i++)
-            append(other[i]);
+         append_units(other.storage.data(), 0, other.size());
       }
 
       /**
@@ -196,9 +208,45 @@ namespace exotic_hashing::support {
        */
       template<size_t max_bitcnt, class S>
       forceinline void append(const FixedBitvector<max_bitcnt, S>& other) {
-         // TODO(dominik): optimize this operation
-         for (size_t i = 0; i < other.size(); i++)
-            append(other[i]);
+         if constexpr (std::is_same_v<S, Storage>) {
+            append_units(other.storage.data(), 0, other.size());
+         } else {
+            for (size_t i = 0; i < other.size(); i++)
+               append(other[i]);
+         }
+      }
+
+      /**
+       * appends bits [start, stop) from other bitstream to this bitstream
+       */
+      forceinline void append_range(const Bitvector& other, const size_t start, const size_t stop) {
+         assert(start <= stop && stop <= other.size());
+         append_units(other.storage.data(), start, stop);
+      }
+
+      /**
+       * returns a new bitvector containing bits [start, stop)
+       */
+      Bitvector slice(const size_t start, const size_t stop) const {
+         Bitvector res;
+         res.append_range(*this, start, stop);
+         return res;
+      }
+
+      /**
+       * bitwise equality, i.e., both bitvectors contain the same bits
+       */
+      bool operator==(const Bitvector& other) const {
+         if (bitcnt != other.bitcnt)
+            return false;
+
+         const auto full_units = unit_index(bitcnt);
+         if (!std::equal(storage.begin(), storage.begin() + full_units, other.storage.begin()))
+            return false;
+
+         const auto rest = unit_local_index(bitcnt);
+         return rest == 0 ||
+            ((storage[full_units] ^ other.storage[full_units]) & ((static_cast<Storage>(0x1) << rest) - 1)) == 0;
       }
 
       /**
@@ -258,6 +306,26 @@ namespace exotic_hashing::support {
          return (upper << shift) | lower;
       }
 
+      /**
+       * returns the sizeof(Storage)*8 bits [index, index + sizeof(Storage)*8),
+       * i.e., bit index becomes the window's least significant bit. Bits past
+       * the end of this bitvector read as zero. Contrary to extract(), both
+       * adjacent units are always loaded, i.e., there is no branch on the
+       * window's alignment
+       */
+      forceinline Storage peek(const size_t index) const {
+         assert(index < bitcnt);
+
+         const auto u_ind = unit_index(index);
+         const auto l_ind = unit_local_index(index);
+
+         const Storage lower = storage[u_ind] >> l_ind;
+         const Storage upper = u_ind + 1 < storage_size ? storage[u_ind + 1] : 0x0;
+
+         // shifting twice avoids undefined behaviour for l_ind == 0
+         return lower | ((upper << 1) << (unit_bits() - 1 - l_ind));
+      }
+
       /**
        * Checks whether this bitvector matches the given prefix, beginning at start.
        * Test succeeds when all prefix bits or self bits are consumed (whichever one comes first).
@@ -296,18 +364,248 @@ namespace exotic_hashing::support {
        * returns this bitvector's size in bytes
        */
       forceinline size_t byte_size() const {
-         return sizeof(decltype(*this)) + sizeof(Storage) * storage.size();
+         return sizeof(decltype(*this)) + sizeof(Storage) * storage.size() +
+            sizeof(std::uint64_t) * (rank_directory.size() + select_samples.size());
+      }
+
+      /**
+       * Builds the rank/select directory. Must be called (again) after the
+       * last modification and before any rank()/select() query.
+       *
+       * Layout follows poppy, see Zhou et al., "Space-Efficient,
+       * High-Performance Rank & Select Structures on Uncompressed Bit
+       * Sequences" (2013): each 2048-bit block stores its absolute rank and
+       * the relative ranks of its 512-bit sub-blocks 1-3 in two adjacent
+       * words (6.25% space overhead). A rank query popcounts at most one
+       * sub-block (a single VPOPCNTQ with AVX-512). Select samples the block
+       * of every select_sample_rate-th one bit, binary searches the blocks up
+       * to the next sample and finishes with a broadword in-word select.
+       * Requires 64-bit Storage.
+       */
+      void init_rank_select() {
+         static_assert(sizeof(Storage) == sizeof(std::uint64_t), "rank/select requires 64-bit storage units");
+
+         const size_t block_cnt = storage_size / words_per_block + 1;
+         rank_directory.assign(2 * block_cnt, 0);
+         select_samples.clear();
+
+         std::uint64_t ones = 0;
+         for (size_t b = 0; b < block_cnt; b++) {
+            rank_directory[2 * b] = ones;
+
+            std::uint64_t relative = 0, in_block = 0;
+            for (size_t sb = 0; sb < subblocks_per_block; sb++) {
+               if (sb > 0)
+                  relative |= in_block << (relative_bits * (sb - 1));
+
+               const size_t first = b * words_per_block + sb * words_per_subblock;
+               in_block += popcount_units(storage.data() + std::min(first, storage_size),
+                                          std::min(first + words_per_subblock, storage_size) -
+                                             std::min(first, storage_size));
+
+               // sample the block of every select_sample_rate-th one bit
+               while (select_samples.size() * select_sample_rate < ones + in_block)
+                  select_samples.push_back(b);
+            }
+
+            rank_directory[2 * b + 1] = relative;
+            ones += in_block;
+         }
+         // sentinel, i.e., every sample has a successor
+         select_samples.push_back(block_cnt - 1);
+         one_cnt = ones;
+      }
+
+      /**
+       * amount of one bits in [0, index). Requires init_rank_select()
+       */
+      forceinline size_t rank(const size_t index) const {
+         assert(index <= bitcnt);
+         assert(!rank_directory.empty());
+
+         const auto u_ind = unit_index(index);
+         const auto b = u_ind / words_per_block;
+
+         // relative rank of sub-block sb is stored in field sb - 1. For sb == 0,
+         // the field index wraps to 3, which is always 0
+         const std::uint64_t t = (u_ind % words_per_block) / words_per_subblock - 1;
+         size_t res = rank_directory[2 * b] +
+            ((rank_directory[2 * b + 1] >> (relative_bits * (t + ((t >> 60) & 0x4)))) & relative_mask);
+
+         // preceding units of the sub-block & the unit itself
+         const auto first = u_ind & ~(words_per_subblock - 1);
+         res += popcount_units(storage.data() + first, u_ind - first);
+         if (unlikely(u_ind >= storage_size))
+            return res;
+         return res + __builtin_popcountll(storage[u_ind] & ((0x1LLU << unit_local_index(index)) - 1));
+      }
+
+      /**
+       * position of the (rank + 1)-th one bit, i.e., select(0) is the first
+       * one bit. Requires init_rank_select() and rank < ones()
+       */
+      forceinline size_t select(const size_t rank) const {
+         assert(rank < one_cnt);
+
+         // 1. last block whose absolute rank is <= rank, between the surrounding samples
+         size_t lo = select_samples[rank / select_sample_rate];
+         size_t hi = select_samples[rank / select_sample_rate + 1];
+         while (hi - lo > 8) {
+            const auto mid = lo + (hi - lo) / 2;
+            if (rank_directory[2 * mid] <= rank)
+               lo = mid;
+            else
+               hi = mid;
+         }
+         while (lo < hi && rank_directory[2 * (lo + 1)] <= rank)
+            lo++;
+
+         // 2. sub-block, i.e., amount of relative ranks <= remaining rank
+         auto remaining = rank - rank_directory[2 * lo];
+         const auto relative = rank_directory[2 * lo + 1];
+         size_t sb = 0;
+         for (size_t j = 0; j + 1 < subblocks_per_block; j++)
+            sb += ((relative >> (relative_bits * j)) & relative_mask) <= remaining;
+         if (sb > 0)
+            remaining -= (relative >> (relative_bits * (sb - 1))) & relative_mask;
+
+         // 3. unit within sub-block & broadword select within unit
+         auto u_ind = lo * words_per_block + sb * words_per_subblock;
+         for (size_t cnt = __builtin_popcountll(storage[u_ind]); remaining >= cnt;
+              cnt = __builtin_popcountll(storage[++u_ind]))
+            remaining -= cnt;
+         return u_ind * unit_bits() + select64(storage[u_ind], remaining);
+      }
+
+      /**
+       * amount of one bits. Requires init_rank_select()
+       */
+      forceinline size_t ones() const {
+         return one_cnt;
+      }
+
+      /// Writes bits & rank/select directories, see support::Serializer
+      void serialize(Serializer& out) const {
+         out.write(std::array<std::uint64_t, 2>{bitcnt, one_cnt});
+         out.write_array(storage.data(), storage.size());
+         out.write_array(rank_directory.data(), rank_directory.size());
+         out.write_array(select_samples.data(), select_samples.size());
+      }
+
+      void deserialize(Deserializer& in) {
+         const auto counts = in.read<std::array<std::uint64_t, 2>>();
+         bitcnt = counts[0];
+         one_cnt = counts[1];
+         in.read_array(storage);
+         storage_size = storage.size();
+         in.read_array(rank_directory);
+         in.read_array(select_samples);
       }
 
      private:
-      std::vector<Storage> storage;
+      Container<Storage> storage;
       size_t bitcnt = 0;
       size_t storage_size = 0;
 
-      forceinline constexpr size_t unit_bits() const {
+      static constexpr size_t words_per_block = 32;
+      static constexpr size_t words_per_subblock = 8;
+      static constexpr size_t subblocks_per_block = words_per_block / words_per_subblock;
+      static constexpr size_t relative_bits = 11;
+      static constexpr std::uint64_t relative_mask = (0x1LLU << relative_bits) - 1;
+      static constexpr size_t select_sample_rate = 8192;
+
+      /// two words per 2048-bit block, see init_rank_select()
+      Container<std::uint64_t> rank_directory;
+      /// block containing the (i * select_sample_rate)-th one bit
+      Container<std::uint64_t> select_samples;
+      size_t one_cnt = 0;
+
+      /// amount of one bits in cnt <= words_per_subblock consecutive units
+      static forceinline size_t popcount_units(const Storage* units, const size_t cnt) {
+         assert(cnt <= words_per_subblock);
+#ifdef __AVX512VPOPCNTDQ__
+         if constexpr (sizeof(Storage) == sizeof(std::uint64_t)) {
+            // masked out units are never accessed, i.e., reading past the end is fine
+            const auto vals = _mm512_maskz_loadu_epi64(static_cast<__mmask8>((0x1U << cnt) - 1), units);
+            return _mm512_reduce_add_epi64(_mm512_popcnt_epi64(vals));
+         }
+#endif
+         size_t res = 0;
+         for (size_t i = 0; i < cnt; i++)
+            res += __builtin_popcountll(units[i]);
+         return res;
+      }
+
+      static forceinline constexpr size_t unit_bits() {
          return sizeof(Storage) * 8;
       }
 
+      /// len <= unit_bits() bits of units starting at pos, never touching units beyond the last requested bit
+      static forceinline Storage get_bits(const Storage* units, const size_t pos, const size_t len) {
+         const auto u_ind = pos / unit_bits();
+         const auto l_ind = pos % unit_bits();
+
+         Storage val = units[u_ind] >> l_ind;
+         if (l_ind + len > unit_bits())
+            val |= units[u_ind + 1] << (unit_bits() - l_ind);
+         return len < unit_bits() ? val & ((static_cast<Storage>(0x1) << len) - 1) : val;
+      }
+
+      /**
+       * writes cnt full units of bits starting at bit pos of units to dest,
+       * i.e., shifts two adjacent source units into place per destination unit
+       */
+      static forceinline void copy_units(const Storage* units, const size_t pos, Storage* dest, const size_t cnt) {
+         const auto* src = units + pos / unit_bits();
+         const auto shift = pos % unit_bits();
+         if (shift == 0) {
+            std::copy_n(src, cnt, dest);
+            return;
+         }
+
+         size_t i = 0;
+#ifdef __AVX2__
+         if constexpr (sizeof(Storage) == sizeof(std::uint64_t)) {
+            const auto right = _mm_cvtsi64_si128(static_cast<long long>(shift));
+            const auto left = _mm_cvtsi64_si128(static_cast<long long>(unit_bits() - shift));
+            for (; i + 4 <= cnt; i += 4) {
+               const auto lower = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+               const auto upper = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 1));
+               _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+                                   _mm256_or_si256(_mm256_srl_epi64(lower, right), _mm256_sll_epi64(upper, left)));
+            }
+         }
+#endif
+         for (; i < cnt; i++)
+            dest[i] = (src[i] >> shift) | (src[i + 1] << (unit_bits() - shift));
+      }
+
+      /// appends bits [start, stop) of units to this bitvector unit by unit
+      void append_units(const Storage* units, size_t start, const size_t stop) {
+         // 1. fill up the last, partially used unit
+         const auto l_ind = unit_local_index(bitcnt);
+         if (l_ind > 0 && start < stop) {
+            const auto cnt = std::min(unit_bits() - l_ind, stop - start);
+            append(get_bits(units, start, cnt), cnt);
+            start += cnt;
+         }
+         if (start >= stop)
+            return;
+
+         // 2. bitcnt is unit aligned, i.e., source units can be shifted directly into new units
+         assert(unit_index(bitcnt) == storage_size);
+         const auto full_units = (stop - start) / unit_bits();
+         const auto rest = (stop - start) % unit_bits();
+         const auto dest = storage_size;
+         storage.resize(dest + full_units + (rest > 0));
+         storage_size = storage.size();
+
+         copy_units(units, start, storage.data() + dest, full_units);
+         if (rest > 0)
+            storage[dest + full_units] = get_bits(units, start + full_units * unit_bits(), rest);
+         bitcnt += stop - start;
+      }
+
       forceinline constexpr size_t unit_index(const size_t& index) const {
          return index >> ctz(unit_bits());
       }
@@ -363,13 +661,11 @@ namespace exotic_hashing::support {
             if (g_ind > bitcnt)
                break;
 
-            const size_t msb = std::min(unit_bits(), bitcnt - g_ind) - 1;
+            const size_t cnt = std::min(unit_bits(), bitcnt - g_ind);
 
             Storage unit = 0x0;
-            for (size_t l_ind = 0; l_ind <= msb && g_ind + l_ind < bitcnt; l_ind++) {
-               unit <<= 1;
-               unit |= gen(g_ind + msb - l_ind) & 0x1;
-            }
+            for (size_t l_ind = 0; l_ind < cnt; l_ind++)
+               unit |= static_cast<Storage>(gen(g_ind + l_ind) & 0x1) << l_ind;
 
             storage[u_ind] = unit;
          }
@@ -520,6 +816,23 @@ namespace exotic_hashing::support {
          return true;
       }
 
+      /**
+       * bitwise equality, i.e., both bitvectors contain the same bits
+       */
+      bool operator==(const FixedBitvector& other) const {
+         if (bitcnt != other.bitcnt)
+            return false;
+
+         const auto full_units = unit_index(bitcnt);
+         for (size_t u_ind = 0; u_ind < full_units; u_ind++)
+            if (storage[u_ind] != other.storage[u_ind])
+               return false;
+
+         const auto rest = unit_local_index(bitcnt);
+         return rest == 0 ||
+            ((storage[full_units] ^ other.storage[full_units]) & ((static_cast<Storage>(0x1) << rest) - 1)) == 0;
+      }
+
       /**
        * returns this bitvector's size in bytes
        */
@@ -528,6 +841,9 @@ namespace exotic_hashing::support {
       }
 
      private:
+      template<class S, template<class> class C>
+      friend class Bitvector;
+
       template<class T = double>
       static constexpr size_t ceil(T num) {
          return (static_cast<T>(static_cast<size_t>(num)) == num) ? static_cast<size_t>(num) :
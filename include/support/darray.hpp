@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "serialization.hpp"
+#include "support.hpp"
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /**
+    * Select directory for an external, immutable array of 64-bit words, see
+    * Okanohara & Sadakane, "Practical Entropy-Compressed Rank/Select
+    * Dictionary" (2007). Selects one bits (Ones == true) or zero bits.
+    *
+    * Bits are grouped into blocks of block_ones selected bits each:
+    *  - dense blocks (spanning less than sparse_span bits) store their first
+    *    position plus 16-bit relative positions of every subblock_ones-th
+    *    bit, i.e., a query scans at most subblock_ones bits, typically
+    *    within a single cache line
+    *  - sparse blocks explicitly store all their positions
+    *
+    * @tparam Container directory storage. MappedArray yields a read-only
+    *   directory operating on a mapped file, see deserialize()
+    */
+   template<bool Ones = true, size_t SubblockOnes = 32, template<class> class Container = std::vector>
+   class DArray {
+      static_assert(SubblockOnes > 0 && 1024 % SubblockOnes == 0);
+
+      static constexpr size_t block_ones = 1024;
+      static constexpr size_t subblock_ones = SubblockOnes;
+      static constexpr size_t subblocks_per_block = block_ones / subblock_ones;
+      static constexpr size_t sparse_span = 0x1 << 16;
+
+      /// >= 0: position of the block's first bit. < 0: -(offset + 1) of the block in sparse_positions
+      Container<std::int64_t> inventory;
+      /// positions of every subblock_ones-th bit of dense blocks, relative to the block's first bit
+      Container<std::uint16_t> subinventory;
+      Container<std::uint64_t> sparse_positions;
+      size_t cnt = 0;
+
+      static forceinline std::uint64_t word(const std::uint64_t* words, const size_t i) {
+         if constexpr (Ones)
+            return words[i];
+         else
+            return ~words[i];
+      }
+
+     public:
+      DArray() = default;
+
+      /**
+       * @param words the bits. Must outlive this directory and remain unmodified
+       * @param bitcnt amount of valid bits in words, i.e., trailing bits of the last word are ignored
+       */
+      DArray(const std::uint64_t* words, const size_t bitcnt) {
+         // 1. positions of every subblock_ones-th bit
+         std::vector<std::uint64_t> samples;
+         const size_t word_cnt = (bitcnt + 63) / 64;
+         for (size_t i = 0; i < word_cnt; i++) {
+            auto w = word(words, i);
+            if (i + 1 == word_cnt && bitcnt % 64 != 0)
+               w &= (0x1LLU << (bitcnt % 64)) - 1;
+
+            const size_t ones = __builtin_popcountll(w);
+            // first sample within this word
+            for (auto next = (cnt + subblock_ones - 1) / subblock_ones * subblock_ones; next < cnt + ones;
+                 next += subblock_ones)
+               samples.push_back(64 * i + select64(w, next - cnt));
+            cnt += ones;
+         }
+
+         // 2. dense blocks store relative samples, sparse blocks all positions
+         const size_t block_cnt = (cnt + block_ones - 1) / block_ones;
+         inventory.resize(block_cnt);
+         subinventory.assign(block_cnt * subblocks_per_block, 0);
+         for (size_t b = 0; b < block_cnt; b++) {
+            const auto first = samples[b * subblocks_per_block];
+            const auto next = (b + 1) * subblocks_per_block < samples.size() ? samples[(b + 1) * subblocks_per_block]
+                                                                             : static_cast<std::uint64_t>(bitcnt);
+            if (next - first <= sparse_span) {
+               inventory[b] = static_cast<std::int64_t>(first);
+               for (size_t s = b * subblocks_per_block; s < std::min((b + 1) * subblocks_per_block, samples.size());
+                    s++)
+                  subinventory[s] = static_cast<std::uint16_t>(samples[s] - first);
+               continue;
+            }
+
+            inventory[b] = -static_cast<std::int64_t>(sparse_positions.size()) - 1;
+            const auto block_size = std::min(block_ones, cnt - b * block_ones);
+            size_t collected = 0;
+            for (size_t i = first / 64; collected < block_size; i++) {
+               auto w = word(words, i) & (i == first / 64 ? ~0x0LLU << (first % 64) : ~0x0LLU);
+               for (; w != 0 && collected < block_size; w &= w - 1, collected++)
+                  sparse_positions.push_back(64 * i + ctz(w));
+            }
+         }
+      }
+
+      /**
+       * position of the (k + 1)-th selected bit, i.e., select(words, 0) is
+       * the first one. words must be the array this directory was built on
+       * and k < size()
+       */
+      forceinline size_t select(const std::uint64_t* words, const size_t k) const {
+         assert(k < cnt);
+
+         const auto entry = inventory[k / block_ones];
+         if (unlikely(entry < 0))
+            return sparse_positions[static_cast<size_t>(-entry - 1) + k % block_ones];
+
+         // scan from the preceding sample
+         const size_t pos = static_cast<size_t>(entry) + subinventory[k / subblock_ones];
+         size_t remaining = k % subblock_ones;
+         size_t i = pos / 64;
+         auto w = word(words, i) & (~0x0LLU << (pos % 64));
+         for (size_t ones = __builtin_popcountll(w); remaining >= ones; ones = __builtin_popcountll(w)) {
+            remaining -= ones;
+            w = word(words, ++i);
+         }
+         return 64 * i + select64(w, remaining);
+      }
+
+      /// amount of selectable bits
+      size_t size() const {
+         return cnt;
+      }
+
+      size_t byte_size() const {
+         return sizeof(*this) + sizeof(std::int64_t) * inventory.size() +
+            sizeof(std::uint16_t) * subinventory.size() + sizeof(std::uint64_t) * sparse_positions.size();
+      }
+
+      /// Writes this directory (not the words it was built on), see support::Serializer
+      void serialize(Serializer& out) const {
+         out.write(static_cast<std::uint64_t>(cnt));
+         out.write_array(inventory.data(), inventory.size());
+         out.write_array(subinventory.data(), subinventory.size());
+         out.write_array(sparse_positions.data(), sparse_positions.size());
+      }
+
+      void deserialize(Deserializer& in) {
+         cnt = in.read<std::uint64_t>();
+         in.read_array(inventory);
+         in.read_array(subinventory);
+         in.read_array(sparse_positions);
+      }
+   };
+} // namespace exotic_hashing::support
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <array>
+#include <bit>
 #include <cassert>
-#include <cmath>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <vector>
 
 #include "../convenience/builtins.hpp"
@@ -11,137 +14,297 @@
 #include "support.hpp"
 
 namespace exotic_hashing::support {
+   namespace code_detail {
+      /// whether the bitstream supports fetching 64-bit windows via peek()
+      template<class BitStream>
+      concept Peekable = requires(const BitStream& stream) {
+         { stream.peek(size_t{}) } -> std::same_as<std::uint64_t>;
+      };
+
+      /// lowest cnt bits of x. Note that cnt must be less than 64
+      static forceinline std::uint64_t low_bits(const std::uint64_t x, const size_t cnt) {
+         assert(cnt < 64);
+         return x & ((0x1LLU << cnt) - 1);
+      }
+
+      static constexpr size_t short_code_bits = 10;
+
+      /**
+       * Lookup table for elias delta codes of at most short_code_bits bits,
+       * i.e., x < 64, indexed by the code's window. Entries are
+       * (x << 8) | code length or 0 iff the window starts with a longer code
+       */
+      inline constexpr std::array<std::uint16_t, 0x1 << short_code_bits> delta_short_codes = [] {
+         std::array<std::uint16_t, 0x1 << short_code_bits> table{};
+         for (size_t window = 0; window < table.size(); window++) {
+            const size_t L = std::countr_zero(window | table.size());
+            const size_t N = ((0x1LLU << L) | ((window >> (L + 1)) & ((0x1LLU << L) - 1))) - 1;
+            const size_t length = 2 * L + 1 + N;
+            if (length > short_code_bits)
+               continue;
+
+            const size_t x = (0x1LLU << N) | ((window >> (2 * L + 1)) & ((0x1LLU << N) - 1));
+            table[window] = static_cast<std::uint16_t>((x << 8) | length);
+         }
+         return table;
+      }();
+
+      /// floor(log2(x)), x must be greater than 0
+      template<class T>
+      forceinline size_t log2(const T& x) {
+         assert(x > 0);
+         return sizeof(T) * 8 - clz(x) - 1;
+      }
+
+      /// cnt < 64 bits starting at pos. Does not access the stream if cnt == 0
+      template<class BitStream>
+      forceinline std::uint64_t read_bits(const BitStream& stream, const size_t pos, const size_t cnt) {
+         if (cnt == 0)
+            return 0;
+         if constexpr (Peekable<BitStream>)
+            return low_bits(stream.peek(pos), cnt);
+         else
+            return stream.extract(pos, pos + cnt);
+      }
+   } // namespace code_detail
+
    /**
     * Elias Gamma Encoding and Decoding for positive integers (excluding 0).
+    *
+    * Encoding of x with N = floor(log2(x)): N zero bits, a one bit and the N
+    * low order bits of x (least significant bit first)
     */
    struct EliasGammaCoder {
+      static std::string name() {
+         return "EliasGamma";
+      }
+
+      /// amount of bits encode(x) appends
+      template<class T>
+      static forceinline size_t bits(const T& x) {
+         return 2 * code_detail::log2(x) + 1;
+      }
+
       /**
-       * Elias gamma encodes a given positive integer into a bitsream
+       * Elias gamma encodes a given positive integer and appends the code to
+       * a caller provided bitstream, i.e., no intermediate bitstream is allocated
        *
-       * @tparam BitStream bitstream container. Must support `push_back()`.
-       *   Defaults to support::Bitvector
+       * @tparam BitStream bitstream container. Must support `append(value, cnt)`.
        * @tparam T integer datatype, e.g., uint64_t. Note that `sizeof(T)` does
        *   not influence the resulting bitstream, i.e., downcasting to a smaller
-       *   type is not necessary before encoding. Defaults to std::uint64_t
+       *   type is not necessary before encoding.
        */
-      template<class BitStream = Bitvector<>, class T = std::uint64_t>
-      static forceinline BitStream encode(const T& x) {
-         assert(x > 0);
-
-         // special case x == 1, i.e., N == 0
-         if (x == 1)
-            return BitStream(1, true);
-
-         // N = floor(log2(x))
-         const size_t lz = clz(x);
-         const size_t N = unlikely(lz == 0) ? sizeof(T) * 8 : (sizeof(T) * 8 - lz - 1);
-         assert(N == static_cast<size_t>(std::floor(std::log2(x))));
+      template<class BitStream, class T>
+      static forceinline void encode(const T& x, BitStream& stream) {
+         const size_t N = code_detail::log2(x);
 
          // 1. encode N in unary
-         BitStream res(N + 1, false);
-         res[N] = true;
+         stream.append(static_cast<std::uint64_t>(0x1) << N, N + 1);
 
-         // 2. append the N-1 remaining binary digits of x
-         res.append(x, N);
+         // 2. append the N remaining binary digits of x
+         if (N > 0)
+            stream.append(x, N);
+      }
 
+      /**
+       * Elias gamma encodes a given positive integer into a new bitstream
+       *
+       * @tparam BitStream bitstream container. Must support `append(value, cnt)`.
+       *   Defaults to support::Bitvector
+       * @tparam T integer datatype, e.g., uint64_t. Defaults to std::uint64_t
+       */
+      template<class BitStream = Bitvector<>, class T = std::uint64_t>
+      static forceinline BitStream encode(const T& x) {
+         BitStream res;
+         encode(x, res);
          return res;
       }
 
       /**
-       * Decodes an elias gamma encoded bitstream
+       * Decodes an elias gamma encoded bitstream. Bitstreams supporting
+       * `peek()` (e.g., Bitvector<>) decode codes of up to 64 bits from a single
+       * window, i.e., with one tzcnt and a shift, without scanning or
+       * extracting bits individually
        *
        * @tparam T encoded integer datatype, e.g., uint64_t. Note that T must
        *   be large enough to represent your number. Defaults to uint64_t
-       * @tparam BitStream bitstream container. Must support index access via
-       *   `[i]`. Defaults to Bitvector<>
+       * @tparam BitStream bitstream container. Must support `peek(i)` or
+       *   `count_zeroes(i)` and `extract(start, stop)`. Defaults to Bitvector<>
        *
        * @param stream the bitstream to decode
-       * @param start first index in bitstream to look at. Defaults to 0.
+       * @param start first index in bitstream to look at. Advanced past the code
        *
-       * @return the decoded number as well as the amount of bits consumed
+       * @return the decoded number
        */
       template<class T = std::uint64_t, class BitStream = Bitvector<>>
       static forceinline T decode(const BitStream& stream, size_t& start) {
-         // decode N = floor(log2(x)) (unary)
-         const size_t N = stream.count_zeroes(start);
+         if constexpr (code_detail::Peekable<BitStream>) {
+            const std::uint64_t window = stream.peek(start);
 
-         // move bitptr
-         start += N + 1;
+            // decode N = floor(log2(x)) (unary). Since N < 64, window can not be zero
+            const size_t N = ctz(window);
 
-         if (N == 0)
-            return 1;
+            std::uint64_t tail;
+            if (likely(N < 32)) {
+               // entire code (2N + 1 bits) is contained in window
+               tail = code_detail::low_bits(window >> N >> 1, N);
+               start += 2 * N + 1;
+            } else {
+               start += N + 1;
+               tail = code_detail::low_bits(stream.peek(start), N);
+               start += N;
+            }
 
-         // decode remaining N bits
-         const T tail = stream.extract(start, start + N);
+            return static_cast<T>((static_cast<std::uint64_t>(0x1) << N) | tail);
+         } else {
+            // decode N = floor(log2(x)) (unary)
+            const size_t N = stream.count_zeroes(start);
 
-         // move bitptr
-         start += N;
+            // move bitptr
+            start += N + 1;
 
-         // x is 0x1 followed by the remaining bits.
-         // ternary guards against invalid shift exponent
-         return (N >= sizeof(T) * 8 ? static_cast<T>(0x0) : (static_cast<T>(0x1) << N)) | tail;
+            if (N == 0)
+               return 1;
+
+            // decode remaining N bits
+            const T tail = stream.extract(start, start + N);
+
+            // move bitptr
+            start += N;
+
+            // x is 0x1 followed by the remaining bits
+            return (static_cast<T>(0x1) << N) | tail;
+         }
       }
    };
 
    /**
     * Elias Delta Encoding and Decoding for positive integers (excluding 0).
+    *
+    * Encoding of x with N = floor(log2(x)): gamma code of N + 1 followed by
+    * the N low order bits of x (least significant bit first)
     */
    struct EliasDeltaCoder {
+      static std::string name() {
+         return "EliasDelta";
+      }
+
+      /// amount of bits encode(x) appends
+      template<class T>
+      static forceinline size_t bits(const T& x) {
+         const auto N = code_detail::log2(x);
+         return EliasGammaCoder::bits(N + 1) + N;
+      }
+
       /**
-       * Elias delta encodes a given positive integer into a bitsream
+       * Elias delta encodes a given positive integer and appends the code to
+       * a caller provided bitstream, i.e., no intermediate bitstream is allocated
        *
-       * @tparam BitStream bitstream container. Must support `push_back()`.
-       *   Defaults to Bitvector<>
+       * @tparam BitStream bitstream container. Must support `append(value, cnt)`.
        * @tparam T integer datatype, e.g., uint64_t. Note that `sizeof(T)` does
        *   not influence the resulting bitstream, i.e., downcasting to a smaller
-       *   type is not necessary before encoding. Defaults to std::uint64_t
+       *   type is not necessary before encoding.
        */
-      template<class BitStream = Bitvector<>, class T = std::uint64_t>
-      static forceinline BitStream encode(const T& x) {
-         assert(x > 0);
-
-         // N = floor(log2(x))
-         const size_t lz = clz(x);
-         const size_t N = unlikely(lz == 0) ? sizeof(T) * 8 : (sizeof(T) * 8) - lz - 1;
-         assert(N == static_cast<size_t>(std::floor(std::log2(x))));
+      template<class BitStream, class T>
+      static forceinline void encode(const T& x, BitStream& stream) {
+         const size_t N = code_detail::log2(x);
 
          // 1. encode N+1 with elias gamma encoding
-         BitStream res = EliasGammaCoder::encode(N + 1);
+         EliasGammaCoder::encode(N + 1, stream);
 
          // 2. append the N remaining binary digits of x to this representation
          if (N > 0)
-            res.append(x, N);
+            stream.append(x, N);
+      }
 
+      /**
+       * Elias delta encodes a given positive integer into a new bitstream
+       *
+       * @tparam BitStream bitstream container. Must support `append(value, cnt)`.
+       *   Defaults to Bitvector<>
+       * @tparam T integer datatype, e.g., uint64_t. Defaults to std::uint64_t
+       */
+      template<class BitStream = Bitvector<>, class T = std::uint64_t>
+      static forceinline BitStream encode(const T& x) {
+         BitStream res;
+         encode(x, res);
          return res;
       }
 
       /**
-       * Decodes an elias delta encoded bitstream
+       * Decodes an elias delta encoded bitstream. Bitstreams supporting
+       * `peek()` (e.g., Bitvector<>) decode codes of up to 64 bits, i.e., all
+       * x < 2^51, from a single window: codes of x < 64 via a 2 KiB lookup
+       * table, longer codes via one tzcnt with all binary parts shifted out
+       * of the same window
        *
        * @tparam T encoded integer datatype, e.g., uint64_t. Note that T must
        *   be large enough to represent your number. Defaults to uint64_t
-       * @tparam BitStream bitstream container. Must support index access via
-       *   `[i]`. Defaults to Bitvector<>
+       * @tparam BitStream bitstream container. Must support `peek(i)` or
+       *   `count_zeroes(i)` and `extract(start, stop)`. Defaults to Bitvector<>
        *
        * @param stream the bitstream to decode
-       * @param start first index in bitstream to look at. Defaults to 0. Must be within bounds!
-       *
+       * @param start first index in bitstream to look at. Must be within bounds!
+       *   Advanced past the code
        */
       template<class T = std::uint64_t, class BitStream = Bitvector<>>
       static forceinline T decode(const BitStream& stream, size_t& start) {
-         // decode N (first bits encode N+1)
-         const auto N = EliasGammaCoder::decode(stream, start) - 1;
+         if constexpr (code_detail::Peekable<BitStream>) {
+            const std::uint64_t window = stream.peek(start);
+
+            // short codes (the vast majority of trie node fields) via table lookup
+            const auto entry = code_detail::delta_short_codes[window & (code_detail::delta_short_codes.size() - 1)];
+            if (likely(entry != 0)) {
+               start += entry & 0xFF;
+               return static_cast<T>(entry >> 8);
+            }
+
+            // gamma coded header: L = floor(log2(N+1)) <= 6 zeroes, a one bit and L bits of N+1
+            const size_t L = ctz(window);
+            const size_t N = ((static_cast<size_t>(0x1) << L) | code_detail::low_bits(window >> (L + 1), L)) - 1;
+            const size_t header_bits = 2 * L + 1;
+
+            std::uint64_t tail;
+            if (likely(header_bits + N <= 64)) {
+               tail = code_detail::low_bits(window >> header_bits, N);
+               start += header_bits + N;
+            } else {
+               start += header_bits;
+               tail = code_detail::low_bits(stream.peek(start), N);
+               start += N;
+            }
+
+            return static_cast<T>((static_cast<std::uint64_t>(0x1) << N) | tail);
+         } else {
+            // decode N (first bits encode N+1)
+            const auto N = EliasGammaCoder::decode(stream, start) - 1;
 
-         // special case encoding
-         if (N == 0)
-            return 1;
+            // special case encoding
+            if (N == 0)
+               return 1;
 
-         // number as 0x1 followed by the remaining bits
-         // decode remaining N bits
-         const T tail = stream.extract(start, start + N);
-         start += N;
+            // number as 0x1 followed by the remaining bits
+            // decode remaining N bits
+            const T tail = stream.extract(start, start + N);
+            start += N;
 
-         return (N >= sizeof(T) * 8 ? static_cast<T>(0x0) : (static_cast<T>(0x1) << N)) | tail;
+            return (static_cast<T>(0x1) << N) | tail;
+         }
+      }
+
+      /**
+       * Decodes Cnt consecutive elias delta codes, e.g., all fields of a
+       * serialized trie node, in a single call
+       *
+       * @param stream the bitstream to decode
+       * @param start first index in bitstream to look at. Advanced past the last code
+       */
+      template<size_t Cnt, class T = std::uint64_t, class BitStream = Bitvector<>>
+      static forceinline std::array<T, Cnt> decode_fields(const BitStream& stream, size_t& start) {
+         std::array<T, Cnt> res;
+         for (size_t i = 0; i < Cnt; i++)
+            res[i] = decode<T>(stream, start);
+         return res;
       }
    };
 } // namespace exotic_hashing::support
@@ -1,28 +1,68 @@
 #pragma once
 
 #include <algorithm>
-#include <cmath>
-#include <sdsl/bit_vectors.hpp>
-#include <stdexcept>
-
-#include "bitconverter.hpp"
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "darray.hpp"
+#include "serialization.hpp"
 #include "support.hpp"
 
+#include "../convenience/builtins.hpp"
+
 namespace exotic_hashing::support {
    /**
    * Elias Fano Lists are able to store lists of n *non decreasing*
-   * integers out of the universe [0...m) in n * (2+ ceil(log(m/n))) bits,
+   * integers out of the universe [0...m) in n * (2 + ceil(log(m/n))) bits,
    * while providing O(1) access to any element stored in the list
+   *
+   * Each element x - min is split into its l = floor(log(m/n)) low bits,
+   * packed into lower, and its high bits h, stored as the (h + i)-th bit of
+   * upper for the i-th element. Upper bits are recovered via a DArray select,
+   * low bits via a single unaligned 64-bit load. Successor queries jump to
+   * the key's bucket via select0 on upper and only search its low bits.
+   *
+   * @tparam Container storage of both bitvectors and their select
+   *   directories. MappedArray yields a read-only list operating on a
+   *   mapped file, see deserialize()
    */
-   template<class T, class BitConverter = support::FixedBitConverter<T>>
+   template<class T, template<class> class Container = std::vector>
    class EliasFanoList {
-      sdsl::bit_vector lower{0};
-      sdsl::bit_vector upper{0};
-      typename decltype(upper)::select_1_type u_select{};
-      size_t l{}, n{};
-      T min;
+      Container<std::uint64_t> lower{};
+      Container<std::uint64_t> upper{};
+      DArray<true, 32, Container> upper_ones{};
+      /// the h-th zero bit in upper terminates bucket h, i.e., elements with high bits h
+      DArray<false, 128, Container> upper_zeros{};
+      size_t l = 0, n = 0;
+      std::uint64_t lower_mask = 0;
+      T min{};
+
+      /// low bits of the i-th element
+      forceinline std::uint64_t low(const size_t i) const {
+         const auto pos = l * i;
+
+         // l <= 56, i.e., low bits are contained in the 8 bytes starting at pos / 8.
+         // Lower is padded by one word s.t. this never reads out of bounds
+         if (likely(l <= 56)) {
+            std::uint64_t word;
+            std::memcpy(&word, reinterpret_cast<const std::uint8_t*>(lower.data()) + (pos >> 3), sizeof(word));
+            return (word >> (pos & 0x7)) & lower_mask;
+         }
+
+         const auto shift = pos & 0x3F;
+         // shifting twice avoids undefined behaviour for shift == 0
+         return ((lower[pos >> 6] >> shift) | ((lower[(pos >> 6) + 1] << 1) << (63 - shift))) & lower_mask;
+      }
 
      public:
+      /// read-only list operating on a mapped file, see deserialize()
+      using Mapped = EliasFanoList<T, MappedArray>;
+
       /**
        * Initializes an empty elias fano list
        */
@@ -32,141 +72,162 @@ namespace exotic_hashing::support {
        * Creates an Elias Fano list from an *already sorted* input range
        * of monotone (non-decreasing) integers [begin, end).
        *
-       * Implemented according to instructions from;
-       * https://www.antoniomallia.it/sorted-integers-compression-with-elias-fano-encoding.html
+       * Both bitvectors are written word wise, i.e., without bit by bit
+       * conversion of each element.
        */
       template<class ForwardIt>
       EliasFanoList(const ForwardIt& begin, const ForwardIt& end) {
-         // Gather general parameters
          n = std::distance(begin, end);
          if (n == 0)
             return;
 
-#if NDEBUG == 0
-         // check non-decreasing. Compiler should always eliminate this if assertions are turned of,
-         // however, never trust the compiler :)
-         for (auto it = begin + 1; it < end; it++)
-            assert(*it >= *(it - 1));
          assert(std::is_sorted(begin, end));
-#endif
-
-         min = *std::min_element(begin, end);
-         const auto max = *std::max_element(begin, end);
-         const T m = 1 + max - min;
-         constexpr const size_t t_bits = 8 * sizeof(T);
-         const size_t log_m = t_bits - clz(m);
-         const size_t u = t_bits - clz(n);
-         l = log_m - u;
-
-         // Initialize bitvectors
-         // each element contributes a single 1 bit (n)
-         // there are 2^u bucket, each of which contributes a single 0 bit (2^u == 0x1 << u)
-         upper = decltype(upper)(n + (0x1 << u), 0);
-         lower = decltype(lower)(n * l, 0);
-
-         // Initialize support variables
-         size_t upper_ind = 0, lower_ind = 0;
-         auto last_upper_bucket = 0x0LLU;
-         const BitConverter bc;
-
-         // Set bitvector values
-         for (auto it = begin; it < end; it++) {
-            const auto& elem = *it - min;
-            const auto bitstream = bc(elem);
-
-            // lower l bits go into lower stream
-            for (size_t i = t_bits - l; i < t_bits; i++) {
-               assert(lower_ind < lower.size());
-               lower[lower_ind++] = bitstream[i];
-            }
 
-            // upper u bits determine the upper bucket. Each bucket's element
-            // count is unary encoded
-            auto bucket_ind = 0x0LLU;
-            for (size_t i = t_bits - log_m; i < t_bits - l; i++)
-               bucket_ind = (bucket_ind << 1) | (bitstream[i] & 0x1);
-            upper_ind += bucket_ind - last_upper_bucket;
-            assert(upper_ind < upper.size());
-            last_upper_bucket = bucket_ind;
+         min = *begin;
+         // universe - 1, i.e., can not overflow
+         const auto max_offset = static_cast<std::uint64_t>(*std::prev(end) - min);
+         l = max_offset >= n ? 63 - clz(max_offset / n) : 0;
+         lower_mask = l == 0 ? 0x0 : (~0x0LLU >> (64 - l));
+
+         // one padding word, see low()
+         lower.assign((n * l + 63) / 64 + 1, 0x0);
+         // each element contributes a single 1 bit, each bucket a single 0 bit
+         const size_t upper_bits = n + (max_offset >> l) + 1;
+         upper.assign((upper_bits + 63) / 64, 0x0);
+
+         size_t i = 0;
+         for (auto it = begin; it != end; it++, i++) {
+            const auto x = static_cast<std::uint64_t>(*it - min);
+
+            if (l > 0) {
+               const auto pos = l * i;
+               const auto shift = pos & 0x3F;
+               const auto low_bits = x & lower_mask;
+               lower[pos >> 6] |= low_bits << shift;
+               if (shift + l > 64)
+                  lower[(pos >> 6) + 1] |= low_bits >> (64 - shift);
+            }
 
-            upper[upper_ind++] = 0x1;
+            const auto upper_pos = (x >> l) + i;
+            upper[upper_pos >> 6] |= 0x1LLU << (upper_pos & 0x3F);
          }
 
-         // Initialize select support
-         sdsl::util::init_support(u_select, &upper);
+         upper_ones = decltype(upper_ones)(upper.data(), upper_bits);
+         upper_zeros = decltype(upper_zeros)(upper.data(), upper_bits);
       }
 
-      T operator[](const size_t i) const {
-         assert(n > 0);
-
-         // upper bits == bucket index. Therefore count the amount of 0
-         // preceeding the i-th 1 bit
-         T res = u_select(i + 1) - i;
-
-         // append lower bits
-         const auto base_l_ind = l * i;
-         for (size_t j = 0; j < l; j++)
-            res = (res << 0x1) | (lower[base_l_ind + j] & 0x1);
-
-         return res + min;
+      static std::string name() {
+         return "EliasFano";
       }
 
-      size_t size() const {
-         return n;
-      }
+      forceinline T operator[](const size_t i) const {
+         assert(i < n);
 
-      size_t byte_size() const {
-         return sdsl::size_in_bytes(upper) + sdsl::size_in_bytes(lower) + sdsl::size_in_bytes(u_select) +
-            sizeof(decltype(l)) + sizeof(decltype(n)) + sizeof(decltype(min));
+         // upper bits == bucket index, i.e., amount of 0 bits preceding the i-th 1 bit
+         const auto high = upper_ones.select(upper.data(), i) - i;
+         return static_cast<T>(((static_cast<std::uint64_t>(high) << l) | low(i)) + min);
       }
 
-      /// Custom copy constructor is necessary since sdsl's select support contains a pointer to upper
-      EliasFanoList(const EliasFanoList& other) noexcept
-         : lower(other.lower), upper(other.upper), u_select(other.u_select), l(other.l), n(other.n), min(other.min) {
-         // reset vector as otherwise u_select contains broken pointer
-         u_select.set_vector(&upper);
-      }
+      /**
+       * decodes the count consecutive elements starting at index first into
+       * out. Only the first element requires a select, all others are read
+       * off the following one bits in upper, i.e., sequentially
+       */
+      forceinline void decode(const size_t first, const size_t count, T* out) const {
+         assert(first + count <= n);
+         if (count == 0)
+            return;
+
+         const auto pos = upper_ones.select(upper.data(), first);
+         size_t word_ind = pos >> 6;
+         auto word = upper[word_ind] & (~0x0LLU << (pos & 0x3F));
+         for (size_t j = 0, i = first; j < count; j++, i++) {
+            while (word == 0)
+               word = upper[++word_ind];
 
-      /// Custom copy constructor is necessary since sdsl's select support contains a pointer to upper
-      EliasFanoList(EliasFanoList&& other) noexcept
-         : lower(other.lower), upper(other.upper), u_select(other.u_select), l(other.l), n(other.n), min(other.min) {
-         // reset vector as otherwise u_select contains broken pointer
-         u_select.set_vector(&upper);
+            const auto high = 64 * word_ind + ctz(word) - i;
+            word &= word - 1;
+            out[j] = static_cast<T>(((static_cast<std::uint64_t>(high) << l) | low(i)) + min);
+         }
       }
 
-      /// Custom copy constructor is necessary since sdsl's select support contains a pointer to upper
-      EliasFanoList& operator=(const EliasFanoList& other) noexcept {
-         if (this != &other) {
-            lower = other.lower;
-            upper = other.upper;
-            u_select = other.u_select;
-            l = other.l;
-            n = other.n;
-            min = other.min;
-
-            // reset vector as otherwise u_select contains broken pointer
-            u_select.set_vector(&upper);
+      /**
+       * index of the first element >= key within [lo, hi), hi if there is
+       * none, i.e., equivalent to support::lower_bound(lo, hi, key, *this).
+       *
+       * Instead of binary searching via operator[], the key's bucket (all
+       * elements sharing its high bits) is located with two select0 queries.
+       * Only the bucket's low bits are searched afterwards
+       */
+      forceinline size_t lower_bound(const T& key, const size_t lo, const size_t hi) const {
+         assert(lo <= hi && hi <= n);
+
+         if (key <= min || lo == hi)
+            return lo;
+
+         const auto x = static_cast<std::uint64_t>(key - min);
+         const size_t h = x >> l;
+         // bucket index exceeds maximum, i.e., key > all elements
+         if (h >= upper_zeros.size())
+            return hi;
+
+         // [begin, end) are the indices of all elements in bucket h
+         const size_t begin = h == 0 ? 0 : upper_zeros.select(upper.data(), h - 1) - (h - 1);
+         const size_t end = upper_zeros.select(upper.data(), h) - h;
+
+         // elements before first are < key, element at last (if any) is >= key
+         size_t first = std::clamp(begin, lo, hi);
+         const size_t last = std::clamp(end, lo, hi);
+         const auto key_low = x & lower_mask;
+
+         // buckets hold less than two elements on average, but can grow arbitrarily large on clustered data
+         for (size_t count = last - first; count > 8;) {
+            const auto step = count / 2;
+            if (low(first + step) < key_low) {
+               first += step + 1;
+               count -= step + 1;
+            } else
+               count = step;
          }
+         while (first < last && low(first) < key_low)
+            first++;
+         return first;
+      }
 
-         return *this;
+      /// index of the first element >= key, size() if there is none
+      forceinline size_t lower_bound(const T& key) const {
+         return lower_bound(key, 0, n);
       }
 
-      /// Custom copy constructor is necessary since sdsl's select support contains a pointer to upper
-      EliasFanoList& operator=(EliasFanoList&& other) noexcept {
-         lower = other.lower;
-         upper = other.upper;
-         u_select = other.u_select;
-         l = other.l;
-         n = other.n;
-         min = other.min;
+      size_t size() const {
+         return n;
+      }
 
-         // reset vector as otherwise u_select contains broken pointer
-         u_select.set_vector(&upper);
+      size_t byte_size() const {
+         return sizeof(*this) + sizeof(std::uint64_t) * (lower.size() + upper.size()) + upper_ones.byte_size() -
+            sizeof(upper_ones) + upper_zeros.byte_size() - sizeof(upper_zeros);
+      }
 
-         return *this;
+      /// Writes this list, see support::Serializer
+      void serialize(Serializer& out) const {
+         out.write(std::array<std::uint64_t, 3>{l, n, lower_mask});
+         out.write(min);
+         out.write_array(lower.data(), lower.size());
+         out.write_array(upper.data(), upper.size());
+         upper_ones.serialize(out);
+         upper_zeros.serialize(out);
       }
 
-      // Destructing does not have to manually do anything
-      ~EliasFanoList() noexcept = default;
+      void deserialize(Deserializer& in) {
+         const auto params = in.read<std::array<std::uint64_t, 3>>();
+         l = params[0];
+         n = params[1];
+         lower_mask = params[2];
+         min = in.read<T>();
+         in.read_array(lower);
+         in.read_array(upper);
+         upper_ones.deserialize(in);
+         upper_zeros.deserialize(in);
+      }
    };
 } // namespace exotic_hashing::support
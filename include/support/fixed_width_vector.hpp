@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "serialization.hpp"
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /**
+    * Packed vector of unsigned integers with a compile time bit width.
+    * Contrary to sdsl::int_vector<>, extracting an element is a single
+    * unaligned 64-bit load followed by a constant shift & mask. Widths of
+    * 8, 16 and 32 bits degenerate to plain byte aligned arrays.
+    *
+    * With AVX2, four elements can be extracted at once via gather4().
+    *
+    * @tparam Bits width of each element. At most 57, s.t. every element
+    *   fits into an unaligned 64-bit word starting at its first byte
+    * @tparam Container byte storage. MappedArray yields a read-only vector
+    *   operating on a mapped file, see deserialize()
+    */
+   template<size_t Bits, template<class> class Container = std::vector>
+   class FixedWidthVector {
+      static_assert(Bits > 0 && Bits <= 57);
+
+      /// trailing padding s.t. unaligned 64-bit loads never exceed storage
+      static constexpr size_t padding = sizeof(std::uint64_t);
+
+      Container<std::uint8_t> bytes;
+      size_t n = 0;
+
+      forceinline std::uint64_t load(const size_t& byte) const {
+         std::uint64_t word;
+         std::memcpy(&word, bytes.data() + byte, sizeof(word));
+         return word;
+      }
+
+     public:
+      static constexpr size_t width = Bits;
+      static constexpr std::uint64_t max_value = (0x1LLU << Bits) - 1;
+
+      FixedWidthVector() = default;
+
+      explicit FixedWidthVector(const size_t& n) : bytes((n * Bits + 7) / 8 + padding, 0), n(n) {}
+
+      forceinline std::uint64_t operator[](const size_t& i) const {
+         assert(i < n);
+         const size_t bit = i * Bits;
+         return (load(bit >> 3) >> (bit & 0x7)) & max_value;
+      }
+
+      void set(const size_t& i, const std::uint64_t& value) {
+         assert(i < n);
+         assert(value <= max_value);
+
+         const size_t bit = i * Bits;
+         const size_t shift = bit & 0x7;
+         auto word = load(bit >> 3);
+         word &= ~(max_value << shift);
+         word |= value << shift;
+         std::memcpy(bytes.data() + (bit >> 3), &word, sizeof(word));
+      }
+
+      /// Prefetches the cache line containing (the first bit of) the i-th element
+      forceinline void prefetch(const size_t& i) const {
+         prefetchit(bytes.data() + ((i * Bits) >> 3), 0, 3);
+      }
+
+#ifdef __AVX2__
+      /// Extracts the elements at the four (64-bit) indices at once
+      forceinline __m256i gather4(const __m256i& indices) const {
+         const auto bits = _mm256_mul_epu32(indices, _mm256_set1_epi64x(Bits));
+         const auto offsets = _mm256_srli_epi64(bits, 3);
+         const auto shifts = _mm256_and_si256(bits, _mm256_set1_epi64x(0x7));
+         const auto words =
+            _mm256_i64gather_epi64(reinterpret_cast<const long long*>(bytes.data()), offsets, 1);
+         return _mm256_and_si256(_mm256_srlv_epi64(words, shifts),
+                                 _mm256_set1_epi64x(static_cast<long long>(max_value)));
+      }
+
+      /// gather4() multiplies 32-bit indices, i.e., requires all indices to be < 2^32
+      bool gatherable() const {
+         return n <= (static_cast<size_t>(0x1) << 32);
+      }
+#endif
+
+      size_t size() const {
+         return n;
+      }
+
+      size_t byte_size() const {
+         return sizeof(decltype(n)) + sizeof(decltype(bytes)) + bytes.size();
+      }
+
+      /// Writes this vector, including its padding, see support::Serializer
+      void serialize(Serializer& out) const {
+         out.write(static_cast<std::uint64_t>(n));
+         out.write_array(bytes.data(), bytes.size());
+      }
+
+      void deserialize(Deserializer& in) {
+         n = in.read<std::uint64_t>();
+         in.read_array(bytes);
+         if (bytes.size() != (n * Bits + 7) / 8 + padding)
+            throw std::runtime_error("Failed to load FixedWidthVector: corrupt byte array");
+      }
+   };
+} // namespace exotic_hashing::support
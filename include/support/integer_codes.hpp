@@ -0,0 +1,363 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "../convenience/builtins.hpp"
+#include "elias.hpp"
+#include "support.hpp"
+
+/**
+ * Integer codes complementing EliasGammaCoder and EliasDeltaCoder. All codes
+ * encode positive integers (excluding 0) and share the same interface, i.e.,
+ * are interchangeable wherever an IntEncoder template parameter is accepted:
+ *
+ *   static std::string name();
+ *   size_t bits(x) const;                      amount of bits encode(x) appends
+ *   void encode(x, stream) const;              appends the code to stream
+ *   T decode(stream, start) const;             advances start past the code
+ *
+ * Parameterized codes (GolombRiceCoder) additionally are constructible from
+ * a sample of the values to encode, which chooses their parameter, and
+ * expose it via parameter(). See fit_codes() for values depending on the
+ * codes themselves.
+ *
+ * Stateless codes may offer static decode_fields<Cnt>(stream, start), which
+ * decodes Cnt consecutive codes in a single call (see FieldDecoder).
+ */
+namespace exotic_hashing::support {
+   /**
+    * Golomb-Rice code with parameter k: q = (x-1) >> k in unary (q zero bits
+    * and a one bit) followed by the k low order bits of x-1. Optimal for
+    * geometrically distributed values, provided k matches their mean.
+    *
+    * Quotients of at least max_unary escape to max_unary zero bits followed
+    * by q - max_unary + 1 in elias gamma, i.e., codes of values far off the
+    * mean take O(log q) instead of O(q) bits and decoding them never scans
+    * more than max_unary zero bits before the gamma code
+    */
+   class GolombRiceCoder {
+      size_t k = 0;
+
+     public:
+      /// longest unary quotient, larger ones are elias gamma encoded
+      static constexpr size_t max_unary = 16;
+
+      GolombRiceCoder() = default;
+
+      explicit GolombRiceCoder(const size_t k) : k(k) {
+         assert(k < 64);
+      }
+
+      /**
+       * chooses k minimizing the total encoded size of the given values.
+       * The total size is convex in k, i.e., only k around log2(mean) are
+       * considered
+       */
+      explicit GolombRiceCoder(const std::vector<std::uint64_t>& values) {
+         if (values.empty())
+            return;
+
+         long double mean = 0;
+         for (const auto x : values)
+            mean += static_cast<long double>(x - 1) / values.size();
+         const size_t estimate = mean < 1 ? 0 : code_detail::log2(static_cast<std::uint64_t>(mean));
+
+         size_t best_bits = std::numeric_limits<size_t>::max();
+         for (size_t candidate = estimate < 2 ? 0 : estimate - 2; candidate <= std::min<size_t>(estimate + 2, 63);
+              candidate++) {
+            size_t total = 0;
+            for (const auto x : values)
+               total += GolombRiceCoder(candidate).bits(x);
+
+            if (total < best_bits) {
+               best_bits = total;
+               k = candidate;
+            }
+         }
+      }
+
+      static std::string name() {
+         return "GolombRice";
+      }
+
+      size_t parameter() const {
+         return k;
+      }
+
+      template<class T>
+      forceinline size_t bits(const T& x) const {
+         assert(x > 0);
+         const auto q = (static_cast<std::uint64_t>(x) - 1) >> k;
+         if (likely(q < max_unary))
+            return static_cast<size_t>(q) + 1 + k;
+         return max_unary + EliasGammaCoder::bits(q - max_unary + 1) + k;
+      }
+
+      template<class BitStream, class T>
+      forceinline void encode(const T& x, BitStream& stream) const {
+         assert(x > 0);
+         const auto v = static_cast<std::uint64_t>(x) - 1;
+
+         // 1. quotient in unary, escaping to elias gamma if too long
+         const auto q = v >> k;
+         if (likely(q < max_unary))
+            stream.append(static_cast<std::uint64_t>(0x1) << q, q + 1);
+         else {
+            stream.append(0x0, max_unary);
+            EliasGammaCoder::encode(q - max_unary + 1, stream);
+         }
+
+         // 2. remainder in binary
+         if (k > 0)
+            stream.append(v, k);
+      }
+
+      template<class T = std::uint64_t, class BitStream = Bitvector<>>
+      forceinline T decode(const BitStream& stream, size_t& start) const {
+         if constexpr (code_detail::Peekable<BitStream>) {
+            const std::uint64_t window = stream.peek(start);
+            const size_t q = ctz(window);
+
+            // entire code is contained in window and not escaped
+            if (likely(q < max_unary && q + 1 + k <= 64)) {
+               const auto r = code_detail::low_bits(window >> q >> 1, k);
+               start += q + 1 + k;
+               return static_cast<T>(((static_cast<std::uint64_t>(q) << k) | r) + 1);
+            }
+         }
+
+         // escaped quotients are followed by their own leading zeroes, i.e., count_zeroes exceeds max_unary
+         std::uint64_t q = stream.count_zeroes(start);
+         if (likely(q < max_unary))
+            start += q + 1;
+         else {
+            start += max_unary;
+            q = EliasGammaCoder::decode<std::uint64_t>(stream, start) + max_unary - 1;
+         }
+         const auto r = code_detail::read_bits(stream, start, k);
+         start += k;
+         return static_cast<T>(((q << k) | r) + 1);
+      }
+   };
+
+   /**
+    * Zeta code with shrinking factor K, see Boldi & Vigna, "Codes for the
+    * World Wide Web" (2005): for x in [2^(hK), 2^((h+1)K)), h + 1 in unary
+    * followed by x - 2^(hK) in minimal binary. Suited for power law
+    * distributed values. Zeta-1 is equivalent to elias gamma.
+    *
+    * Minimal binary codes are written such that the first (h+1)K - 1 bits
+    * read decide whether the final bit is part of the code, i.e., decoding
+    * remains prefix free despite the least significant bit first bitstreams.
+    *
+    * x must be less than 2^(64 - 64 % K)
+    */
+   template<size_t K = 3>
+   struct ZetaCoder {
+      static_assert(K > 0 && K < 64);
+
+      static std::string name() {
+         return "Zeta" + std::to_string(K);
+      }
+
+      template<class T>
+      static forceinline size_t bits(const T& x) {
+         const auto h = code_detail::log2(x) / K;
+         const auto lower = static_cast<std::uint64_t>(0x1) << (h * K);
+         // values below 2 * lower require one bit less
+         return h + (h + 1) * K + (static_cast<std::uint64_t>(x) - lower >= lower);
+      }
+
+      template<class BitStream, class T>
+      static forceinline void encode(const T& x, BitStream& stream) {
+         const auto h = code_detail::log2(x) / K;
+         const auto s = (h + 1) * K;
+         assert(s <= 64);
+
+         // 1. h + 1 in unary
+         stream.append(static_cast<std::uint64_t>(0x1) << h, h + 1);
+
+         // 2. x - lower in minimal binary over [0, 2^s - lower)
+         const auto lower = static_cast<std::uint64_t>(0x1) << (h * K);
+         const auto y = static_cast<std::uint64_t>(x) - lower;
+         if (y < lower) {
+            if (s > 1)
+               stream.append(y, s - 1);
+         } else {
+            const auto shifted = y + lower;
+            stream.append(shifted >> 1, s - 1);
+            stream.append(shifted & 0x1, 1);
+         }
+      }
+
+      template<class T = std::uint64_t, class BitStream = Bitvector<>>
+      static forceinline T decode(const BitStream& stream, size_t& start) {
+         size_t h;
+         std::uint64_t window = 0;
+         if constexpr (code_detail::Peekable<BitStream>) {
+            window = stream.peek(start);
+            h = ctz(window);
+         } else
+            h = stream.count_zeroes(start);
+
+         const auto s = (h + 1) * K;
+         const auto lower = static_cast<std::uint64_t>(0x1) << (h * K);
+
+         std::uint64_t v, last;
+         if (code_detail::Peekable<BitStream> && likely(h + 1 + s <= 64)) {
+            // entire code is contained in window
+            v = code_detail::low_bits(window >> h >> 1, s - 1);
+            last = (window >> (h + s)) & 0x1;
+         } else {
+            v = code_detail::read_bits(stream, start + h + 1, s - 1);
+            last = v < lower ? 0 : code_detail::read_bits(stream, start + h + s, 1);
+         }
+
+         if (v < lower) {
+            start += h + s;
+            return static_cast<T>(lower + v);
+         }
+         start += h + 1 + s;
+         return static_cast<T>(((v << 1) | last));
+      }
+   };
+
+   /**
+    * Variable length code consisting of UnitBits sized units, each holding
+    * UnitBits - 1 payload bits of x - 1 (least significant first) and a
+    * continuation flag in its most significant bit. UnitBits = 8 is the
+    * classic varint (LEB128) code, UnitBits = 4 the nibble code.
+    *
+    * Node fields share a single bitstream, i.e., units are not aligned to
+    * unit boundaries in the stream. Instead, all flags within a 64-bit window
+    * are located with a single tzcnt and the payload is gathered with PEXT
+    */
+   template<size_t UnitBits>
+   struct VariableUnitCoder {
+      static_assert(UnitBits >= 2 && 64 % UnitBits == 0);
+
+     private:
+      static constexpr size_t payload_bits = UnitBits - 1;
+      static constexpr std::uint64_t payload_mask = (0x1LLU << payload_bits) - 1;
+
+      /// mask with bit i set iff (i % UnitBits) is in pattern
+      static constexpr std::uint64_t repeat(const std::uint64_t pattern) {
+         std::uint64_t res = 0;
+         for (size_t i = 0; i < 64; i += UnitBits)
+            res |= pattern << i;
+         return res;
+      }
+      static constexpr std::uint64_t flag_bits = repeat(0x1LLU << payload_bits);
+      static constexpr std::uint64_t payload_bits_mask = repeat(payload_mask);
+
+     public:
+      static std::string name() {
+         return UnitBits == 8 ? "Varint" : UnitBits == 4 ? "Nibble" : "VariableUnit" + std::to_string(UnitBits);
+      }
+
+      template<class T>
+      static forceinline size_t bits(const T& x) {
+         assert(x > 0);
+         const auto width = static_cast<size_t>(std::bit_width(static_cast<std::uint64_t>(x) - 1));
+         return std::max<size_t>((width + payload_bits - 1) / payload_bits, 1) * UnitBits;
+      }
+
+      template<class BitStream, class T>
+      static forceinline void encode(const T& x, BitStream& stream) {
+         assert(x > 0);
+         auto v = static_cast<std::uint64_t>(x) - 1;
+         do {
+            auto unit = v & payload_mask;
+            v >>= payload_bits;
+            unit |= static_cast<std::uint64_t>(v != 0) << payload_bits;
+            stream.append(unit, UnitBits);
+         } while (v != 0);
+      }
+
+      template<class T = std::uint64_t, class BitStream = Bitvector<>>
+      static forceinline T decode(const BitStream& stream, size_t& start) {
+         if constexpr (code_detail::Peekable<BitStream>) {
+            const std::uint64_t window = stream.peek(start);
+            // cleared flag marks the last unit
+            const std::uint64_t stops = ~window & flag_bits;
+
+            // entire code is contained in window
+            if (likely(stops != 0)) {
+               // all bits up to and including the first stop flag
+               const auto used = stops ^ (stops - 1);
+               const size_t len = std::bit_width(used);
+               start += len;
+#ifdef __BMI2__
+               return static_cast<T>(_pext_u64(window, used & payload_bits_mask) + 1);
+#else
+               std::uint64_t v = 0;
+               for (size_t shift = 0, i = 0; i < len; shift += payload_bits, i += UnitBits)
+                  v |= ((window >> i) & payload_mask) << shift;
+               return static_cast<T>(v + 1);
+#endif
+            }
+         }
+
+         std::uint64_t v = 0;
+         for (size_t shift = 0;; shift += payload_bits) {
+            const auto unit = code_detail::read_bits(stream, start, UnitBits);
+            start += UnitBits;
+            v |= (unit & payload_mask) << shift;
+            if (!(unit >> payload_bits))
+               return static_cast<T>(v + 1);
+         }
+      }
+   };
+
+   /// whether IntEncoder decodes Cnt consecutive codes in a single static decode_fields<Cnt>() call
+   template<class IntEncoder, size_t Cnt, class BitStream = Bitvector<>>
+   concept FieldDecoder = std::is_empty_v<IntEncoder> && requires(const BitStream& stream, size_t& start) {
+      { IntEncoder::template decode_fields<Cnt>(stream, start) };
+   };
+
+   /**
+    * Fits one parameterized code per field to the values collect(fields)
+    * appends to fields. Values may depend on the codes passed to collect,
+    * e.g., encoded subtrie sizes: fields independent of the codes are fit
+    * in the first round, dependent ones are refit to values recomputed with
+    * the previous round's codes until no parameter changes anymore (at most
+    * MaxRounds rounds)
+    *
+    * @return fitted codes, default constructed for codes without parameter
+    */
+   template<class IntEncoder, size_t Cnt, size_t MaxRounds = 8, class CollectFn>
+   std::array<IntEncoder, Cnt> fit_codes(const CollectFn& collect) {
+      std::array<IntEncoder, Cnt> codes{};
+      if constexpr (std::is_constructible_v<IntEncoder, const std::vector<std::uint64_t>&>) {
+         for (size_t round = 0; round < MaxRounds; round++) {
+            std::array<std::vector<std::uint64_t>, Cnt> fields;
+            collect(codes, fields);
+
+            bool changed = false;
+            for (size_t i = 0; i < Cnt; i++) {
+               const IntEncoder fitted(fields[i]);
+               changed |= fitted.parameter() != codes[i].parameter();
+               codes[i] = fitted;
+            }
+            if (!changed)
+               break;
+         }
+      } else
+         UNUSED(collect);
+      return codes;
+   }
+
+   using VarintCoder = VariableUnitCoder<8>;
+   using NibbleCoder = VariableUnitCoder<4>;
+} // namespace exotic_hashing::support
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <sdsl/int_vector.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "serialization.hpp"
+#include "support.hpp"
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /**
+    * Vector of mostly nonzero unsigned integers where zeroes take only a
+    * single bit. Contrary to a bitvector + rank structure + separate value
+    * array (three dependent cache misses), every 512-bit block interleaves
+    *
+    *   [ occupancy bits | packed nonzero values | 32-bit spill rank sample ],
+    *
+    * i.e., accessing an element only touches its block's cache line. The
+    * amount of elements per block is chosen at construction such that the
+    * expected amount of nonzero values just fits into the block. The few
+    * values exceeding their block's capacity are spilled into a separate
+    * vector, located via the block's spill rank sample.
+    *
+    * @tparam Container block storage. MappedArray yields a read-only vector
+    *   operating on a mapped file, see deserialize()
+    */
+   template<template<class> class Container = std::vector>
+   class InterleavedCompactedVector {
+      static constexpr size_t block_bits = 512;
+      /// spill rank sample occupies the upper half of each block's last word
+      static constexpr size_t sample_bits = 32;
+      static constexpr size_t payload_bits = block_bits - sample_bits;
+
+      struct alignas(64) Block {
+         std::array<std::uint64_t, block_bits / 64> words{};
+      };
+
+      static constexpr bool mapped = std::is_same_v<Container<Block>, MappedArray<Block>>;
+
+      Container<Block> blocks;
+      std::conditional_t<mapped, PackedView, sdsl::int_vector<>> spill;
+
+      size_t n = 0;
+      /// elements per block
+      size_t block_size = 1;
+      /// floor((2^64 - 1) / block_size), see block_of()
+      std::uint64_t block_size_inv = 0;
+      /// nonzero values stored inside each block
+      size_t capacity = 0;
+      /// amount of words containing occupancy bits
+      size_t occupancy_words = 1;
+      size_t value_width = 1;
+      std::uint64_t value_mask = 0x1;
+
+      /// block & offset of element i, i.e., division by block_size via multiplication
+      forceinline std::pair<size_t, size_t> block_of(const size_t i) const {
+         size_t block = (static_cast<__uint128_t>(i) * block_size_inv) >> 64;
+         size_t offset = i - block * block_size;
+         // estimate is at most one too small
+         const bool correct = offset >= block_size;
+         block += correct;
+         offset -= correct * block_size;
+         return {block, offset};
+      }
+
+      /// len <= 64 bits starting at pos, never reading past the block's last word
+      static forceinline std::uint64_t get_bits(const Block& block, const size_t pos, const std::uint64_t mask) {
+         const auto i = pos >> 6;
+         const auto shift = pos & 0x3F;
+         const auto lo = block.words[i] >> shift;
+         // shifting twice avoids undefined behaviour for shift == 0
+         const auto hi = (block.words[i + (i + 1 < block.words.size())] << 1) << (63 - shift);
+         return (lo | hi) & mask;
+      }
+
+      static void set_bits(Block& block, const size_t pos, const size_t len, const std::uint64_t value) {
+         assert(pos + len <= block_bits);
+         for (size_t b = 0; b < len; b++) {
+            const auto bit = pos + b;
+            block.words[bit >> 6] |= ((value >> b) & 0x1) << (bit & 0x3F);
+         }
+      }
+
+      /**
+       * amount of set occupancy bits before offset. Blocks of at most 64
+       * elements (i.e., values of at least 8 bits) only require a single
+       * popcount. Otherwise all occupancy words are masked branch free,
+       * since offset is essentially random
+       */
+      forceinline size_t local_rank(const Block& block, const size_t offset) const {
+         if (occupancy_words == 1)
+            return __builtin_popcountll(block.words[0] & ((0x1LLU << offset) - 1));
+
+         size_t rank = 0;
+         for (size_t w = 0; w < occupancy_words; w++) {
+            // amount of bits of word w before offset, in [0, 64]
+            const auto bits =
+               static_cast<std::uint64_t>(std::clamp<std::int64_t>(static_cast<std::int64_t>(offset - 64 * w), 0, 64));
+            const auto mask = ((0x1LLU << (bits & 0x3F)) - 1) | (0x0LLU - (bits >> 6));
+            rank += __builtin_popcountll(block.words[w] & mask);
+         }
+         return rank;
+      }
+
+      static forceinline size_t spill_sample(const Block& block) {
+         return block.words.back() >> (64 - sample_bits);
+      }
+
+     public:
+      InterleavedCompactedVector() = default;
+
+      /**
+       * @param values arbitrary unsigned integers, ideally mostly nonzero
+       */
+      template<class Values>
+      explicit InterleavedCompactedVector(const Values& values) : n(values.size()) {
+         size_t nonzero = 0;
+         std::uint64_t max_value = 0;
+         for (const auto& v : values) {
+            nonzero += v != 0;
+            max_value = std::max(max_value, static_cast<std::uint64_t>(v));
+         }
+         value_width = std::max(static_cast<size_t>(64 - clz(max_value | 0x1)), static_cast<size_t>(1));
+         value_mask = value_width == 64 ? ~0x0LLU : (0x1LLU << value_width) - 1;
+
+         // largest block size s.t. the expected amount of nonzero values (at least one) fits
+         const long double density = n == 0 ? 1. : static_cast<long double>(nonzero) / n;
+         block_size = 1;
+         for (size_t b = payload_bits - value_width; b > 1; b--) {
+            if (static_cast<long double>((payload_bits - b) / value_width) >= density * b) {
+               block_size = b;
+               break;
+            }
+         }
+         capacity = (payload_bits - block_size) / value_width;
+         occupancy_words = (block_size + 63) / 64;
+         block_size_inv = ~0x0LLU / block_size;
+
+         const size_t block_cnt = (n + block_size - 1) / block_size;
+         blocks.assign(block_cnt, Block());
+
+         std::vector<std::uint64_t> spilled;
+         for (size_t b = 0; b < block_cnt; b++) {
+            auto& block = blocks[b];
+            if (spilled.size() > 0xFFFFFFFFLLU)
+               throw std::runtime_error("Failed to construct InterleavedCompactedVector: spill rank sample overflow");
+            block.words.back() = static_cast<std::uint64_t>(spilled.size()) << (64 - sample_bits);
+
+            size_t rank = 0;
+            for (size_t offset = 0; offset < block_size && b * block_size + offset < n; offset++) {
+               const auto v = static_cast<std::uint64_t>(values[b * block_size + offset]);
+               if (v == 0)
+                  continue;
+
+               set_bits(block, offset, 1, 1);
+               if (rank < capacity)
+                  set_bits(block, block_size + rank * value_width, value_width, v);
+               else
+                  spilled.push_back(v);
+               rank++;
+            }
+         }
+
+         spill = sdsl::int_vector<>(spilled.size(), 0, value_width);
+         for (size_t i = 0; i < spilled.size(); i++)
+            spill[i] = spilled[i];
+      }
+
+      forceinline std::uint64_t operator[](const size_t i) const {
+         assert(i < n);
+         const auto [b, offset] = block_of(i);
+         const auto& block = blocks[b];
+
+         // only the rare spilled values branch (bitwise and!), i.e., the unpredictable
+         // occupancy never stalls lookups of independent elements
+         const std::uint64_t occupied = (block.words[offset >> 6] >> (offset & 0x3F)) & 0x1;
+         const auto rank = local_rank(block, offset);
+         if (unlikely(occupied & (rank >= capacity)))
+            return spill[spill_sample(block) + rank - capacity];
+         return (0x0LLU - occupied) &
+            get_bits(block, block_size + std::min(rank, capacity - 1) * value_width, value_mask);
+      }
+
+      /// Prefetches the cache line containing the i-th element
+      forceinline void prefetch(const size_t i) const {
+         prefetchit(blocks.data() + block_of(i).first, 0, 3);
+      }
+
+      size_t size() const {
+         return n;
+      }
+
+      /// amount of elements per (cache line sized) block
+      size_t elements_per_block() const {
+         return block_size;
+      }
+
+      /// amount of nonzero values that did not fit into their block
+      size_t spilled() const {
+         return spill.size();
+      }
+
+      size_t byte_size() const {
+         if constexpr (mapped)
+            return sizeof(*this) + sizeof(Block) * blocks.size() + spill.byte_size();
+         else
+            return sizeof(*this) + sizeof(Block) * blocks.size() + sdsl::size_in_bytes(spill);
+      }
+
+      /// Writes this vector, see support::Serializer
+      void serialize(Serializer& out) const {
+         out.write(std::array<std::uint64_t, 7>{n, block_size, block_size_inv, capacity, occupancy_words, value_width,
+                                                value_mask});
+         out.write_array(blocks.data(), blocks.size());
+         out.write_packed(spill, value_width);
+      }
+
+      void deserialize(Deserializer& in) {
+         const auto params = in.read<std::array<std::uint64_t, 7>>();
+         n = params[0];
+         block_size = params[1];
+         block_size_inv = params[2];
+         capacity = params[3];
+         occupancy_words = params[4];
+         value_width = params[5];
+         value_mask = params[6];
+         in.read_array(blocks);
+
+         const auto spilled_values = in.read_packed();
+         if constexpr (mapped)
+            spill = spilled_values;
+         else {
+            spill = sdsl::int_vector<>(spilled_values.size(), 0, value_width);
+            for (size_t i = 0; i < spilled_values.size(); i++)
+               spill[i] = spilled_values[i];
+         }
+      }
+   };
+} // namespace exotic_hashing::support
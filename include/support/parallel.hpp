@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /**
+    * Resolves a requested thread count to the amount of worker threads
+    * actually used. 0 denotes 'use all hardware threads'
+    */
+   static forceinline size_t resolve_thread_count(const size_t& requested) {
+      if (requested > 0)
+         return requested;
+      return std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1));
+   }
+
+   /**
+    * Splits [begin, end) into at most thread_count consecutive chunks and
+    * invokes fn(chunk_begin, chunk_end, chunk_ind) for each chunk on its own
+    * thread. Chunk i always covers a range preceeding chunk i+1, i.e.,
+    * concatenating per chunk results in chunk order is deterministic.
+    *
+    * Ranges that are too small to amortize thread creation are processed
+    * on the calling thread as a single chunk.
+    *
+    * @return amount of chunks fn was invoked with
+    */
+   template<class Fn>
+   size_t parallel_for(const size_t begin, const size_t end, const size_t thread_count, const Fn& fn,
+                       const size_t min_chunk_size = 1 << 14) {
+      if (end <= begin)
+         return 0;
+
+      const size_t size = end - begin;
+      const size_t chunk_cnt = std::max(std::min(thread_count, size / std::max(min_chunk_size, 1UL)), 1UL);
+      if (chunk_cnt == 1) {
+         fn(begin, end, 0);
+         return 1;
+      }
+
+      const size_t chunk_size = (size + chunk_cnt - 1) / chunk_cnt;
+      std::vector<std::thread> threads;
+      threads.reserve(chunk_cnt - 1);
+      for (size_t c = 1; c < chunk_cnt; c++) {
+         const size_t from = std::min(begin + c * chunk_size, end);
+         const size_t to = std::min(from + chunk_size, end);
+         threads.emplace_back([&fn, from, to, c]() { fn(from, to, c); });
+      }
+
+      // calling thread processes first chunk itself
+      fn(begin, std::min(begin + chunk_size, end), 0);
+
+      for (auto& t : threads)
+         t.join();
+
+      return chunk_cnt;
+   }
+} // namespace exotic_hashing::support
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "elias_fano_list.hpp"
+#include "serialization.hpp"
+#include "support.hpp"
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /**
+    * Partitioned Elias Fano list, see Ottaviano & Venturini, "Partitioned
+    * Elias-Fano Indexes" (2014). Stores n *non decreasing* integers in chunks
+    * of ChunkSize consecutive elements. Each chunk is encoded relative to the
+    * preceding chunk's last element, using whichever encoding is smallest:
+    *  - run: consecutive integers, requires no bits at all
+    *  - bitmap: characteristic bitvector of the chunk's universe (only for
+    *    strictly increasing chunks)
+    *  - elias fano: as in EliasFanoList, based on the chunk's universe
+    *
+    * I.e., on clustered data each chunk only pays for its local density
+    * instead of the global universe's. Chunk endpoints are stored in a small
+    * top level EliasFanoList, each chunk's base, bit offset and encoding in
+    * a single record.
+    *
+    * Provides the same interface as EliasFanoList. Access is O(1), lower_bound
+    * locates the chunk via the endpoints and searches within the chunk only
+    *
+    * @tparam Container storage of the chunk records, bits and endpoints.
+    *   MappedArray yields a read-only list operating on a mapped file, see
+    *   deserialize()
+    */
+   template<class T, size_t ChunkSize = 128, template<class> class Container = std::vector>
+   class PartitionedEliasFanoList {
+      static_assert(ChunkSize > 0);
+
+      enum Encoding : std::uint8_t { Run, Bitmap, EliasFano };
+
+      /// everything required to decode a chunk, i.e., decoding touches a single record
+      struct Chunk {
+         /// all elements x in the chunk satisfy x >= base. Run chunks store their first element instead
+         T base;
+         /// position of the chunk's first bit in data
+         std::uint64_t offset : 56;
+         /// low bit count of elias fano chunks
+         std::uint64_t l : 6;
+         std::uint64_t encoding : 2;
+      };
+
+      /// last element of each chunk
+      EliasFanoList<T, Container> endpoints{};
+      Container<Chunk> chunks{};
+      /// all chunks, padded by one word
+      Container<std::uint64_t> data{};
+      size_t n = 0;
+
+      /// l for elias fano encoding size elements out of [0, universe]
+      static forceinline size_t low_bit_cnt(const std::uint64_t universe, const size_t size) {
+         return universe >= size ? 63 - clz(universe / size) : 0;
+      }
+
+      forceinline size_t chunk_size(const size_t c) const {
+         return std::min(ChunkSize, n - c * ChunkSize);
+      }
+
+      /// cnt <= 64 bits starting at pos
+      forceinline std::uint64_t read(const size_t pos, const size_t cnt) const {
+         const auto shift = pos & 0x3F;
+         // shifting twice avoids undefined behaviour for shift == 0
+         const auto word = (data[pos >> 6] >> shift) | ((data[(pos >> 6) + 1] << 1) << (63 - shift));
+         return cnt == 64 ? word : word & ((0x1LLU << cnt) - 1);
+      }
+
+      /// position of the (rank + 1)-th one (zero) bit after start, relative to start. Must exist within the chunk
+      template<bool Ones>
+      forceinline size_t select(const size_t start, size_t rank) const {
+         for (size_t pos = start;; pos += 64) {
+            auto word = read(pos, 64);
+            if constexpr (!Ones)
+               word = ~word;
+
+            const size_t cnt = __builtin_popcountll(word);
+            if (rank < cnt)
+               return pos - start + select64(word, rank);
+            rank -= cnt;
+         }
+      }
+
+      /// position of the first zero bit at or after pos
+      forceinline size_t next_zero(size_t pos) const {
+         for (;; pos += 64)
+            if (const auto word = ~read(pos, 64); word != 0)
+               return pos + ctz(word);
+      }
+
+      /// invokes fn(t, pos) for the position pos of each of the cnt one bits starting with the one at first
+      template<class Fn>
+      forceinline void for_each_one(size_t first, const size_t cnt, const Fn& fn) const {
+         size_t pos = first;
+         auto word = read(pos, 64);
+         for (size_t t = 0; t < cnt; t++) {
+            for (; word == 0; word = read(pos, 64))
+               pos += 64;
+
+            fn(t, pos + ctz(word));
+            word &= word - 1;
+         }
+      }
+
+      forceinline T access(const Chunk& chunk, const size_t size, const size_t j) const {
+         switch (chunk.encoding) {
+            case Encoding::Run:
+               return static_cast<T>(chunk.base + j);
+            case Encoding::Bitmap:
+               return static_cast<T>(chunk.base + select<true>(chunk.offset, j));
+            default:
+               const auto low = chunk.l == 0 ? 0 : read(chunk.offset + j * chunk.l, chunk.l);
+               const auto high = select<true>(chunk.offset + size * chunk.l, j) - j;
+               return static_cast<T>(chunk.base + ((static_cast<std::uint64_t>(high) << chunk.l) | low));
+         }
+      }
+
+      /// decodes the cnt consecutive elements starting with the chunk's j-th element into out
+      forceinline void decode(const Chunk& chunk, const size_t size, const size_t j, const size_t cnt, T* out) const {
+         switch (chunk.encoding) {
+            case Encoding::Run:
+               for (size_t t = 0; t < cnt; t++)
+                  out[t] = static_cast<T>(chunk.base + j + t);
+               break;
+            case Encoding::Bitmap:
+               for_each_one(chunk.offset + select<true>(chunk.offset, j), cnt, [&](const size_t t, const size_t pos) {
+                  out[t] = static_cast<T>(chunk.base + (pos - chunk.offset));
+               });
+               break;
+            default:
+               const auto upper = chunk.offset + size * chunk.l;
+               for_each_one(upper + select<true>(upper, j), cnt, [&](const size_t t, const size_t pos) {
+                  const auto low = chunk.l == 0 ? 0 : read(chunk.offset + (j + t) * chunk.l, chunk.l);
+                  const auto high = pos - upper - (j + t);
+                  out[t] = static_cast<T>(chunk.base + ((static_cast<std::uint64_t>(high) << chunk.l) | low));
+               });
+         }
+      }
+
+      /**
+       * index of the first element >= key within the chunk's [first, last),
+       * last if there is none. key must not exceed the chunk's last element
+       */
+      forceinline size_t chunk_lower_bound(const Chunk& chunk, const size_t size, const T& key, const size_t first,
+                                           const size_t last) const {
+         if (key <= chunk.base)
+            return first;
+
+         const auto y = static_cast<std::uint64_t>(key - chunk.base);
+         size_t res;
+         switch (chunk.encoding) {
+            case Encoding::Run:
+               res = static_cast<size_t>(y);
+               break;
+            case Encoding::Bitmap: {
+               // amount of elements < y, i.e., rank of y in the bitmap
+               res = 0;
+               size_t pos = chunk.offset;
+               for (const auto end = chunk.offset + y; pos + 64 <= end; pos += 64)
+                  res += __builtin_popcountll(read(pos, 64));
+               res += __builtin_popcountll(read(pos, chunk.offset + y - pos));
+               break;
+            }
+            default: {
+               // elements sharing y's high bits h are delimited by the (h-1)-th and h-th zero bit
+               const auto upper = chunk.offset + size * chunk.l;
+               const size_t h = y >> chunk.l;
+               const size_t bucket_begin = h == 0 ? 0 : select<false>(upper, h - 1) + 1;
+               const size_t bucket_end = next_zero(upper + bucket_begin) - upper - h;
+               res = bucket_begin - h;
+
+               const auto key_low = y & ((0x1LLU << chunk.l) - 1);
+               while (res < bucket_end &&
+                      (chunk.l == 0 ? 0 : read(chunk.offset + res * chunk.l, chunk.l)) < key_low)
+                  res++;
+               break;
+            }
+         }
+         return std::clamp(res, first, last);
+      }
+
+     public:
+      /// read-only list operating on a mapped file, see deserialize()
+      using Mapped = PartitionedEliasFanoList<T, ChunkSize, MappedArray>;
+
+      /**
+       * Initializes an empty partitioned elias fano list
+       */
+      PartitionedEliasFanoList() = default;
+
+      /**
+       * Creates a partitioned Elias Fano list from an *already sorted* input
+       * range of monotone (non-decreasing) integers [begin, end).
+       */
+      template<class ForwardIt>
+      PartitionedEliasFanoList(const ForwardIt& begin, const ForwardIt& end) {
+         n = std::distance(begin, end);
+         if (n == 0)
+            return;
+
+         assert(std::is_sorted(begin, end));
+
+         size_t bitcnt = 0;
+         const auto write = [&](const size_t pos, const std::uint64_t value, const size_t cnt) {
+            if (cnt == 0)
+               return;
+            if (data.size() < (pos + cnt + 63) / 64)
+               data.resize(std::max((pos + cnt + 63) / 64, 2 * data.size()), 0x0);
+
+            const auto shift = pos & 0x3F;
+            data[pos >> 6] |= value << shift;
+            if (shift + cnt > 64)
+               data[(pos >> 6) + 1] |= value >> (64 - shift);
+         };
+
+         std::vector<T> chunk_endpoints, elements;
+         T base = *begin;
+         for (auto it = begin; it != end;) {
+            elements.clear();
+            for (; it != end && elements.size() < ChunkSize; it++)
+               elements.push_back(*it);
+
+            const size_t size = elements.size();
+            const auto universe = static_cast<std::uint64_t>(elements.back() - base);
+
+            bool strictly_increasing = true, run = true;
+            for (size_t j = 1; j < size; j++) {
+               strictly_increasing &= elements[j - 1] < elements[j];
+               run &= elements[j - 1] + 1 == elements[j];
+            }
+
+            const size_t l = low_bit_cnt(universe, size);
+            const auto ef_bits = size * l + size + (universe >> l) + 1;
+
+            chunk_endpoints.push_back(elements.back());
+            Chunk chunk{};
+            chunk.base = base;
+            chunk.offset = bitcnt;
+            if (run) {
+               chunk.base = elements.front();
+               chunk.encoding = Encoding::Run;
+            } else if (strictly_increasing && universe < ef_bits - 1) {
+               chunk.encoding = Encoding::Bitmap;
+               for (const auto x : elements)
+                  write(bitcnt + static_cast<std::uint64_t>(x - base), 0x1, 1);
+               bitcnt += universe + 1;
+            } else {
+               chunk.l = l;
+               chunk.encoding = Encoding::EliasFano;
+               for (size_t j = 0; j < size; j++) {
+                  const auto y = static_cast<std::uint64_t>(elements[j] - base);
+                  if (l > 0)
+                     write(bitcnt + j * l, y & ((0x1LLU << l) - 1), l);
+                  write(bitcnt + size * l + (y >> l) + j, 0x1, 1);
+               }
+               bitcnt += ef_bits;
+            }
+            chunks.push_back(chunk);
+
+            base = elements.back();
+         }
+
+         // one padding word, see read()
+         data.resize((bitcnt + 63) / 64 + 1, 0x0);
+         data.shrink_to_fit();
+         chunks.shrink_to_fit();
+
+         endpoints = decltype(endpoints)(chunk_endpoints.begin(), chunk_endpoints.end());
+      }
+
+      static std::string name() {
+         return "PartitionedEliasFano";
+      }
+
+      forceinline T operator[](const size_t i) const {
+         assert(i < n);
+         const size_t c = i / ChunkSize;
+         return access(chunks[c], chunk_size(c), i % ChunkSize);
+      }
+
+      /**
+       * decodes the count consecutive elements starting at index first into
+       * out. Per chunk, only the first element requires a select, all others
+       * are read off the following one bits, i.e., sequentially
+       */
+      forceinline void decode(const size_t first, const size_t count, T* out) const {
+         assert(first + count <= n);
+         for (size_t i = first, j = 0; j < count;) {
+            const size_t c = i / ChunkSize, size = chunk_size(c);
+            const size_t cnt = std::min(size - i % ChunkSize, count - j);
+            decode(chunks[c], size, i % ChunkSize, cnt, out + j);
+            i += cnt;
+            j += cnt;
+         }
+      }
+
+      /**
+       * index of the first element >= key within [lo, hi), hi if there is
+       * none, i.e., equivalent to support::lower_bound(lo, hi, key, *this).
+       *
+       * The first chunk whose endpoint is >= key is found via the endpoints'
+       * lower_bound, afterwards only this chunk is searched
+       */
+      forceinline size_t lower_bound(const T& key, const size_t lo, const size_t hi) const {
+         assert(lo <= hi && hi <= n);
+         if (lo == hi)
+            return lo;
+
+         // chunks overlapping [lo, hi)
+         const size_t first_chunk = lo / ChunkSize, last_chunk = (hi - 1) / ChunkSize + 1;
+         const size_t c = endpoints.lower_bound(key, first_chunk, last_chunk);
+         if (c == last_chunk)
+            return hi;
+
+         const size_t chunk_begin = c * ChunkSize, size = chunk_size(c);
+         const size_t first = std::max(lo, chunk_begin) - chunk_begin;
+         const size_t last = std::min(hi, chunk_begin + size) - chunk_begin;
+         return chunk_begin + chunk_lower_bound(chunks[c], size, key, first, last);
+      }
+
+      /// index of the first element >= key, size() if there is none
+      forceinline size_t lower_bound(const T& key) const {
+         return lower_bound(key, 0, n);
+      }
+
+      size_t size() const {
+         return n;
+      }
+
+      size_t byte_size() const {
+         return sizeof(*this) + endpoints.byte_size() - sizeof(endpoints) + sizeof(Chunk) * chunks.size() +
+            sizeof(std::uint64_t) * data.size();
+      }
+
+      /// Writes this list, see support::Serializer
+      void serialize(Serializer& out) const {
+         out.write(static_cast<std::uint64_t>(n));
+         endpoints.serialize(out);
+         out.write_array(chunks.data(), chunks.size());
+         out.write_array(data.data(), data.size());
+      }
+
+      void deserialize(Deserializer& in) {
+         n = in.read<std::uint64_t>();
+         endpoints.deserialize(in);
+         in.read_array(chunks);
+         in.read_array(data);
+      }
+   };
+} // namespace exotic_hashing::support
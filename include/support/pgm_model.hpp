@@ -0,0 +1,367 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+#include "serialization.hpp"
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   namespace pgm_detail {
+      /**
+       * Streaming optimal piecewise linear approximation, see O'Rourke, "An
+       * on-line algorithm for fitting straight lines between data ranges"
+       * (1981) and Ferragina & Vinciguerra, "The PGM-index" (2020).
+       *
+       * Maintains the convex hulls of all points (x, y +- epsilon) added to
+       * the current segment. add() rejects a point iff no line is within
+       * epsilon of all points including it, i.e., segments are maximal.
+       * Afterwards, line() describes the finished segment until reset()
+       */
+      class OptimalPLA {
+         using Int = __int128;
+
+         struct Point {
+            Int x, y;
+         };
+
+         struct Slope {
+            Int dx, dy;
+
+            bool operator<(const Slope& other) const {
+               return dy * other.dx < other.dy * dx;
+            }
+            bool operator>(const Slope& other) const {
+               return dy * other.dx > other.dy * dx;
+            }
+         };
+
+         static Slope slope(const Point& a, const Point& b) {
+            return {a.x - b.x, a.y - b.y};
+         }
+
+         static Int cross(const Point& o, const Point& a, const Point& b) {
+            return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+         }
+
+         Int epsilon;
+         std::vector<Point> lower, upper;
+         size_t lower_start = 0, upper_start = 0, points = 0;
+         /// extreme feasible lines are rectangle[0] -> rectangle[2] (min slope) and rectangle[1] -> rectangle[3]
+         std::array<Point, 4> rectangle;
+
+        public:
+         explicit OptimalPLA(const size_t epsilon) : epsilon(static_cast<Int>(epsilon)) {}
+
+         /// starts a new segment
+         void reset() {
+            points = 0;
+         }
+
+         /// adds (x, y) to the current segment. x must be strictly greater than all previously added x
+         bool add(const std::uint64_t x, const std::uint64_t y) {
+            const Point p1{x, static_cast<Int>(y) + epsilon}, p2{x, static_cast<Int>(y) - epsilon};
+
+            if (points == 0) {
+               rectangle[0] = p1;
+               rectangle[1] = p2;
+               upper.assign({p1});
+               lower.assign({p2});
+               upper_start = lower_start = 0;
+               points++;
+               return true;
+            }
+
+            if (points == 1) {
+               rectangle[2] = p2;
+               rectangle[3] = p1;
+               upper.push_back(p1);
+               lower.push_back(p2);
+               points++;
+               return true;
+            }
+
+            const auto min_slope = slope(rectangle[2], rectangle[0]);
+            const auto max_slope = slope(rectangle[3], rectangle[1]);
+            if (slope(p1, rectangle[2]) < min_slope || slope(p2, rectangle[3]) > max_slope)
+               return false;
+
+            if (slope(p1, rectangle[1]) < max_slope) {
+               // new max slope line through the lower hull's tangent point
+               auto extreme = slope(lower[lower_start], p1);
+               auto extreme_i = lower_start;
+               for (auto i = lower_start + 1; i < lower.size(); i++) {
+                  const auto val = slope(lower[i], p1);
+                  if (val > extreme)
+                     break;
+                  extreme = val;
+                  extreme_i = i;
+               }
+               rectangle[1] = lower[extreme_i];
+               rectangle[3] = p1;
+               lower_start = extreme_i;
+
+               auto end = upper.size();
+               while (end >= upper_start + 2 && cross(upper[end - 2], upper[end - 1], p1) <= 0)
+                  end--;
+               upper.resize(end);
+               upper.push_back(p1);
+            }
+
+            if (slope(p2, rectangle[0]) > min_slope) {
+               // new min slope line through the upper hull's tangent point
+               auto extreme = slope(upper[upper_start], p2);
+               auto extreme_i = upper_start;
+               for (auto i = upper_start + 1; i < upper.size(); i++) {
+                  const auto val = slope(upper[i], p2);
+                  if (val < extreme)
+                     break;
+                  extreme = val;
+                  extreme_i = i;
+               }
+               rectangle[0] = upper[extreme_i];
+               rectangle[2] = p2;
+               upper_start = extreme_i;
+
+               auto end = lower.size();
+               while (end >= lower_start + 2 && cross(lower[end - 2], lower[end - 1], p2) >= 0)
+                  end--;
+               lower.resize(end);
+               lower.push_back(p2);
+            }
+
+            points++;
+            return true;
+         }
+
+         /**
+          * (slope, y at origin) of a line within epsilon of all points of the
+          * current segment: passes through the intersection of both extreme
+          * lines with their average slope
+          */
+         std::pair<long double, long double> line(const std::uint64_t origin) const {
+            assert(points > 0);
+            if (points == 1)
+               return {0, static_cast<long double>(rectangle[0].y + rectangle[1].y) / 2};
+
+            const auto min_slope = slope(rectangle[2], rectangle[0]);
+            const auto max_slope = slope(rectangle[3], rectangle[1]);
+            const auto min_s = static_cast<long double>(min_slope.dy) / static_cast<long double>(min_slope.dx);
+            const auto max_s = static_cast<long double>(max_slope.dy) / static_cast<long double>(max_slope.dx);
+
+            // intersection of rectangle[0] + t * min_slope and rectangle[1] + u * max_slope
+            long double ix = static_cast<long double>(rectangle[0].x), iy = static_cast<long double>(rectangle[0].y);
+            const auto denominator = min_slope.dx * max_slope.dy - min_slope.dy * max_slope.dx;
+            if (denominator != 0) {
+               const auto t = static_cast<long double>((rectangle[1].x - rectangle[0].x) * max_slope.dy -
+                                                       (rectangle[1].y - rectangle[0].y) * max_slope.dx) /
+                  static_cast<long double>(denominator);
+               ix += t * static_cast<long double>(min_slope.dx);
+               iy += t * static_cast<long double>(min_slope.dy);
+            }
+
+            const auto s = (min_s + max_s) / 2;
+            return {s, iy - (ix - static_cast<long double>(origin)) * s};
+         }
+      };
+   } // namespace pgm_detail
+
+   /**
+    * PGM-index style learned model, see Ferragina & Vinciguerra, "The
+    * PGM-index: a fully-dynamic compressed learned index with provable
+    * worst-case bounds" (2020). Usable wherever a learned_hashing model is
+    * accepted, e.g., as LearnedRank's Model.
+    *
+    * Training fits the minimal amount of linear segments such that each
+    * training key's rank is predicted within Epsilon in a single streaming
+    * pass. Segments are located via recursive levels of segments
+    * (EpsilonRecursive) over the segments' first keys, i.e., a prediction
+    * costs one small scan per level.
+    *
+    * In contrast to models without error guarantee, max_error() bounds the
+    * distance between any training key's prediction and its actual
+    * (scaled) position, see last_level_search::BinaryRangeLookup.
+    *
+    * The bottom level is segmented in parallel on ThreadCount threads (0
+    * uses all hardware threads), which does not affect the error bound
+    *
+    * @tparam Container storage of all segments. MappedArray yields a
+    *   read-only model operating on a mapped file, see deserialize()
+    */
+   template<class Data, size_t Epsilon = 32, size_t EpsilonRecursive = 4, size_t ThreadCount = 1,
+            template<class> class Container = std::vector>
+   class PGMModel {
+      static_assert(Epsilon > 0 && EpsilonRecursive > 0);
+
+      struct Segment {
+         Data key;
+         double slope, intercept;
+
+         forceinline double operator()(const Data& k) const {
+            // keys preceding the first segment's key must not wrap around
+            const auto dx = likely(k >= key) ? static_cast<double>(k - key) : -static_cast<double>(key - k);
+            return slope * dx + intercept;
+         }
+      };
+
+      /// all levels, starting at the bottom level which predicts output positions
+      Container<Segment> segments;
+      /// first segment of each level, followed by segments.size()
+      Container<size_t> level_offsets;
+      size_t max_output = 0, error = 0;
+
+      /// appends segments of (keys[i], (first_rank + i) * scale) for all keys in [begin, end) to out
+      template<class It>
+      static void segment(const It& begin, const It& end, const size_t first_rank, const size_t epsilon,
+                          const long double scale, std::vector<Segment>& out) {
+         pgm_detail::OptimalPLA pla(epsilon);
+
+         Data first_key = *begin;
+         auto emit = [&]() {
+            const auto [slope, intercept] = pla.line(static_cast<std::uint64_t>(first_key));
+            out.push_back({first_key, static_cast<double>(slope * scale), static_cast<double>(intercept * scale)});
+         };
+
+         size_t rank = first_rank;
+         std::uint64_t last_key = 0;
+         for (auto it = begin; it != end; it++, rank++) {
+            const auto key = static_cast<std::uint64_t>(*it);
+            // duplicates are predicted the first occurrence's position
+            if (rank > first_rank && key == last_key)
+               continue;
+            last_key = key;
+
+            if (!pla.add(key, rank)) {
+               emit();
+               first_key = *it;
+               pla.reset();
+               pla.add(key, rank);
+            }
+         }
+         emit();
+      }
+
+     public:
+      /// read-only model operating on a mapped file, see deserialize()
+      using Mapped = PGMModel<Data, Epsilon, EpsilonRecursive, ThreadCount, MappedArray>;
+
+      PGMModel() = default;
+
+      /**
+       * Trains on the *already sorted* keys [begin, end), mapping each key to
+       * its position scaled to [0, full_size), i.e., rank * full_size / n
+       */
+      template<class RandomIt>
+      void train(const RandomIt& begin, const RandomIt& end, const size_t full_size) {
+         segments.clear();
+         level_offsets.clear();
+
+         const size_t n = std::distance(begin, end);
+         max_output = full_size == 0 ? 0 : full_size - 1;
+         if (n == 0)
+            return;
+
+         const long double scale = static_cast<long double>(full_size) / static_cast<long double>(n);
+         // floating point rounding & flooring predictions may each contribute one additional position
+         error = static_cast<size_t>(Epsilon * scale) + 2;
+
+         // bottom level in parallel on consecutive chunks of keys, i.e., each chunk border may cost one additional
+         // segment. Duplicate keys are never split across chunks
+         const size_t threads = resolve_thread_count(ThreadCount);
+         std::vector<std::vector<Segment>> chunk_segments(threads);
+         parallel_for(0, n, threads, [&](size_t from, size_t to, const size_t chunk) {
+            const auto skip_duplicates = [&](size_t i) {
+               while (i > 0 && i < n && begin[i] == begin[i - 1])
+                  i++;
+               return i;
+            };
+            from = skip_duplicates(from);
+            to = skip_duplicates(to);
+            if (from < to)
+               segment(begin + from, begin + to, from, Epsilon, scale, chunk_segments[chunk]);
+         });
+
+         level_offsets.push_back(0);
+         for (const auto& cs : chunk_segments)
+            segments.insert(segments.end(), cs.begin(), cs.end());
+         while (segments.size() - level_offsets.back() > 1) {
+            const size_t level_begin = level_offsets.back(), level_end = segments.size();
+            std::vector<Data> keys;
+            for (size_t i = level_begin; i < level_end; i++)
+               keys.push_back(segments[i].key);
+
+            level_offsets.push_back(level_end);
+            segment(keys.begin(), keys.end(), 0, EpsilonRecursive, 1, segments);
+         }
+         level_offsets.push_back(segments.size());
+         segments.shrink_to_fit();
+      }
+
+      forceinline size_t operator()(const Data& key) const {
+         if (unlikely(segments.empty()))
+            return 0;
+
+         // top level consists of a single segment
+         size_t level = level_offsets.size() - 2;
+         size_t seg = level_offsets[level];
+         while (level > 0) {
+            const auto prediction = segments[seg](key);
+            level--;
+
+            // last segment of the next level whose first key is <= key
+            const size_t first = level_offsets[level], last = level_offsets[level + 1] - 1;
+            seg = first + static_cast<size_t>(std::clamp(prediction, 0.0, static_cast<double>(last - first)));
+            while (seg > first && segments[seg].key > key)
+               seg--;
+            while (seg < last && segments[seg + 1].key <= key)
+               seg++;
+         }
+
+         const auto prediction = segments[seg](key);
+         return static_cast<size_t>(std::clamp(prediction, 0.0, static_cast<double>(max_output)));
+      }
+
+      /// maximum distance between any training key's prediction and its actual position
+      size_t max_error() const {
+         return error;
+      }
+
+      /// amount of segments in the bottom level
+      size_t segment_count() const {
+         return level_offsets.empty() ? 0 : level_offsets[1];
+      }
+
+      size_t byte_size() const {
+         return sizeof(*this) + sizeof(Segment) * segments.size() + sizeof(size_t) * level_offsets.size();
+      }
+
+      static std::string name() {
+         return "PGM" + std::to_string(Epsilon);
+      }
+
+      /// Writes this model, see support::Serializer
+      void serialize(Serializer& out) const {
+         out.write(std::array<std::uint64_t, 2>{max_output, error});
+         out.write_array(segments.data(), segments.size());
+         out.write_array(level_offsets.data(), level_offsets.size());
+      }
+
+      void deserialize(Deserializer& in) {
+         const auto params = in.read<std::array<std::uint64_t, 2>>();
+         max_output = params[0];
+         error = params[1];
+         in.read_array(segments);
+         in.read_array(level_offsets);
+      }
+   };
+} // namespace exotic_hashing::support
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+#include "serialization.hpp"
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /**
+    * Monotone two level recursive model index (RMI), see Kraska et al., "The
+    * Case for Learned Index Structures" (2018). Usable wherever a
+    * learned_hashing model is accepted, e.g., as LearnedRank's Model.
+    *
+    * A linear root model distributes keys among up to SecondLevelSize linear
+    * second level models (leaves), each fit to its keys' positions via least
+    * squares. Leaf predictions are clamped to the positions between their
+    * first key and the next leaf's first key, i.e., the model is monotone.
+    *
+    * Construction is designed for large datasets:
+    *  - the root is fit on a stratified sample of SampleSize keys, i.e., the
+    *    middle key of each of SampleSize equally sized rank ranges. SampleSize
+    *    0 fits the root on all keys
+    *  - assigning keys to leaves and fitting the leaves is done in parallel on
+    *    ThreadCount threads (0 uses all hardware threads). Each leaf is fit on
+    *    all of its keys, i.e., the result does not depend on ThreadCount
+    *
+    * Like PGMModel, max_error() bounds the distance between any training
+    * key's prediction and its actual (scaled) position. It is measured while
+    * fitting the leaves, i.e., BinaryRangeLookup requires no additional pass
+    *
+    * @tparam Container storage of all leaves. MappedArray yields a read-only
+    *   model operating on a mapped file, see deserialize()
+    */
+   template<class Data, size_t SecondLevelSize = 1000000, size_t SampleSize = (1 << 16), size_t ThreadCount = 1,
+            template<class> class Container = std::vector>
+   class RMIModel {
+      static_assert(SecondLevelSize > 0);
+
+      struct Leaf {
+         /// first key assigned to this leaf. Predictions are based on the distance to it
+         Data base;
+         double slope, intercept;
+         /// lowest prediction of this leaf, i.e., the scaled position of its first key
+         double lo;
+
+         forceinline double operator()(const Data& k) const {
+            // keys preceding the first key must not wrap around
+            const auto dx = likely(k >= base) ? static_cast<double>(k - base) : -static_cast<double>(base - k);
+            return slope * dx + intercept;
+         }
+      };
+
+      double root_slope = 0, root_intercept = 0;
+      /// all leaves, followed by a sentinel whose lo bounds the last leaf's predictions
+      Container<Leaf> leaves;
+      size_t max_output = 0, error = 0;
+
+      /// leaf responsible for key. Monotone in key, i.e., each leaf is assigned a consecutive range of keys
+      forceinline size_t leaf_of(const Data& key) const {
+         const auto pred = root_slope * static_cast<double>(key) + root_intercept;
+         return static_cast<size_t>(std::clamp(pred, 0.0, static_cast<double>(leaves.size() - 2)));
+      }
+
+      /// least squares fit of y = slope * x + intercept on the first cnt points
+      template<class X, class Y>
+      static std::pair<long double, long double> fit(const size_t cnt, const X& x, const Y& y) {
+         long double mean_x = 0, mean_y = 0;
+         for (size_t i = 0; i < cnt; i++) {
+            mean_x += x(i);
+            mean_y += y(i);
+         }
+         mean_x /= cnt;
+         mean_y /= cnt;
+
+         long double cov = 0, var = 0;
+         for (size_t i = 0; i < cnt; i++) {
+            const auto dx = x(i) - mean_x;
+            cov += dx * (y(i) - mean_y);
+            var += dx * dx;
+         }
+
+         // sorted keys never yield a negative slope, except through rounding
+         const auto slope = var == 0 ? 0 : std::max(cov / var, 0.0L);
+         return {slope, mean_y - slope * mean_x};
+      }
+
+     public:
+      /// read-only model operating on a mapped file, see deserialize()
+      using Mapped = RMIModel<Data, SecondLevelSize, SampleSize, ThreadCount, MappedArray>;
+
+      RMIModel() = default;
+
+      /**
+       * Trains on the *already sorted* keys [begin, end), mapping each key to
+       * its position scaled to [0, full_size), i.e., rank * full_size / n
+       */
+      template<class RandomIt>
+      void train(const RandomIt& begin, const RandomIt& end, const size_t full_size) {
+         leaves.clear();
+         error = 0;
+
+         const size_t n = std::distance(begin, end);
+         max_output = full_size == 0 ? 0 : full_size - 1;
+         if (n == 0)
+            return;
+
+         const size_t leaf_cnt = std::min(SecondLevelSize, n);
+         const size_t threads = resolve_thread_count(ThreadCount);
+         const long double scale = static_cast<long double>(full_size) / static_cast<long double>(n);
+
+         // 1. root on stratified sample, mapping rank i to leaf i * leaf_cnt / n
+         const size_t sample_cnt = SampleSize == 0 ? n : std::min(SampleSize, n);
+         const auto sample_rank = [&](const size_t s) {
+            return s * n / sample_cnt + (n / sample_cnt) / 2;
+         };
+         const auto [slope, intercept] = fit(
+            sample_cnt, [&](const size_t s) { return static_cast<long double>(begin[sample_rank(s)]); },
+            [&](const size_t s) {
+               return static_cast<long double>(sample_rank(s)) * leaf_cnt / static_cast<long double>(n);
+            });
+         root_slope = static_cast<double>(slope);
+         root_intercept = static_cast<double>(intercept);
+
+         // 2. first key of each leaf. Leaf boundaries of different chunks never overlap since leaf_of is monotone
+         leaves.resize(leaf_cnt + 1);
+         std::vector<size_t> first(leaf_cnt + 1, n);
+         parallel_for(0, n, threads, [&](const size_t from, const size_t to, const size_t) {
+            size_t prev = from == 0 ? 0 : leaf_of(begin[from - 1]) + 1;
+            for (size_t i = from; i < to; i++) {
+               const auto leaf = leaf_of(begin[i]);
+               for (; prev <= leaf; prev++)
+                  first[prev] = i;
+            }
+         });
+
+         // 3. leaves, each fit on all of its keys
+         std::vector<long double> chunk_errors(threads, 0);
+         parallel_for(
+            0, leaf_cnt, threads,
+            [&](const size_t from, const size_t to, const size_t chunk) {
+               for (size_t l = from; l < to; l++) {
+                  auto& leaf = leaves[l];
+                  const size_t a = first[l], cnt = first[l + 1] - a;
+                  leaf.base = begin[std::min(a, n - 1)];
+                  leaf.lo = static_cast<double>(a * scale);
+                  if (cnt == 0) {
+                     leaf.slope = 0;
+                     leaf.intercept = leaf.lo;
+                     continue;
+                  }
+
+                  const auto [s, i] = fit(
+                     cnt, [&](const size_t j) { return static_cast<long double>(begin[a + j] - leaf.base); },
+                     [&](const size_t j) { return (a + j) * scale; });
+                  leaf.slope = static_cast<double>(s);
+                  leaf.intercept = static_cast<double>(i);
+
+                  const auto hi = static_cast<double>((a + cnt) * scale);
+                  for (size_t j = 0; j < cnt; j++) {
+                     const auto pred = std::clamp(leaf(begin[a + j]), leaf.lo, hi);
+                     chunk_errors[chunk] = std::max(chunk_errors[chunk], std::abs(pred - (a + j) * scale));
+                  }
+               }
+            },
+            1 << 10);
+         leaves[leaf_cnt] = {begin[n - 1], 0, 0, static_cast<double>(full_size)};
+
+         // flooring predictions and rounding may each contribute one additional position
+         error = static_cast<size_t>(std::ceil(*std::max_element(chunk_errors.begin(), chunk_errors.end()))) + 2;
+      }
+
+      forceinline size_t operator()(const Data& key) const {
+         if (unlikely(leaves.empty()))
+            return 0;
+
+         const auto leaf = leaf_of(key);
+         const auto prediction = std::clamp(leaves[leaf](key), leaves[leaf].lo, leaves[leaf + 1].lo);
+         return std::min(static_cast<size_t>(prediction), max_output);
+      }
+
+      /// maximum distance between any training key's prediction and its actual position
+      size_t max_error() const {
+         return error;
+      }
+
+      size_t byte_size() const {
+         return sizeof(*this) + sizeof(Leaf) * leaves.size();
+      }
+
+      static std::string name() {
+         return "RMI" + std::to_string(SecondLevelSize);
+      }
+
+      /// Writes this model, see support::Serializer
+      void serialize(Serializer& out) const {
+         out.write(std::array<double, 2>{root_slope, root_intercept});
+         out.write(std::array<std::uint64_t, 2>{max_output, error});
+         out.write_array(leaves.data(), leaves.size());
+      }
+
+      void deserialize(Deserializer& in) {
+         const auto root = in.read<std::array<double, 2>>();
+         root_slope = root[0];
+         root_intercept = root[1];
+         const auto params = in.read<std::array<std::uint64_t, 2>>();
+         max_output = params[0];
+         error = params[1];
+         in.read_array(leaves);
+      }
+   };
+} // namespace exotic_hashing::support
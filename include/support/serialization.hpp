@@ -0,0 +1,352 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /**
+    * On-disk format shared by all serializable structures:
+    *
+    *   [ 64 byte header | section | section | ... ]
+    *
+    * The header identifies the format version and the serialized type.
+    * Each section is either a single trivially copyable value or an array
+    * (prefixed by its length) and starts at a 64 byte aligned file offset.
+    * Since mappings are page aligned, arrays of a mapped file are cache line
+    * aligned in memory, i.e., the structures' View types operate on them in
+    * place without any deserialization.
+    *
+    * Files are neither portable across endianness nor across compilers (type
+    * signatures are derived from implementation defined typeid names).
+    */
+   static constexpr std::uint32_t serialization_version = 1;
+   static constexpr size_t serialization_alignment = 64;
+   static constexpr std::array<char, 8> serialization_magic{'E', 'X', 'O', 'H', 'A', 'S', 'H', '\0'};
+
+   struct SerializationHeader {
+      std::array<char, 8> magic;
+      std::uint32_t version;
+      std::uint32_t alignment;
+      /// distinguishes template instantiations sharing the same name()
+      std::uint64_t signature;
+      /// name() of the serialized type, zero padded
+      std::array<char, 40> type;
+   };
+   static_assert(sizeof(SerializationHeader) == serialization_alignment);
+
+   /// FNV-1a hash of T's type name
+   template<class T>
+   std::uint64_t type_signature() {
+      std::uint64_t h = 0xcbf29ce484222325LLU;
+      for (const char* c = typeid(T).name(); *c != '\0'; c++)
+         h = (h ^ static_cast<unsigned char>(*c)) * 0x100000001b3LLU;
+      return h;
+   }
+
+   /**
+    * Read-only array of a mapped file. Support containers accept it as their
+    * Container template parameter, e.g., Bitvector<std::uint64_t, MappedArray>,
+    * to operate on deserialized sections in place (see their deserialize())
+    */
+   template<class T>
+   using MappedArray = std::span<const T>;
+
+   /// read-only counterpart of Container, i.e., MappedArray for std::vector and Container::Mapped otherwise
+   template<class Container>
+   struct mapped {
+      using type = typename Container::Mapped;
+   };
+
+   template<class T>
+   struct mapped<std::vector<T>> {
+      using type = MappedArray<T>;
+   };
+
+   template<class Container>
+   using mapped_t = typename mapped<Container>::type;
+
+   /**
+    * Read-only view on a bit packed array of unsigned integers, see
+    * Serializer::write_packed(). The packed words are followed by a padding
+    * word, i.e., every element is extracted from two words without branching
+    */
+   class PackedView {
+      const std::uint64_t* words = nullptr;
+      size_t n = 0;
+      size_t width = 1;
+      std::uint64_t mask = 0x1;
+
+     public:
+      PackedView() = default;
+      PackedView(const std::uint64_t* words, const size_t n, const size_t width)
+         : words(words), n(n), width(width), mask(width == 64 ? ~0x0LLU : (0x1LLU << width) - 1) {}
+
+      forceinline std::uint64_t operator[](const size_t i) const {
+         const auto pos = i * width;
+         const auto shift = pos & 0x3F;
+         // shifting twice avoids undefined behaviour for shift == 0
+         return ((words[pos >> 6] >> shift) | ((words[(pos >> 6) + 1] << 1) << (63 - shift))) & mask;
+      }
+
+      /// Prefetches the cache line containing (the first bit of) the i-th element
+      forceinline void prefetch(const size_t i) const {
+         prefetchit(words + ((i * width) >> 6), 0, 3);
+      }
+
+      size_t size() const {
+         return n;
+      }
+
+      size_t byte_size() const {
+         return sizeof(*this) + sizeof(std::uint64_t) * ((n * width + 63) / 64 + 1);
+      }
+   };
+
+   /// Writes a file in the format described above, see each structure's save()
+   class Serializer {
+      std::ofstream out;
+      std::string path;
+      size_t offset = 0;
+
+      void write_bytes(const void* data, const size_t bytes) {
+         out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+         if (!out)
+            throw std::runtime_error("Failed to save " + path + ": write error");
+         offset += bytes;
+      }
+
+      void align() {
+         static constexpr std::array<char, serialization_alignment> zeroes{};
+         write_bytes(zeroes.data(), (serialization_alignment - offset % serialization_alignment) %
+                        serialization_alignment);
+      }
+
+     public:
+      /**
+       * @param type name() of the serialized structure
+       * @param signature type_signature() of the serialized structure
+       */
+      Serializer(const std::string& path, const std::string& type, const std::uint64_t signature)
+         : out(path, std::ios::binary | std::ios::trunc), path(path) {
+         if (!out)
+            throw std::runtime_error("Failed to save " + path + ": can not open file for writing");
+
+         SerializationHeader header{};
+         header.magic = serialization_magic;
+         header.version = serialization_version;
+         header.alignment = serialization_alignment;
+         header.signature = signature;
+         std::copy_n(type.begin(), std::min(type.size(), header.type.size() - 1), header.type.begin());
+         write_bytes(&header, sizeof(header));
+      }
+
+      template<class T>
+      void write(const T& value) {
+         static_assert(std::is_trivially_copyable_v<T>);
+         align();
+         write_bytes(&value, sizeof(T));
+      }
+
+      template<class T>
+      void write_array(const T* data, const size_t n) {
+         static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= serialization_alignment);
+         write(static_cast<std::uint64_t>(n));
+         align();
+         write_bytes(data, sizeof(T) * n);
+      }
+
+      /// Bit packs values[i] into width bits each, i.e., values must support size() and operator[]
+      template<class Values>
+      void write_packed(const Values& values, const size_t width) {
+         if (width == 0 || width > 64)
+            throw std::runtime_error("Failed to save " + path + ": invalid packed width " + std::to_string(width));
+
+         const size_t n = values.size();
+         write(static_cast<std::uint64_t>(n));
+         write(static_cast<std::uint64_t>(width));
+         write(static_cast<std::uint64_t>((n * width + 63) / 64 + 1));
+         align();
+
+         const std::uint64_t mask = width == 64 ? ~0x0LLU : (0x1LLU << width) - 1;
+         std::uint64_t word = 0;
+         size_t filled = 0;
+         for (size_t i = 0; i < n; i++) {
+            const auto v = static_cast<std::uint64_t>(values[i]) & mask;
+            word |= v << filled;
+            filled += width;
+            if (filled >= 64) {
+               write_bytes(&word, sizeof(word));
+               filled -= 64;
+               // remaining upper bits of v, if any
+               word = filled == 0 ? 0 : v >> (width - filled);
+            }
+         }
+         if (filled > 0)
+            write_bytes(&word, sizeof(word));
+
+         // padding word
+         word = 0;
+         write_bytes(&word, sizeof(word));
+      }
+
+      /// Flushes the file. Must be called once all sections are written
+      void finish() {
+         out.flush();
+         if (!out)
+            throw std::runtime_error("Failed to save " + path + ": write error");
+         out.close();
+      }
+   };
+
+   /// Read-only memory mapping of an entire file, unmapped on destruction
+   class MappedFile {
+      const std::byte* bytes = nullptr;
+      size_t length = 0;
+
+     public:
+      /// empty mapping, e.g., of Views nested in another structure's View
+      MappedFile() = default;
+
+      explicit MappedFile(const std::string& path) {
+         const int fd = ::open(path.c_str(), O_RDONLY);
+         if (fd < 0)
+            throw std::runtime_error("Failed to map " + path + ": " + std::strerror(errno));
+
+         struct stat st {};
+         if (::fstat(fd, &st) != 0) {
+            const auto error = errno;
+            ::close(fd);
+            throw std::runtime_error("Failed to map " + path + ": " + std::strerror(error));
+         }
+         length = static_cast<size_t>(st.st_size);
+
+         if (length > 0) {
+            void* addr = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            const auto error = errno;
+            ::close(fd);
+            if (addr == MAP_FAILED)
+               throw std::runtime_error("Failed to map " + path + ": " + std::strerror(error));
+            bytes = static_cast<const std::byte*>(addr);
+         } else
+            ::close(fd);
+      }
+
+      ~MappedFile() {
+         if (bytes != nullptr)
+            ::munmap(const_cast<std::byte*>(bytes), length);
+      }
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      /// the mapping itself never moves, i.e., pointers into it remain valid
+      MappedFile(MappedFile&& other) noexcept
+         : bytes(std::exchange(other.bytes, nullptr)), length(std::exchange(other.length, 0)) {}
+      MappedFile& operator=(MappedFile&& other) noexcept {
+         std::swap(bytes, other.bytes);
+         std::swap(length, other.length);
+         return *this;
+      }
+
+      const std::byte* data() const {
+         return bytes;
+      }
+
+      size_t size() const {
+         return length;
+      }
+   };
+
+   /**
+    * Reads sections of a mapped file in the order they were written. Arrays
+    * are returned as views into the mapping, i.e., are only valid as long as
+    * the MappedFile is
+    */
+   class Deserializer {
+      const MappedFile& file;
+      std::string type;
+      size_t offset = 0;
+
+      const std::byte* take(const size_t bytes) {
+         offset = (offset + serialization_alignment - 1) / serialization_alignment * serialization_alignment;
+         if (offset > file.size() || bytes > file.size() - offset)
+            throw std::runtime_error("Failed to load " + type + ": file truncated");
+         const auto* data = file.data() + offset;
+         offset += bytes;
+         return data;
+      }
+
+     public:
+      /**
+       * @param type name() of the expected structure
+       * @param signature type_signature() of the expected structure
+       */
+      Deserializer(const MappedFile& file, const std::string& type, const std::uint64_t signature)
+         : file(file), type(type) {
+         const auto header = read<SerializationHeader>();
+         if (header.magic != serialization_magic)
+            throw std::runtime_error("Failed to load " + type + ": not an exotic_hashing file");
+         if (header.version != serialization_version)
+            throw std::runtime_error("Failed to load " + type + ": unsupported format version " +
+                                     std::to_string(header.version));
+         if (header.alignment != serialization_alignment || header.signature != signature)
+            throw std::runtime_error("Failed to load " + type + ": file contains " +
+                                     std::string(header.type.data(), strnlen(header.type.data(), header.type.size())));
+      }
+
+      template<class T>
+      T read() {
+         static_assert(std::is_trivially_copyable_v<T>);
+         T value;
+         std::memcpy(&value, take(sizeof(T)), sizeof(T));
+         return value;
+      }
+
+      template<class T>
+      std::span<const T> read_array() {
+         static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= serialization_alignment);
+         const auto n = read<std::uint64_t>();
+         if (n > file.size() / sizeof(T))
+            throw std::runtime_error("Failed to load " + type + ": file truncated");
+         return {reinterpret_cast<const T*>(take(sizeof(T) * n)), static_cast<size_t>(n)};
+      }
+
+      /// Reads an array section into array, i.e., copies it unless Array is a MappedArray
+      template<class Array>
+      void read_array(Array& array) {
+         const auto section = read_array<std::remove_cvref_t<decltype(*array.data())>>();
+         array = Array(section.begin(), section.end());
+      }
+
+      PackedView read_packed() {
+         const auto n = read<std::uint64_t>();
+         const auto width = read<std::uint64_t>();
+         const auto words = read<std::uint64_t>();
+         if (width == 0 || width > 64 || words != (n * width + 63) / 64 + 1)
+            throw std::runtime_error("Failed to load " + type + ": corrupt packed array");
+         if (words > file.size() / sizeof(std::uint64_t))
+            throw std::runtime_error("Failed to load " + type + ": file truncated");
+         return {reinterpret_cast<const std::uint64_t*>(take(sizeof(std::uint64_t) * words)), static_cast<size_t>(n),
+                 static_cast<size_t>(width)};
+      }
+   };
+} // namespace exotic_hashing::support
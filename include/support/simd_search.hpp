@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <immintrin.h>
+
+#include "support.hpp"
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /// amount of keys compared at once, i.e., one cache line
+   template<class Key>
+   inline constexpr size_t simd_block = 64 / sizeof(Key);
+
+   /// whether dataset decodes consecutive elements at once, e.g., support::EliasFanoList
+   template<class Dataset, class Data>
+   concept BlockDecode = requires(const Dataset& dataset, size_t i, Data* out) {
+      { dataset.decode(i, i, out) };
+   };
+
+   /// whether dataset stores its elements in a contiguous array, e.g., std::vector
+   template<class Dataset, class Data>
+   concept Contiguous = requires(const Dataset& dataset) {
+      { dataset.data() } -> std::convertible_to<const Data*>;
+   };
+
+   /**
+    * amount of keys less than key among the simd_block<Key> keys starting at
+    * keys, which need not be aligned. All keys are compared at once and
+    * branch free (AVX-512 or AVX2 for 64-bit integer keys)
+    */
+   template<class Key>
+   forceinline size_t simd_rank(const Key* keys, const Key& key) {
+      static_assert(std::is_integral_v<Key> && 64 % sizeof(Key) == 0);
+
+      if constexpr (sizeof(Key) == 8) {
+#ifdef __AVX512F__
+         const auto block = _mm512_loadu_si512(keys);
+         const auto searched = _mm512_set1_epi64(static_cast<long long>(key));
+         if constexpr (std::is_unsigned_v<Key>)
+            return __builtin_popcount(_mm512_cmplt_epu64_mask(block, searched));
+         else
+            return __builtin_popcount(_mm512_cmplt_epi64_mask(block, searched));
+#elif defined(__AVX2__)
+         // AVX2 only offers signed comparisons, i.e., unsigned keys are flipped into signed order
+         const auto flip = _mm256_set1_epi64x(std::is_unsigned_v<Key> ? std::numeric_limits<long long>::min() : 0);
+         const auto searched = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(key)), flip);
+         const auto lo = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys)), flip);
+         const auto hi = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + 4)), flip);
+         const auto less = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(searched, lo))) |
+            (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(searched, hi))) << 4);
+         return __builtin_popcount(less);
+#endif
+      }
+
+      // branch free, i.e., vectorized by the compiler
+      size_t res = 0;
+      for (size_t i = 0; i < simd_block<Key>; i++)
+         res += keys[i] < key;
+      return res;
+   }
+
+   /**
+    * pointer to the count <= simd_block<Key> consecutive elements starting at
+    * index first. Contiguous datasets are accessed in place, all others are
+    * decoded into buffer
+    */
+   template<class Dataset, class Key>
+   forceinline const Key* load_block(const Dataset& dataset, const size_t first, const size_t count, Key* buffer) {
+      if constexpr (Contiguous<Dataset, Key>) {
+         UNUSED(count);
+         UNUSED(buffer);
+         return dataset.data() + first;
+      } else if constexpr (BlockDecode<Dataset, Key>) {
+         dataset.decode(first, count, buffer);
+         return buffer;
+      } else {
+         for (size_t j = 0; j < count; j++)
+            buffer[j] = dataset[first + j];
+         return buffer;
+      }
+   }
+
+   /// amount of elements less than key within [first, first + count), count <= simd_block<Key>
+   template<class Dataset, class Key>
+   forceinline size_t block_rank(const Dataset& dataset, const size_t first, const size_t count, const Key& key) {
+      Key buffer[simd_block<Key>];
+      const auto keys = load_block(dataset, first, count, buffer);
+      if (likely(count == simd_block<Key>))
+         return simd_rank(keys, key);
+
+      size_t res = 0;
+      for (size_t j = 0; j < count; j++)
+         res += keys[j] < key;
+      return res;
+   }
+
+   /**
+    * index of the first element >= key within [lo, end), assuming the
+    * result is at most end. Linearly scans up to max_blocks blocks of
+    * simd_block<Key> elements backwards from end, binary searches the rest
+    */
+   template<class Dataset, class Key>
+   forceinline size_t simd_lower_bound_backwards(const Dataset& dataset, const size_t lo, size_t end, const Key& key,
+                                                 const size_t max_blocks) {
+      constexpr size_t block = simd_block<Key>;
+      for (size_t blocks = 0; end > lo; blocks++) {
+         if (unlikely(blocks == max_blocks))
+            return support::lower_bound(lo, end, key, dataset);
+
+         const auto count = std::min(block, end - lo);
+         const auto rank = block_rank(dataset, end - count, count, key);
+         if (rank > 0)
+            return end - count + rank;
+         end -= count;
+      }
+      return lo;
+   }
+
+   /**
+    * index of the first element >= key within [lo, hi), hi if there is none,
+    * i.e., equivalent to support::lower_bound(lo, hi, key, dataset).
+    *
+    * Linearly scans blocks of simd_block<Key> elements outwards from start,
+    * i.e., costs O(distance between start and the result / simd_block<Key>).
+    * After max_blocks blocks in either direction, the remaining range is
+    * binary searched instead, bounding the cost of far off starts
+    */
+   template<class Dataset, class Key>
+   forceinline size_t simd_lower_bound(const Dataset& dataset, const size_t lo, const size_t hi, size_t start,
+                                       const Key& key, const size_t max_blocks = std::numeric_limits<size_t>::max()) {
+      constexpr size_t block = simd_block<Key>;
+      start = std::clamp(start, lo, hi);
+      if (unlikely(start == hi))
+         return simd_lower_bound_backwards(dataset, lo, hi, key, max_blocks);
+
+      // forwards, as long as all elements of each block are < key
+      size_t blocks = 0;
+      for (size_t first = start; first < hi; first += block, blocks++) {
+         if (unlikely(blocks == max_blocks))
+            return support::lower_bound(first, hi, key, dataset);
+
+         const auto count = std::min(block, hi - first);
+         const auto rank = block_rank(dataset, first, count, key);
+         if (rank < count)
+            // no element < key at all, i.e., result may precede start
+            return rank == 0 && first == start ? simd_lower_bound_backwards(dataset, lo, start, key, max_blocks)
+                                               : first + rank;
+      }
+      return hi;
+   }
+} // namespace exotic_hashing::support
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "serialization.hpp"
+#include "simd_search.hpp"
+
+#include "../convenience/builtins.hpp"
+
+namespace exotic_hashing::support {
+   /**
+    * Static B+ tree (S+ tree) over a sorted array, see Khuong & Morin, "Array
+    * Layouts for Comparison-Based Searching" (2017). Keys are stored in cache
+    * line sized nodes:
+    *  - the bottom layer is the sorted array itself, padded to full nodes,
+    *    i.e., lower_bound() directly yields a key's position in sorted order
+    *  - each upper node holds the first key of its children 1...node_keys,
+    *    i.e., has node_keys + 1 children which are stored consecutively
+    *
+    * A query descends one node, i.e., one cache miss, per layer instead of
+    * one per binary search step. All keys of a node are compared at once and
+    * branch free, see support::simd_rank. Upper layers are stored first and
+    * only take up about 1/node_keys additional space.
+    *
+    * @tparam Container node storage. MappedArray yields a read-only tree
+    *   operating on a mapped file, see deserialize()
+    */
+   template<class Key, template<class> class Container = std::vector>
+   class StaticSearchTree {
+      static_assert(std::is_integral_v<Key> && 64 % sizeof(Key) == 0);
+
+      static constexpr size_t node_keys = simd_block<Key>;
+      static constexpr size_t fanout = node_keys + 1;
+      /// pads incomplete nodes and separates nonexistent children, i.e., never less than a searched key
+      static constexpr Key padding = std::numeric_limits<Key>::max();
+
+      struct alignas(64) Node {
+         std::array<Key, node_keys> keys;
+      };
+
+      /// all layers from the root down to the leaves
+      Container<Node> nodes;
+      /// index of each layer's first node. The last layer contains the leaves
+      Container<size_t> layer_offsets;
+      size_t n = 0;
+
+      /// amount of keys in node less than key
+      static forceinline size_t rank(const Node& node, const Key& key) {
+         return simd_rank(node.keys.data(), key);
+      }
+
+     public:
+      /// read-only tree operating on a mapped file, see deserialize()
+      using Mapped = StaticSearchTree<Key, MappedArray>;
+
+      StaticSearchTree() = default;
+
+      /**
+       * Constructs on *already sorted* range of keys
+       */
+      template<class ForwardIt>
+      StaticSearchTree(const ForwardIt& begin, const ForwardIt& end) {
+         n = std::distance(begin, end);
+         assert(std::is_sorted(begin, end));
+
+         // 1. layer sizes, leaves first
+         std::vector<size_t> layer_sizes{std::max<size_t>((n + node_keys - 1) / node_keys, 1)};
+         while (layer_sizes.back() > 1)
+            layer_sizes.push_back((layer_sizes.back() + fanout - 1) / fanout);
+
+         size_t total = 0;
+         for (auto it = layer_sizes.rbegin(); it != layer_sizes.rend(); it++) {
+            layer_offsets.push_back(total);
+            total += *it;
+         }
+         nodes.resize(total);
+
+         // 2. leaves, i.e., the padded sorted keys
+         const size_t leaves = layer_offsets.back();
+         auto it = begin;
+         for (size_t i = 0; i < layer_sizes[0] * node_keys; i++)
+            nodes[leaves + i / node_keys].keys[i % node_keys] = i < n ? *(it++) : padding;
+
+         // 3. upper layers. The subtree of node j at height h starts at leaf j * fanout^h
+         size_t subtree_leaves = 1;
+         for (size_t h = 1; h < layer_sizes.size(); h++) {
+            const auto offset = layer_offsets[layer_sizes.size() - 1 - h];
+            for (size_t j = 0; j < layer_sizes[h]; j++)
+               for (size_t i = 0; i < node_keys; i++) {
+                  const auto child = j * fanout + i + 1;
+                  nodes[offset + j].keys[i] =
+                     child < layer_sizes[h - 1] ? nodes[leaves + child * subtree_leaves].keys[0] : padding;
+               }
+            subtree_leaves *= fanout;
+         }
+      }
+
+      static std::string name() {
+         return "StaticSearchTree";
+      }
+
+      /// index of the first key >= key in sorted order, size() if there is none
+      forceinline size_t lower_bound(const Key& key) const {
+         size_t node = 0;
+         for (size_t layer = 0; layer + 1 < layer_offsets.size(); layer++)
+            node = node * fanout + rank(nodes[layer_offsets[layer] + node], key);
+
+         return std::min(node * node_keys + rank(nodes[layer_offsets.back() + node], key), n);
+      }
+
+      /// i-th key in sorted order
+      forceinline Key operator[](const size_t i) const {
+         assert(i < n);
+         return nodes[layer_offsets.back() + i / node_keys].keys[i % node_keys];
+      }
+
+      size_t size() const {
+         return n;
+      }
+
+      size_t byte_size() const {
+         return sizeof(*this) + sizeof(Node) * nodes.size() + sizeof(size_t) * layer_offsets.size();
+      }
+
+      /// Writes this tree, see support::Serializer
+      void serialize(Serializer& out) const {
+         out.write(static_cast<std::uint64_t>(n));
+         out.write_array(nodes.data(), nodes.size());
+         out.write_array(layer_offsets.data(), layer_offsets.size());
+      }
+
+      void deserialize(Deserializer& in) {
+         n = in.read<std::uint64_t>();
+         in.read_array(nodes);
+         in.read_array(layer_offsets);
+      }
+   };
+} // namespace exotic_hashing::support
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <x86intrin.h>
@@ -7,10 +8,19 @@
 #include "../convenience/builtins.hpp"
 
 namespace exotic_hashing::support {
+   /// whether dataset implements a bounded lower_bound(value, first, last) itself, e.g., support::EliasFanoList
+   template<class Dataset, class Data>
+   concept NativeLowerBound = requires(const Dataset& dataset, const Data& value, size_t i) {
+      { dataset.lower_bound(value, i, i) } -> std::convertible_to<size_t>;
+   };
+
    /// Lower bound implementation from https://en.cppreference.com/w/cpp/algorithm/lower_bound, adapted to be usable
-   /// on std::vector as well as support::EliasFanoList
+   /// on std::vector as well as support::EliasFanoList. Defers to the dataset's own implementation if available
    template<class Dataset, class Data>
    forceinline size_t lower_bound(size_t first, size_t last, const Data& value, const Dataset& dataset) {
+      if constexpr (NativeLowerBound<Dataset, Data>)
+         return dataset.lower_bound(value, first, last);
+
       size_t i = first, count = last - first, step = 0;
 
       while (count > 0) {
@@ -56,6 +66,18 @@ namespace exotic_hashing::support {
       }
    }
 
+   /// position of the (rank + 1)-th one bit in word. word must contain more than rank one bits
+   static forceinline size_t select64(const std::uint64_t word, const size_t rank) {
+#ifdef __BMI2__
+      return _tzcnt_u64(_pdep_u64(0x1LLU << rank, word));
+#else
+      auto x = word;
+      for (size_t i = 0; i < rank; i++)
+         x &= x - 1;
+      return ctz(x);
+#endif
+   }
+
    template<class T>
    forceinline constexpr size_t clz(const T& x) {
       if (x == 0)
@@ -1,9 +1,13 @@
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <string>
+#include <tuple>
 #include <unordered_set>
 #include <vector>
 
@@ -138,6 +142,195 @@ static void LookupTime(benchmark::State& state) {
    state.SetLabel(Hashfn::name() + ":" + dataset::name(did) + ":" + dataset::name(probing_dist));
 };
 
+template<class Hashfn>
+static void BatchLookupTime(benchmark::State& state) {
+   const auto dataset_size = state.range(0);
+   const auto did = static_cast<dataset::ID>(state.range(1));
+   auto dataset = dataset::load_cached(did, dataset_size);
+
+   if (dataset.empty()) {
+      // otherwise google benchmark produces an error ;(
+      for (auto _ : state) {}
+      return;
+   }
+
+   // probe in random order to limit caching effects
+   const auto probing_dist = static_cast<dataset::ProbingDistribution>(state.range(2));
+   const auto probing_set = dataset::generate_probing_set(dataset, probing_dist);
+
+   // build hashfn
+   const auto hashfn = Hashfn(dataset);
+
+   // each iteration looks up one batch, e.g., as a join operator would
+   constexpr size_t batch_size = 1024;
+   std::vector<size_t> out(batch_size);
+   size_t i = 0;
+   for (auto _ : state) {
+      if (unlikely(i + batch_size > probing_set.size()))
+         i = 0;
+      const auto n = std::min(batch_size, probing_set.size());
+
+      hashfn.lookup_batch(probing_set.data() + i, n, out.data());
+      benchmark::DoNotOptimize(out.data());
+      benchmark::ClobberMemory();
+      i += n;
+   }
+
+   // set counters (don't do this in inner loop to avoid tainting results)
+   state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * std::min(batch_size, probing_set.size())));
+   state.counters["hashfn_bytes"] = hashfn.byte_size();
+   state.counters["hashfn_bits_per_key"] = 8. * hashfn.byte_size() / dataset.size();
+   state.counters["dataset_elem_count"] = dataset.size();
+   state.counters["dataset_bytes"] = (sizeof(decltype(dataset)::value_type) * dataset.size());
+   state.SetLabel(Hashfn::name() + ":" + dataset::name(did) + ":" + dataset::name(probing_dist));
+};
+
+/**
+ * Times all last level search policies on the same model, stored keys and
+ * probes, i.e., the setting of LearnedRank (List = std::vector) and
+ * CompressedLearnedRank (List = support::EliasFanoList). Per policy lookup
+ * times are reported as counters, the fastest policy in the label
+ */
+template<class Model, class List>
+static void LastLevelSearchTime(benchmark::State& state) {
+   const auto dataset_size = state.range(0);
+   const auto did = static_cast<dataset::ID>(state.range(1));
+   auto dataset = dataset::load_cached(did, dataset_size);
+
+   if (dataset.empty()) {
+      // otherwise google benchmark produces an error ;(
+      for (auto _ : state) {}
+      return;
+   }
+
+   const auto probing_dist = static_cast<dataset::ProbingDistribution>(state.range(2));
+   const auto probing_set = dataset::generate_probing_set(dataset, probing_dist);
+
+   // as in LearnedRank, the model is trained on all keys but only every second key is stored
+   Model model;
+   model.train(dataset.begin(), dataset.end(), dataset.size() / 2);
+   std::vector<Data> stored;
+   for (size_t j = 1; j < dataset.size(); j += 2)
+      stored.push_back(dataset[j]);
+   const List list(stored.begin(), stored.end());
+
+   using namespace exotic_hashing::last_level_search;
+   const std::tuple<SequentialRangeLookup<Data>, ExponentialRangeLookup<Data>, BinaryRangeLookup<Data>,
+                    BucketedRangeLookup<Data>, SIMDLinearRangeLookup<Data>, InterpolationSIMDRangeLookup<Data>>
+      policies{{list, model}, {list, model}, {list, model}, {list, model}, {list, model}, {list, model}};
+   std::array<std::chrono::nanoseconds, std::tuple_size_v<decltype(policies)>> durations{};
+
+   // each iteration looks up one batch per policy, timing each batch separately
+   constexpr size_t batch_size = 1024;
+   size_t i = 0;
+   for (auto _ : state) {
+      if (unlikely(i + batch_size > probing_set.size()))
+         i = 0;
+      const auto n = std::min(batch_size, probing_set.size());
+
+      size_t p = 0;
+      std::apply(
+         [&](const auto&... policy) {
+            const auto time = [&](const auto& lls) {
+               const auto start = std::chrono::steady_clock::now();
+               for (size_t j = i; j < i + n; j++)
+                  benchmark::DoNotOptimize(lls(model(probing_set[j]), probing_set[j], list));
+               durations[p++] += std::chrono::steady_clock::now() - start;
+            };
+            (time(policy), ...);
+         },
+         policies);
+      i += n;
+   }
+
+   // set counters (don't do this in inner loop to avoid tainting results)
+   const auto lookups = static_cast<double>(state.iterations() * std::min(batch_size, probing_set.size()));
+   std::string winner;
+   double winner_ns = std::numeric_limits<double>::max();
+   size_t p = 0;
+   std::apply(
+      [&](const auto&... policy) {
+         const auto report = [&](const auto& lls) {
+            const auto ns = static_cast<double>(durations[p++].count()) / lookups;
+            state.counters[lls.name() + "_ns_per_key"] = ns;
+            if (ns < winner_ns) {
+               winner_ns = ns;
+               winner = lls.name();
+            }
+         };
+         (report(policy), ...);
+      },
+      policies);
+   std::string list_name = "Array";
+   if constexpr (requires { List::name(); })
+      list_name = List::name();
+   state.SetItemsProcessed(static_cast<int64_t>(lookups) * std::tuple_size_v<decltype(policies)>);
+   state.counters["dataset_elem_count"] = dataset.size();
+   state.SetLabel("LastLevelSearch<" + Model::name() + ", " + list_name + ">:" + dataset::name(did) + ":" +
+                  dataset::name(probing_dist) + ":" + winner);
+};
+
+template<class Hasher>
+static void PeelSuccessRate(benchmark::State& state) {
+   const auto dataset_size = state.range(0);
+   const auto did = static_cast<dataset::ID>(state.range(1));
+   auto dataset = dataset::load_cached(did, dataset_size);
+
+   if (dataset.empty()) {
+      // otherwise google benchmark produces an error ;(
+      for (auto _ : state) {}
+      return;
+   }
+
+   // vertex count as chosen by MWHC for this hasher
+   size_t N = std::ceil(1.23 * dataset.size());
+   if constexpr (exotic_hashing::support::ProvidesVertexCount<Hasher>)
+      N = Hasher::vertices_count(dataset.size());
+
+   size_t attempts = 0, successes = 0;
+   for (auto _ : state) {
+      const Hasher hasher(N);
+      exotic_hashing::support::HyperGraph<Data, Hasher> g(dataset.begin(), dataset.end(), hasher, N);
+      const auto peel_order = g.peel();
+      benchmark::DoNotOptimize(peel_order.data());
+
+      attempts++;
+      successes += !peel_order.empty();
+   }
+
+   // set counters (don't do this in inner loop to avoid tainting results)
+   state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * dataset.size()));
+   state.counters["peel_success_rate"] = static_cast<double>(successes) / static_cast<double>(attempts);
+   state.counters["vertices_per_key"] = static_cast<double>(N) / static_cast<double>(dataset.size());
+   state.counters["dataset_elem_count"] = dataset.size();
+   state.SetLabel(dataset::name(did));
+};
+
+/// Concatenates randomly sized, unaligned bitvectors as the tries' recursive conversion does (see HollowTrie)
+static void BitvectorAppend(benchmark::State& state) {
+   const auto total_bits = static_cast<size_t>(state.range(0));
+   const auto max_piece_bits = static_cast<size_t>(state.range(1));
+
+   std::default_random_engine rng(42);
+   std::uniform_int_distribution<size_t> len_dist(1, max_piece_bits);
+   std::vector<exotic_hashing::support::Bitvector<>> pieces;
+   for (size_t bits = 0; bits < total_bits;) {
+      const auto len = len_dist(rng);
+      pieces.emplace_back(len, [&](const size_t& /*index*/) { return rng() & 0x1; });
+      bits += len;
+   }
+
+   for (auto _ : state) {
+      exotic_hashing::support::Bitvector<> bv;
+      for (const auto& piece : pieces)
+         bv.append(piece);
+      benchmark::DoNotOptimize(bv);
+   }
+
+   state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * total_bits / 8));
+   state.counters["pieces"] = pieces.size();
+}
+
 #define BM(Hashfn)                                                                         \
    BENCHMARK_TEMPLATE(PresortedBuildTime, Hashfn)->ArgsProduct({dataset_sizes, datasets}); \
    BENCHMARK_TEMPLATE(UnorderedBuildTime, Hashfn)->ArgsProduct({dataset_sizes, datasets}); \
@@ -145,12 +338,22 @@ static void LookupTime(benchmark::State& state) {
       ->ArgsProduct({dataset_sizes, datasets, probe_distributions})                        \
       ->Iterations(50000000);
 
+/// additionally benchmarks lookup_batch() for structures supporting it
+#define BM_BATCH(Hashfn) \
+   BM(Hashfn);           \
+   BENCHMARK_TEMPLATE(BatchLookupTime, Hashfn)->ArgsProduct({dataset_sizes, datasets, probe_distributions});
+
 using DoNothingHash = exotic_hashing::DoNothingHash<Data>;
 BM(DoNothingHash);
 using RankHash = exotic_hashing::RankHash<Data>;
 BM(RankHash);
+using StaticSearchTreeRankHash = exotic_hashing::RankHash<Data, exotic_hashing::support::StaticSearchTree<Data>>;
+BM(StaticSearchTreeRankHash);
 using CompressedRankHash = exotic_hashing::CompressedRankHash<Data>;
 BM(CompressedRankHash);
+using PartitionedCompressedRankHash =
+   exotic_hashing::CompressedRankHash<Data, exotic_hashing::support::PartitionedEliasFanoList<Data>>;
+BM(PartitionedCompressedRankHash);
 using MapOMPHF = exotic_hashing::MapOMPHF<Data>;
 BM(MapOMPHF);
 
@@ -170,17 +373,115 @@ using SimpleHollowTrie = exotic_hashing::SimpleHollowTrie<Data, exotic_hashing::
 BM(SimpleHollowTrie);
 using HollowTrie = exotic_hashing::HollowTrie<Data, exotic_hashing::support::FixedBitConverter<Data>>;
 BM(HollowTrie);
+
+// node field integer codes, i.e., space (hashfn_bits_per_key) vs lookup time frontier
+template<class IntEncoder>
+using CodedHollowTrie = exotic_hashing::HollowTrie<Data, exotic_hashing::support::FixedBitConverter<Data>,
+                                                   exotic_hashing::support::FixedBitvector<64, Data>, IntEncoder>;
+template<class IntEncoder>
+using CodedCompactedCompactTrie =
+   exotic_hashing::CompactedCompactTrie<Data, exotic_hashing::support::FixedBitConverter<Data>, false,
+                                        exotic_hashing::support::FixedBitvector<64, Data>, IntEncoder>;
+#define BM_INT_CODE(IntEncoder)                                                                             \
+   BENCHMARK_TEMPLATE(LookupTime, CodedHollowTrie<IntEncoder>)                                              \
+      ->ArgsProduct({dataset_sizes, datasets, probe_distributions})                                         \
+      ->Iterations(50000000);                                                                               \
+   BENCHMARK_TEMPLATE(LookupTime, CodedCompactedCompactTrie<IntEncoder>)                                    \
+      ->ArgsProduct({dataset_sizes, datasets, probe_distributions})                                         \
+      ->Iterations(50000000);
+
+using EliasGamma = exotic_hashing::support::EliasGammaCoder;
+BM_INT_CODE(EliasGamma);
+using GolombRice = exotic_hashing::support::GolombRiceCoder;
+BM_INT_CODE(GolombRice);
+using Zeta3 = exotic_hashing::support::ZetaCoder<3>;
+BM_INT_CODE(Zeta3);
+using Varint = exotic_hashing::support::VarintCoder;
+BM_INT_CODE(Varint);
+using Nibble = exotic_hashing::support::NibbleCoder;
+BM_INT_CODE(Nibble);
 using FST = exotic_hashing::FastSuccinctTrie<Data>;
 BM(FST);
 
 using BitMWHC = exotic_hashing::BitMWHC<Data>;
-BM(BitMWHC);
+BM_BATCH(BitMWHC);
+using MinimalBitMWHC = exotic_hashing::MinimalBitMWHC<Data>;
+BM_BATCH(MinimalBitMWHC);
 using MWHC = exotic_hashing::MWHC<Data>;
-BM(MWHC);
+BM_BATCH(MWHC);
 using CompressedMWHC = exotic_hashing::CompressedMWHC<Data>;
-BM(CompressedMWHC);
+BM_BATCH(CompressedMWHC);
 using CompactedMWHC = exotic_hashing::CompactedMWHC<Data>;
-BM(CompactedMWHC);
+BM_BATCH(CompactedMWHC);
+using InterleavedCompactedMWHC = exotic_hashing::InterleavedCompactedMWHC<Data>;
+BM_BATCH(InterleavedCompactedMWHC);
+using ParallelMWHC =
+   exotic_hashing::MWHC<Data, exotic_hashing::support::Hasher<Data>,
+                        exotic_hashing::support::ParallelHyperGraph<Data, exotic_hashing::support::Hasher<Data>>>;
+BM(ParallelMWHC);
+using PartitionedMWHC = exotic_hashing::PartitionedMWHC<Data>;
+BM_BATCH(PartitionedMWHC);
+using FuseBitMWHC = exotic_hashing::BitMWHC<Data, exotic_hashing::support::FuseHasher<Data>>;
+BM_BATCH(FuseBitMWHC);
+using FuseMWHC = exotic_hashing::MWHC<Data, exotic_hashing::support::FuseHasher<Data>>;
+BM_BATCH(FuseMWHC);
+using FuseCompressedMWHC = exotic_hashing::CompressedMWHC<Data, exotic_hashing::support::FuseHasher<Data>>;
+BM_BATCH(FuseCompressedMWHC);
+using MultiplyShiftMWHC = exotic_hashing::MWHC<Data, exotic_hashing::support::MultiplyShiftHasher<Data>>;
+BM_BATCH(MultiplyShiftMWHC);
+using MultiplyShiftCompressedMWHC =
+   exotic_hashing::CompressedMWHC<Data, exotic_hashing::support::MultiplyShiftHasher<Data>>;
+BM_BATCH(MultiplyShiftCompressedMWHC);
+// 28 bits suffice for vertex values of up to 200M keys
+using FixedWidthMWHC = exotic_hashing::FixedWidthMWHC<Data, 28>;
+BM_BATCH(FixedWidthMWHC);
+using MultiplyShiftFixedWidthMWHC =
+   exotic_hashing::FixedWidthMWHC<Data, 28, exotic_hashing::support::MultiplyShiftHasher<Data>>;
+BM_BATCH(MultiplyShiftFixedWidthMWHC);
+
+BENCHMARK(BitvectorAppend)->ArgsProduct({{1 << 20, 1 << 26}, {64, 4096, 1 << 20}});
+
+using Hasher = exotic_hashing::support::Hasher<Data>;
+using MultiplyShiftHasher = exotic_hashing::support::MultiplyShiftHasher<Data>;
+using FuseHasher = exotic_hashing::support::FuseHasher<Data>;
+BENCHMARK_TEMPLATE(PeelSuccessRate, Hasher)->ArgsProduct({dataset_sizes, datasets})->Iterations(20);
+BENCHMARK_TEMPLATE(PeelSuccessRate, MultiplyShiftHasher)->ArgsProduct({dataset_sizes, datasets})->Iterations(20);
+BENCHMARK_TEMPLATE(PeelSuccessRate, FuseHasher)->ArgsProduct({dataset_sizes, datasets})->Iterations(20);
+
+using LearnedRank_PGM = exotic_hashing::LearnedRank<Data, exotic_hashing::support::PGMModel<Data>,
+                                                    exotic_hashing::last_level_search::BinaryRangeLookup<Data>>;
+BM(LearnedRank_PGM);
+using CompressedLearnedRank_PGM =
+   exotic_hashing::CompressedLearnedRank<Data, exotic_hashing::support::PGMModel<Data>,
+                                         exotic_hashing::last_level_search::BinaryRangeLookup<Data>>;
+BM(CompressedLearnedRank_PGM);
+using LearnedRank_PGM_Bucketed =
+   exotic_hashing::LearnedRank<Data, exotic_hashing::support::PGMModel<Data>,
+                               exotic_hashing::last_level_search::BucketedRangeLookup<Data>>;
+BM(LearnedRank_PGM_Bucketed);
+using LearnedRank_PGM_SIMDLinear =
+   exotic_hashing::LearnedRank<Data, exotic_hashing::support::PGMModel<Data>,
+                               exotic_hashing::last_level_search::SIMDLinearRangeLookup<Data>>;
+BM(LearnedRank_PGM_SIMDLinear);
+using LearnedRank_RMIModel = exotic_hashing::LearnedRank<Data, exotic_hashing::support::RMIModel<Data>,
+                                                         exotic_hashing::last_level_search::BinaryRangeLookup<Data>>;
+BM(LearnedRank_RMIModel);
+// sampled root, parallel second level training & compaction overlapping training on all hardware threads
+using ParallelLearnedRank_RMIModel =
+   exotic_hashing::LearnedRank<Data, exotic_hashing::support::RMIModel<Data, 1000000, 1 << 16, 0>,
+                               exotic_hashing::last_level_search::BinaryRangeLookup<Data>, 0>;
+BM(ParallelLearnedRank_RMIModel);
+using ParallelCompressedLearnedRank_PGM =
+   exotic_hashing::CompressedLearnedRank<Data, exotic_hashing::support::PGMModel<Data, 32, 4, 0>,
+                                         exotic_hashing::last_level_search::BinaryRangeLookup<Data>,
+                                         exotic_hashing::support::EliasFanoList<Data>, 0>;
+BM(ParallelCompressedLearnedRank_PGM);
+
+using PGM = exotic_hashing::support::PGMModel<Data>;
+using EliasFanoList = exotic_hashing::support::EliasFanoList<Data>;
+BENCHMARK_TEMPLATE(LastLevelSearchTime, PGM, std::vector<Data>)
+   ->ArgsProduct({dataset_sizes, datasets, probe_distributions});
+BENCHMARK_TEMPLATE(LastLevelSearchTime, PGM, EliasFanoList)->ArgsProduct({dataset_sizes, datasets, probe_distributions});
 
 // using LearnedRank_RMI = exotic_hashing::LearnedRank<Data, learned_hashing::MonotoneRMIHash<Data, 1000000>>;
 // BM(LearnedRank_RMI);
@@ -10,14 +10,26 @@
 #include "tests/compacttrie-tests.hpp"
 #include "tests/compressedmwhc-tests.hpp"
 #include "tests/compressedsfmwhc-tests.hpp"
+#include "tests/darray-tests.hpp"
 #include "tests/elias-tests.hpp"
 #include "tests/eliasfanolist-tests.hpp"
+#include "tests/fixedwidthmwhc-tests.hpp"
+#include "tests/fixedwidthvector-tests.hpp"
 #include "tests/fst-tests.hpp"
 #include "tests/hollowtrie-tests.hpp"
+#include "tests/integercodes-tests.hpp"
+#include "tests/interleavedcompactedmwhc-tests.hpp"
+#include "tests/interleavedcompactedvector-tests.hpp"
 #include "tests/learnedlinear-tests.hpp"
 #include "tests/learnedrank-tests.hpp"
 #include "tests/map-omphf-tests.hpp"
 #include "tests/mwhc-tests.hpp"
+#include "tests/partitionedeliasfanolist-tests.hpp"
+#include "tests/pgmmodel-tests.hpp"
 #include "tests/rankhash-tests.hpp"
 #include "tests/recsplit-tests.hpp"
+#include "tests/rmimodel-tests.hpp"
+#include "tests/serialization-tests.hpp"
 #include "tests/sfmwhc-tests.hpp"
+#include "tests/staticsearchtree-tests.hpp"
+#include "tests/xorfilter-tests.hpp"
@@ -10,3 +10,59 @@
 TEST(BitMWHC, IsPerfect) {
    tests::common::run_test<std::uint64_t, exotic_hashing::BitMWHC<std::uint64_t>, tests::common::TestIsPerfect>();
 }
+
+TEST(ParallelBitMWHC, IsPerfect) {
+   using Data = std::uint64_t;
+   using Hasher = exotic_hashing::support::Hasher<Data>;
+   tests::common::run_test<
+      Data, exotic_hashing::BitMWHC<Data, Hasher, exotic_hashing::support::ParallelHyperGraph<Data, Hasher>>,
+      tests::common::TestIsPerfect>();
+}
+
+TEST(BitMWHC, LookupBatch) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::BitMWHC<std::uint64_t>, tests::common::TestLookupBatch>();
+}
+
+TEST(FuseBitMWHC, IsPerfect) {
+   using Data = std::uint64_t;
+   tests::common::run_test<std::uint64_t, exotic_hashing::BitMWHC<Data, exotic_hashing::support::FuseHasher<Data>>,
+                           tests::common::TestIsPerfect>();
+}
+
+TEST(MinimalBitMWHC, IsPerfect) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::MinimalBitMWHC<std::uint64_t>,
+                           tests::common::TestIsPerfect>();
+}
+
+TEST(MinimalBitMWHC, IsMinimal) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::MinimalBitMWHC<std::uint64_t>,
+                           tests::common::TestIsMinimal>();
+}
+
+TEST(ParallelMinimalBitMWHC, IsPerfect) {
+   using Data = std::uint64_t;
+   using Hasher = exotic_hashing::support::Hasher<Data>;
+   tests::common::run_test<
+      Data, exotic_hashing::MinimalBitMWHC<Data, Hasher, exotic_hashing::support::ParallelHyperGraph<Data, Hasher>>,
+      tests::common::TestIsPerfect>();
+}
+
+TEST(FuseMinimalBitMWHC, IsPerfect) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data, exotic_hashing::MinimalBitMWHC<Data, exotic_hashing::support::FuseHasher<Data>>,
+                           tests::common::TestIsPerfect>();
+}
+
+TEST(MinimalBitMWHC, LookupBatch) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::MinimalBitMWHC<std::uint64_t>,
+                           tests::common::TestLookupBatch>();
+}
+
+TEST(MinimalBitMWHC, SpaceOverhead) {
+   std::default_random_engine rng_gen(42);
+   const auto dataset = tests::common::gapped_dataset<std::uint64_t>(100000, rng_gen);
+   const exotic_hashing::MinimalBitMWHC<std::uint64_t> h(dataset);
+
+   // 2 bits per vertex, 1.23 vertices per key, 32 bit rank sample per 240 vertices
+   EXPECT_LE(8. * h.byte_size() / dataset.size(), 2.65);
+}
@@ -156,6 +156,82 @@ TEST(Bitvector, AppendOtherBitvector) {
    }
 }
 
+TEST(Bitvector, AppendRange) {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng(42);
+   std::uniform_int_distribution<size_t> dist(0, std::numeric_limits<size_t>::max());
+
+   const Bitvector<> other(1000, [&](const size_t& /*index*/) { return dist(rng) & 0x1; });
+   for (const auto prefix : {0U, 1U, 63U, 64U, 65U, 130U}) {
+      for (const auto start : {0U, 1U, 31U, 64U, 100U, 511U}) {
+         for (const auto stop : {start, start + 1, start + 63, start + 64, start + 65, start + 300, 1000U}) {
+            Bitvector bv(prefix, true);
+            bv.append_range(other, start, stop);
+
+            EXPECT_EQ(bv.size(), prefix + stop - start);
+            for (size_t i = 0; i < prefix; i++)
+               EXPECT_EQ(bv[i], true);
+            for (size_t i = start; i < stop; i++)
+               EXPECT_EQ(bv[prefix + i - start], other[i]);
+
+            // appending must not leave stray bits behind
+            bv.append(false);
+            EXPECT_EQ(bv[bv.size() - 1], false);
+         }
+      }
+   }
+}
+
+TEST(Bitvector, Slice) {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng(1337);
+   std::uniform_int_distribution<size_t> dist(0, std::numeric_limits<size_t>::max());
+
+   const Bitvector<> bv(777, [&](const size_t& /*index*/) { return dist(rng) & 0x1; });
+   for (const auto start : {0U, 5U, 64U, 200U}) {
+      for (const auto stop : {start, start + 7, start + 64, start + 129, 777U}) {
+         const auto slice = bv.slice(start, stop);
+         EXPECT_EQ(slice.size(), stop - start);
+         for (size_t i = start; i < stop; i++)
+            EXPECT_EQ(slice[i - start], bv[i]);
+      }
+   }
+}
+
+TEST(Bitvector, Equality) {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng(13);
+   std::uniform_int_distribution<size_t> dist(0, std::numeric_limits<size_t>::max());
+
+   for (const auto size : {0U, 8U, 63U, 64U, 65U, 200U, 100000U}) {
+      std::vector<bool> vec(size, false);
+      for (size_t i = 0; i < size; i++)
+         vec[i] = dist(rng) & 0x1;
+
+      const Bitvector bv(vec);
+      Bitvector appended;
+      for (const auto bit : vec)
+         appended.append(bit);
+
+      EXPECT_TRUE(bv == appended);
+      EXPECT_TRUE(bv == bv.slice(0, size));
+
+      // differing in size
+      appended.append(false);
+      EXPECT_FALSE(bv == appended);
+
+      // differing in a single bit
+      if (size > 0) {
+         Bitvector flipped(vec);
+         flipped[size - 1] = !vec[size - 1];
+         EXPECT_FALSE(bv == flipped);
+      }
+   }
+}
+
 TEST(Bitvector, CountZeroes) {
    using namespace exotic_hashing::support;
 
@@ -207,6 +283,27 @@ TEST(Bitvector, Extract) {
    }
 }
 
+TEST(Bitvector, Peek) {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng(7);
+   std::uniform_int_distribution<size_t> dist(0, std::numeric_limits<size_t>::max());
+
+   for (const auto size : {1U, 63U, 64U, 65U, 128U, 200U}) {
+      std::vector<bool> vec(size, false);
+      for (size_t i = 0; i < size; i++)
+         vec[i] = dist(rng) & 0x1;
+      const Bitvector bv(vec);
+
+      for (size_t i = 0; i < size; i++) {
+         const auto window = bv.peek(i);
+         // bits past the end read as zero
+         for (size_t k = 0; k < sizeof(std::uint64_t) * 8; k++)
+            EXPECT_EQ((window >> k) & 0x1, i + k < size && vec[i + k]);
+      }
+   }
+}
+
 TEST(Bitvector, Matches) {
    using namespace exotic_hashing::support;
 
@@ -241,6 +338,49 @@ TEST(Bitvector, Matches) {
    }
 }
 
+TEST(Bitvector, RankSelect) {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng(42);
+   for (const auto size : {0U, 1U, 63U, 64U, 512U, 2048U, 2049U, 100000U}) {
+      for (const auto density : {0.0, 0.001, 0.1, 0.5, 0.99, 1.0}) {
+         std::bernoulli_distribution dist(density);
+         Bitvector bv(size, [&](const size_t& /*index*/) { return dist(rng); });
+         bv.init_rank_select();
+
+         size_t ones = 0;
+         for (size_t i = 0; i < size; i++) {
+            EXPECT_EQ(bv.rank(i), ones);
+            if (bv[i]) {
+               EXPECT_EQ(bv.select(ones), i);
+               ones++;
+            }
+         }
+         EXPECT_EQ(bv.rank(size), ones);
+         EXPECT_EQ(bv.ones(), ones);
+      }
+   }
+}
+
+TEST(Bitvector, RankSelectSparse) {
+   using namespace exotic_hashing::support;
+
+   // long runs of empty blocks between consecutive select samples
+   Bitvector bv(10'000'000, false);
+   std::vector<size_t> positions;
+   for (size_t i = 7; i < bv.size(); i += 997)
+      positions.push_back(i);
+   for (const auto p : positions)
+      bv[p] = true;
+   bv.init_rank_select();
+
+   for (size_t i = 0; i < positions.size(); i++) {
+      EXPECT_EQ(bv.select(i), positions[i]);
+      EXPECT_EQ(bv.rank(positions[i]), i);
+      EXPECT_EQ(bv.rank(positions[i] + 1), i + 1);
+   }
+}
+
 // ==== FixedBitvector ====
 TEST(FixedBitvector, FromGenerator) {
    using namespace exotic_hashing::support;
@@ -384,3 +524,41 @@ TEST(FixedBitvector, Matches) {
       }
    }
 }
+
+TEST(FixedBitvector, Equality) {
+   using namespace exotic_hashing::support;
+
+   const FixedBitvector<129> ones(100, true);
+   const FixedBitvector<129> ones_too(std::vector<bool>(100, true));
+   EXPECT_TRUE(ones == ones_too);
+
+   const FixedBitvector<129> shorter(99, true);
+   EXPECT_FALSE(ones == shorter);
+
+   FixedBitvector<129> flipped(100, true);
+   flipped[70] = false;
+   EXPECT_FALSE(ones == flipped);
+}
+
+TEST(FixedBitvector, AppendToBitvector) {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng(7);
+   std::uniform_int_distribution<size_t> dist(0, std::numeric_limits<size_t>::max());
+
+   for (const auto prefix : {0U, 3U, 64U, 100U}) {
+      for (const auto size : {1U, 63U, 64U, 65U, 200U}) {
+         std::vector<bool> vec(size, false);
+         for (size_t i = 0; i < size; i++)
+            vec[i] = dist(rng) & 0x1;
+
+         const FixedBitvector<200> other(vec);
+         Bitvector bv(prefix, false);
+         bv.append(other);
+
+         EXPECT_EQ(bv.size(), prefix + size);
+         for (size_t i = 0; i < size; i++)
+            EXPECT_EQ(bv[prefix + i], vec[i]);
+      }
+   }
+}
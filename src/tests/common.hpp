@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <filesystem>
+#include <limits>
 #include <random>
 #include <stdexcept>
 #include <string>
@@ -110,6 +113,104 @@ namespace tests::common {
       }
    };
 
+   /// batched lookup must yield the same results as individual lookups
+   struct TestLookupBatch {
+      template<class HashFn, class T>
+      void operator()(const HashFn& h, const std::vector<T>& sorted_order,
+                      const std::vector<T>& insertion_order) const {
+         UNUSED(sorted_order);
+
+         // odd batch sizes to also cover partially filled windows
+         for (const size_t n : {static_cast<size_t>(0), static_cast<size_t>(1), static_cast<size_t>(17),
+                                insertion_order.size()}) {
+            std::vector<size_t> out(n, 0);
+            h.lookup_batch(insertion_order.data(), n, out.data());
+            for (size_t i = 0; i < n; i++)
+               EXPECT_EQ(out[i], h(insertion_order[i]));
+         }
+      }
+   };
+
+   /// temporary file path unique to the running test
+   static std::string temp_path(const std::string& suffix) {
+      const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+      return (std::filesystem::temp_directory_path() /
+              (std::string(info->test_suite_name()) + "." + info->name() + "." + suffix))
+         .string();
+   }
+
+   /// HashFn::View on a saved file must yield the same results as the original
+   struct TestSaveView {
+      template<class HashFn, class T>
+      void operator()(const HashFn& h, const std::vector<T>& sorted_order,
+                      const std::vector<T>& insertion_order) const {
+         UNUSED(sorted_order);
+
+         const auto path = temp_path("bin");
+         h.save(path);
+         {
+            const typename HashFn::View view(path);
+            for (const auto& key : insertion_order)
+               EXPECT_EQ(view(key), h(key));
+         }
+         std::filesystem::remove(path);
+      }
+   };
+
+   /**
+    * edge cases followed by uniform, clustered (piecewise very different
+    * slopes) and quadratic sorted key distributions of size keys each, for
+    * testing learned models
+    */
+   static std::vector<std::vector<std::uint64_t>> model_datasets(const size_t size) {
+      std::mt19937_64 rng(42);
+      std::vector<std::vector<std::uint64_t>> datasets{
+         {7}, {3, 3, 3, 9}, {0, std::numeric_limits<std::uint64_t>::max()}};
+
+      std::vector<std::uint64_t> uniform(size), clustered, quadratic(size);
+      for (auto& key : uniform)
+         key = rng();
+      std::sort(uniform.begin(), uniform.end());
+      for (std::uint64_t base = 0; clustered.size() < size; base += rng() >> 20)
+         for (size_t i = 0, step = 1 + rng() % 100; i < 1000; i++)
+            clustered.push_back(base + i * step);
+      for (size_t i = 0; i < quadratic.size(); i++)
+         quadratic[i] = i * i;
+      datasets.insert(datasets.end(), {uniform, clustered, quadratic});
+      return datasets;
+   }
+
+   /**
+    * trains Model on the sorted keys and returns the average distance between
+    * predictions and actual positions. Expects predictions within max_error()
+    * of the actual positions, where duplicates' actual position is their
+    * first occurrence's, and optionally monotone predictions
+    */
+   template<class Model>
+   static double test_model_error_bound(const std::vector<std::uint64_t>& keys, const size_t full_size,
+                                        const bool monotone = false) {
+      Model model;
+      model.train(keys.begin(), keys.end(), full_size);
+
+      double total_error = 0;
+      size_t prev = 0;
+      for (size_t i = 0; i < keys.size(); i++) {
+         const size_t rank = std::lower_bound(keys.begin(), keys.end(), keys[i]) - keys.begin();
+         const size_t actual = static_cast<long double>(rank) * full_size / keys.size();
+         const size_t pred = model(keys[i]);
+         const size_t error = pred >= actual ? pred - actual : actual - pred;
+         EXPECT_LT(pred, std::max<size_t>(full_size, 1));
+         EXPECT_LE(error, model.max_error()) << "key index " << i;
+         if (monotone) {
+            EXPECT_GE(pred, prev) << "key index " << i;
+         }
+
+         total_error += error;
+         prev = pred;
+      }
+      return keys.empty() ? 0 : total_error / static_cast<double>(keys.size());
+   }
+
    template<class T, class HashFn, class TestFun>
    static void run_test(const TestFun& test_fun = TestFun()) {
       // we do want predictable random results, hence the fixed seeds
@@ -33,3 +33,18 @@ TEST(CompactedCompactTrie, IsMMPHF) {
       exotic_hashing::CompactedCompactTrie<std::uint64_t, exotic_hashing::support::FixedBitConverter<std::uint64_t>>,
       tests::common::TestIsMMPHF>();
 }
+
+template<class IntEncoder>
+using CodedCompactedCompactTrie =
+   exotic_hashing::CompactedCompactTrie<std::uint64_t, exotic_hashing::support::FixedBitConverter<std::uint64_t>, false,
+                                        exotic_hashing::support::FixedBitvector<64, std::uint64_t>, IntEncoder>;
+
+TEST(CompactedCompactTrie, GolombRiceIsMMPHF) {
+   tests::common::run_test<std::uint64_t, CodedCompactedCompactTrie<exotic_hashing::support::GolombRiceCoder>,
+                           tests::common::TestIsMMPHF>();
+}
+
+TEST(CompactedCompactTrie, NibbleIsMMPHF) {
+   tests::common::run_test<std::uint64_t, CodedCompactedCompactTrie<exotic_hashing::support::NibbleCoder>,
+                           tests::common::TestIsMMPHF>();
+}
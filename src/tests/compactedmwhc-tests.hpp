@@ -19,3 +19,8 @@ TEST(CompactedMWHC, IsOrderPreserving) {
    tests::common::run_test<std::uint64_t, exotic_hashing::CompactedMWHC<std::uint64_t>,
                            tests::common::TestIsOrderPreserving>();
 }
+
+TEST(CompactedMWHC, LookupBatch) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::CompactedMWHC<std::uint64_t>,
+                           tests::common::TestLookupBatch>();
+}
@@ -21,3 +21,8 @@ TEST(CompressedMWHC, IsOrderPreserving) {
    tests::common::run_test<std::uint64_t, exotic_hashing::CompressedMWHC<std::uint64_t>,
                            tests::common::TestIsOrderPreserving>();
 }
+
+TEST(CompressedMWHC, LookupBatch) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::CompressedMWHC<std::uint64_t>,
+                           tests::common::TestLookupBatch>();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "include/support/darray.hpp"
+
+template<bool Ones, size_t SubblockOnes = 32>
+static void test_darray(const std::vector<std::uint64_t>& words, const size_t bitcnt) {
+   using namespace exotic_hashing::support;
+
+   std::vector<size_t> positions;
+   for (size_t i = 0; i < bitcnt; i++)
+      if (((words[i / 64] >> (i % 64)) & 0x1) == Ones)
+         positions.push_back(i);
+
+   const DArray<Ones, SubblockOnes> darray(words.data(), bitcnt);
+   ASSERT_EQ(darray.size(), positions.size());
+   for (size_t k = 0; k < positions.size(); k++)
+      EXPECT_EQ(darray.select(words.data(), k), positions[k]);
+}
+
+TEST(DArray, Select) {
+   std::mt19937_64 rng(1);
+
+   for (const size_t bitcnt : {1UL, 63UL, 64UL, 1000UL, 100000UL, 1000001UL}) {
+      // dense & uniform
+      std::vector<std::uint64_t> words((bitcnt + 63) / 64);
+      for (auto& w : words)
+         w = rng();
+      test_darray<true>(words, bitcnt);
+      test_darray<false>(words, bitcnt);
+      test_darray<false, 128>(words, bitcnt);
+
+      // very sparse, i.e., (partially) sparse blocks
+      std::vector<std::uint64_t> sparse((bitcnt + 63) / 64, 0);
+      for (size_t i = 0; i < bitcnt; i += 1 + rng() % 200)
+         sparse[i / 64] |= 0x1LLU << (i % 64);
+      test_darray<true>(sparse, bitcnt);
+      test_darray<false>(sparse, bitcnt);
+   }
+}
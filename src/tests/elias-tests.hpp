@@ -1,6 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <exotic_hashing.hpp>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -127,3 +132,65 @@ TEST(EliasCoding, DeltaEmbedded) {
    }
 }
 
+
+/// Encode many codes of all magnitudes into one caller provided stream and decode them in order
+TEST(EliasCoding, Stream) {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng_gen(42);
+   std::vector<std::uint64_t> values;
+   for (size_t bits = 1; bits <= 64; bits++) {
+      std::uniform_int_distribution<std::uint64_t> dist(0, bits == 64 ? ~0x0LLU : (0x1LLU << bits) - 1);
+      for (size_t i = 0; i < 100; i++)
+         values.push_back(dist(rng_gen) | (0x1LLU << (bits - 1)));
+   }
+   // all short codes
+   for (std::uint64_t x = 1; x < 4096; x++)
+      values.push_back(x);
+   std::shuffle(values.begin(), values.end(), rng_gen);
+
+   Bitvector gamma, delta;
+   for (const auto x : values) {
+      const auto gamma_size = gamma.size(), delta_size = delta.size();
+      EliasGammaCoder::encode(x, gamma);
+      EliasDeltaCoder::encode(x, delta);
+
+      // identical to freshly allocated encoding
+      EXPECT_EQ(gamma.slice(gamma_size, gamma.size()), EliasGammaCoder::encode(x));
+      EXPECT_EQ(delta.slice(delta_size, delta.size()), EliasDeltaCoder::encode(x));
+   }
+
+   size_t gamma_index = 0, delta_index = 0;
+   for (const auto x : values) {
+      EXPECT_EQ(EliasGammaCoder::decode(gamma, gamma_index), x);
+      EXPECT_EQ(EliasDeltaCoder::decode(delta, delta_index), x);
+   }
+   EXPECT_EQ(gamma_index, gamma.size());
+   EXPECT_EQ(delta_index, delta.size());
+}
+
+/// Decoding multiple consecutive fields at once, e.g., trie nodes
+TEST(EliasCoding, DeltaFields) {
+   using namespace exotic_hashing::support;
+
+   std::mt19937_64 rng_gen(1);
+   std::uniform_int_distribution<size_t> bits_dist(1, 64);
+   std::vector<std::array<std::uint64_t, 3>> nodes(1000);
+   Bitvector stream;
+   for (auto& node : nodes) {
+      for (auto& field : node) {
+         const auto bits = bits_dist(rng_gen);
+         field = (rng_gen() & (bits == 64 ? ~0x0LLU : (0x1LLU << bits) - 1)) | (0x1LLU << (bits - 1));
+         EliasDeltaCoder::encode(field, stream);
+      }
+   }
+
+   size_t bit_index = 0;
+   for (const auto& node : nodes)
+      EXPECT_EQ(EliasDeltaCoder::decode_fields<3>(stream, bit_index), node);
+   EXPECT_EQ(bit_index, stream.size());
+
+   // tries decode their node fields with a single call
+   static_assert(FieldDecoder<EliasDeltaCoder, 3>);
+   static_assert(!FieldDecoder<GolombRiceCoder, 3>);
+}
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <exotic_hashing.hpp>
+#include <limits>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -39,3 +44,100 @@ TEST(EliasFanoList, Access) {
    }
 }
 
+
+/// duplicates, large gaps (sparse select blocks) and values close to the universe's end
+TEST(EliasFanoList, AccessSkewed) {
+   using namespace exotic_hashing::support;
+
+   std::mt19937_64 rng(42);
+   std::vector<std::vector<std::uint64_t>> test_data{
+      {5, 5, 5, 5},
+      {0, std::numeric_limits<std::uint64_t>::max()},
+      {std::numeric_limits<std::uint64_t>::max() - 3, std::numeric_limits<std::uint64_t>::max() - 1,
+       std::numeric_limits<std::uint64_t>::max()}};
+
+   // dense clusters separated by huge gaps
+   std::vector<std::uint64_t> clustered;
+   for (std::uint64_t base = 0; clustered.size() < 200000; base += rng() >> 20)
+      for (size_t i = 0; i < 3000; i++)
+         clustered.push_back(base + i * (rng() % 3));
+   std::sort(clustered.begin(), clustered.end());
+   test_data.push_back(clustered);
+
+   // uniform random of varying density
+   const std::vector<std::uint64_t> maxima{1000, 1000000, std::numeric_limits<std::uint64_t>::max()};
+   for (const auto max : maxima) {
+      std::vector<std::uint64_t> vec(100000);
+      for (auto& x : vec)
+         x = rng() % max;
+      std::sort(vec.begin(), vec.end());
+      test_data.push_back(vec);
+   }
+
+   for (const auto& vec : test_data) {
+      EliasFanoList<std::uint64_t> efl(vec.begin(), vec.end());
+      ASSERT_EQ(efl.size(), vec.size());
+      for (size_t i = 0; i < efl.size(); i++)
+         EXPECT_EQ(vec[i], efl[i]);
+   }
+}
+
+/// tests lower_bound(key) and lower_bound(key, lo, hi) against std::lower_bound
+TEST(EliasFanoList, LowerBound) {
+   using namespace exotic_hashing::support;
+
+   std::mt19937_64 rng(42);
+   std::vector<std::vector<std::uint64_t>> test_data{
+      {}, {7}, {5, 5, 5, 5}, {2, 3, 5, 7, 11, 13, 24}, {0, std::numeric_limits<std::uint64_t>::max() - 1}};
+
+   // large buckets, i.e., many elements sharing their high bits
+   std::vector<std::uint64_t> clustered;
+   for (std::uint64_t base = 1000; clustered.size() < 100000; base += rng() >> 24)
+      for (size_t i = 0; i < 5000; i++)
+         clustered.push_back(base + i * (rng() % 3));
+   std::sort(clustered.begin(), clustered.end());
+   test_data.push_back(clustered);
+
+   std::vector<std::uint64_t> uniform(100000);
+   for (auto& x : uniform)
+      x = rng() % 10000000;
+   std::sort(uniform.begin(), uniform.end());
+   test_data.push_back(uniform);
+
+   for (const auto& vec : test_data) {
+      EliasFanoList<std::uint64_t> efl(vec.begin(), vec.end());
+
+      std::vector<std::uint64_t> keys{0, std::numeric_limits<std::uint64_t>::max()};
+      for (const auto x : vec)
+         keys.insert(keys.end(), {x - 1, x, x + 1});
+
+      for (const auto key : keys) {
+         EXPECT_EQ(efl.lower_bound(key), std::lower_bound(vec.begin(), vec.end(), key) - vec.begin());
+
+         const size_t lo = vec.empty() ? 0 : rng() % vec.size();
+         const size_t hi = lo + (vec.empty() ? 0 : rng() % (vec.size() - lo + 1));
+         EXPECT_EQ(efl.lower_bound(key, lo, hi),
+                   std::lower_bound(vec.begin() + lo, vec.begin() + hi, key) - vec.begin());
+      }
+   }
+}
+
+/// tests decode() against operator[] for all block offsets and sizes up to 2 words
+TEST(EliasFanoList, Decode) {
+   using namespace exotic_hashing::support;
+
+   std::mt19937_64 rng(42);
+   std::vector<std::uint64_t> vec(10000);
+   for (auto& x : vec)
+      x = rng() % 1000000;
+   std::sort(vec.begin(), vec.end());
+
+   EliasFanoList<std::uint64_t> efl(vec.begin(), vec.end());
+   std::vector<std::uint64_t> out(128);
+   for (size_t first = 0; first < vec.size(); first += 1 + rng() % 100) {
+      const size_t count = std::min(rng() % out.size(), vec.size() - first);
+      efl.decode(first, count, out.data());
+      for (size_t j = 0; j < count; j++)
+         EXPECT_EQ(out[j], vec[first + j]);
+   }
+}
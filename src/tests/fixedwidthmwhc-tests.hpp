@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <exotic_hashing.hpp>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+TEST(FixedWidthMWHC, IsPerfect) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::FixedWidthMWHC<std::uint64_t, 16>,
+                           tests::common::TestIsPerfect>();
+}
+
+TEST(FixedWidthMWHC, IsMinimal) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::FixedWidthMWHC<std::uint64_t, 16>,
+                           tests::common::TestIsMinimal>();
+}
+
+TEST(FixedWidthMWHC, IsOrderPreserving) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::FixedWidthMWHC<std::uint64_t, 16>,
+                           tests::common::TestIsOrderPreserving>();
+}
+
+TEST(FixedWidthMWHC, LookupBatch) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::FixedWidthMWHC<std::uint64_t, 11>,
+                           tests::common::TestLookupBatch>();
+}
+
+TEST(FixedWidthMWHC, RejectsTooNarrowWidth) {
+   const std::vector<std::uint64_t> dataset{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+   EXPECT_THROW((exotic_hashing::FixedWidthMWHC<std::uint64_t, 4>(dataset)), std::runtime_error);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <exotic_hashing.hpp>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "include/support/fixed_width_vector.hpp"
+
+template<size_t Bits>
+static void test_fixed_width_vector() {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng_gen(42);
+   std::uniform_int_distribution<std::uint64_t> dist(0, FixedWidthVector<Bits>::max_value);
+
+   std::vector<std::uint64_t> values(1000, 0);
+   for (auto& v : values)
+      v = dist(rng_gen);
+
+   // set in random order to ensure neighbours are never clobbered
+   std::vector<size_t> order(values.size(), 0);
+   for (size_t i = 0; i < order.size(); i++)
+      order[i] = i;
+   std::shuffle(order.begin(), order.end(), rng_gen);
+
+   FixedWidthVector<Bits> vec(values.size());
+   EXPECT_EQ(vec.size(), values.size());
+   for (const auto i : order)
+      vec.set(i, values[i]);
+   for (size_t i = 0; i < values.size(); i++)
+      EXPECT_EQ(vec[i], values[i]);
+
+   // overwriting must not leak bits of the previous value
+   vec.set(0, 0);
+   EXPECT_EQ(vec[0], 0);
+   EXPECT_EQ(vec[1], values[1]);
+
+#ifdef __AVX2__
+   ASSERT_TRUE(vec.gatherable());
+   for (size_t i = 0; i + 4 <= values.size(); i += 4) {
+      alignas(32) std::array<std::uint64_t, 4> res;
+      const auto indices = _mm256_set_epi64x(static_cast<long long>(i + 3), static_cast<long long>(i + 2),
+                                             static_cast<long long>(i + 1), static_cast<long long>(i));
+      _mm256_store_si256(reinterpret_cast<__m256i*>(res.data()), vec.gather4(indices));
+      for (size_t j = 0; j < 4; j++)
+         EXPECT_EQ(res[j], vec[i + j]);
+   }
+#endif
+}
+
+TEST(FixedWidthVector, Access) {
+   test_fixed_width_vector<1>();
+   test_fixed_width_vector<3>();
+   test_fixed_width_vector<8>();
+   test_fixed_width_vector<13>();
+   test_fixed_width_vector<16>();
+   test_fixed_width_vector<25>();
+   test_fixed_width_vector<32>();
+   test_fixed_width_vector<57>();
+}
@@ -60,3 +60,30 @@ TEST(HollowTrie, IsMMPHF) {
    tests::common::run_test<std::uint64_t, HollowTrie, tests::common::TestIsMMPHF>();
 }
 
+
+// ==== Hollow Trie with alternative integer codes ====
+
+template<class IntEncoder>
+using CodedHollowTrie =
+   exotic_hashing::HollowTrie<std::uint64_t, exotic_hashing::support::FixedBitConverter<std::uint64_t>,
+                              exotic_hashing::support::FixedBitvector<64, std::uint64_t>, IntEncoder>;
+
+TEST(HollowTrie, GolombRiceIsMMPHF) {
+   tests::common::run_test<std::uint64_t, CodedHollowTrie<exotic_hashing::support::GolombRiceCoder>,
+                           tests::common::TestIsMMPHF>();
+}
+
+TEST(HollowTrie, ZetaIsMMPHF) {
+   tests::common::run_test<std::uint64_t, CodedHollowTrie<exotic_hashing::support::ZetaCoder<3>>,
+                           tests::common::TestIsMMPHF>();
+}
+
+TEST(HollowTrie, VarintIsMMPHF) {
+   tests::common::run_test<std::uint64_t, CodedHollowTrie<exotic_hashing::support::VarintCoder>,
+                           tests::common::TestIsMMPHF>();
+}
+
+TEST(HollowTrie, NibbleIsMMPHF) {
+   tests::common::run_test<std::uint64_t, CodedHollowTrie<exotic_hashing::support::NibbleCoder>,
+                           tests::common::TestIsMMPHF>();
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exotic_hashing.hpp>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "include/support/integer_codes.hpp"
+
+/// positive values of all bit widths up to max_bits, shuffled
+static std::vector<std::uint64_t> integer_code_values(const size_t max_bits) {
+   std::mt19937_64 rng_gen(42);
+   std::vector<std::uint64_t> values;
+   for (size_t bits = 1; bits <= max_bits; bits++)
+      for (size_t i = 0; i < 50; i++)
+         values.push_back((rng_gen() & (bits == 64 ? ~0x0LLU : (0x1LLU << bits) - 1)) | (0x1LLU << (bits - 1)));
+   for (std::uint64_t x = 1; x < 1024; x++)
+      values.push_back(x);
+   std::shuffle(values.begin(), values.end(), rng_gen);
+   return values;
+}
+
+/// Encodes all values into one stream and decodes them in order
+template<class IntEncoder>
+static void test_integer_code(const IntEncoder& encoder, const std::vector<std::uint64_t>& values) {
+   using namespace exotic_hashing::support;
+
+   Bitvector stream;
+   for (const auto x : values) {
+      const auto size = stream.size();
+      encoder.encode(x, stream);
+      EXPECT_EQ(stream.size() - size, encoder.bits(x));
+   }
+
+   size_t bit_index = 0;
+   for (const auto x : values)
+      EXPECT_EQ(encoder.decode(stream, bit_index), x);
+   EXPECT_EQ(bit_index, stream.size());
+}
+
+TEST(IntegerCodes, GolombRice) {
+   using namespace exotic_hashing::support;
+
+   const auto values = integer_code_values(20);
+   for (const size_t k : {0, 1, 5, 12, 63})
+      test_integer_code(GolombRiceCoder(k), values);
+}
+
+/// quotients of at least max_unary escape to elias gamma, i.e., code length stays logarithmic
+TEST(IntegerCodes, GolombRiceEscapedQuotient) {
+   using namespace exotic_hashing::support;
+
+   const auto values = integer_code_values(64);
+   for (const size_t k : {0, 3, 40}) {
+      const GolombRiceCoder coder(k);
+      test_integer_code(coder, values);
+
+      for (const auto x : values) {
+         const auto q = (x - 1) >> k;
+         if (q < GolombRiceCoder::max_unary)
+            EXPECT_EQ(coder.bits(x), q + 1 + k);
+         else
+            EXPECT_LE(coder.bits(x), GolombRiceCoder::max_unary + 2 * 63 + 1 + k);
+      }
+   }
+}
+
+TEST(IntegerCodes, GolombRiceFitted) {
+   using namespace exotic_hashing::support;
+
+   std::mt19937_64 rng_gen(1);
+   std::geometric_distribution<std::uint64_t> dist(0.001);
+   std::vector<std::uint64_t> values(10000);
+   for (auto& x : values)
+      x = dist(rng_gen) + 1;
+
+   const GolombRiceCoder fitted(values);
+   // mean ~1000, i.e., optimal k is around log2(0.69 * 1000)
+   EXPECT_GE(fitted.parameter(), 8);
+   EXPECT_LE(fitted.parameter(), 10);
+   test_integer_code(fitted, values);
+
+   // no other parameter is smaller
+   size_t fitted_bits = 0;
+   for (const auto x : values)
+      fitted_bits += fitted.bits(x);
+   for (size_t k = 0; k < 20; k++) {
+      size_t bits = 0;
+      for (const auto x : values)
+         bits += GolombRiceCoder(k).bits(x);
+      EXPECT_GE(bits, fitted_bits);
+   }
+}
+
+/// fields depending on the codes, e.g., encoded subtrie sizes, are fit to the values of the final codes
+TEST(IntegerCodes, FitCodesFixpoint) {
+   using namespace exotic_hashing::support;
+
+   std::mt19937_64 rng_gen(1);
+   std::geometric_distribution<std::uint64_t> dist(0.01);
+   std::vector<std::uint64_t> values(10000);
+   for (auto& x : values)
+      x = dist(rng_gen) + 1;
+
+   // field 1 holds the encoded size of each block of 64 field 0 values
+   const auto collect = [&](const std::array<GolombRiceCoder, 2>& codes,
+                            std::array<std::vector<std::uint64_t>, 2>& fields) {
+      for (size_t i = 0; i < values.size(); i += 64) {
+         size_t bits = 0;
+         for (size_t j = i; j < std::min(i + 64, values.size()); j++) {
+            fields[0].push_back(values[j]);
+            bits += codes[0].bits(values[j]);
+         }
+         fields[1].push_back(bits);
+      }
+   };
+
+   const auto codes = fit_codes<GolombRiceCoder, 2>(collect);
+   EXPECT_EQ(codes[0].parameter(), GolombRiceCoder(values).parameter());
+
+   std::array<std::vector<std::uint64_t>, 2> fields;
+   collect(codes, fields);
+   EXPECT_EQ(codes[1].parameter(), GolombRiceCoder(fields[1]).parameter());
+}
+
+TEST(IntegerCodes, Zeta) {
+   using namespace exotic_hashing::support;
+
+   test_integer_code(ZetaCoder<1>(), integer_code_values(64));
+   test_integer_code(ZetaCoder<2>(), integer_code_values(64));
+   test_integer_code(ZetaCoder<3>(), integer_code_values(63));
+   test_integer_code(ZetaCoder<5>(), integer_code_values(60));
+}
+
+TEST(IntegerCodes, ZetaOneIsGamma) {
+   using namespace exotic_hashing::support;
+
+   for (const auto x : integer_code_values(64))
+      EXPECT_EQ(ZetaCoder<1>::bits(x), EliasGammaCoder::bits(x));
+}
+
+TEST(IntegerCodes, Varint) {
+   using namespace exotic_hashing::support;
+
+   const auto values = integer_code_values(64);
+   test_integer_code(VarintCoder(), values);
+
+   EXPECT_EQ(VarintCoder::bits(1), 8);
+   EXPECT_EQ(VarintCoder::bits(128), 8);
+   EXPECT_EQ(VarintCoder::bits(129), 16);
+}
+
+TEST(IntegerCodes, Nibble) {
+   using namespace exotic_hashing::support;
+
+   const auto values = integer_code_values(64);
+   test_integer_code(NibbleCoder(), values);
+
+   EXPECT_EQ(NibbleCoder::bits(8), 4);
+   EXPECT_EQ(NibbleCoder::bits(9), 8);
+}
+
+TEST(IntegerCodes, Elias) {
+   using namespace exotic_hashing::support;
+
+   const auto values = integer_code_values(64);
+   test_integer_code(EliasGammaCoder(), values);
+   test_integer_code(EliasDeltaCoder(), values);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <exotic_hashing.hpp>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+TEST(InterleavedCompactedMWHC, IsPerfect) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::InterleavedCompactedMWHC<std::uint64_t>,
+                           tests::common::TestIsPerfect>();
+}
+
+TEST(InterleavedCompactedMWHC, IsMinimal) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::InterleavedCompactedMWHC<std::uint64_t>,
+                           tests::common::TestIsMinimal>();
+}
+
+TEST(InterleavedCompactedMWHC, IsOrderPreserving) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::InterleavedCompactedMWHC<std::uint64_t>,
+                           tests::common::TestIsOrderPreserving>();
+}
+
+TEST(InterleavedCompactedMWHC, LookupBatch) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::InterleavedCompactedMWHC<std::uint64_t>,
+                           tests::common::TestLookupBatch>();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <exotic_hashing.hpp>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "include/support/interleaved_compacted_vector.hpp"
+
+static void test_interleaved_compacted_vector(const size_t n, const double density, const std::uint64_t max_value) {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng_gen(42);
+   std::bernoulli_distribution nonzero(density);
+   std::uniform_int_distribution<std::uint64_t> dist(1, max_value);
+
+   std::vector<std::uint64_t> values(n, 0);
+   for (auto& v : values)
+      v = nonzero(rng_gen) ? dist(rng_gen) : 0;
+
+   const InterleavedCompactedVector vec(values);
+   EXPECT_EQ(vec.size(), values.size());
+   for (size_t i = 0; i < values.size(); i++)
+      EXPECT_EQ(vec[i], values[i]);
+}
+
+TEST(InterleavedCompactedVector, Access) {
+   test_interleaved_compacted_vector(0, 0.8, 1);
+   test_interleaved_compacted_vector(10000, 0.0, 1);
+   test_interleaved_compacted_vector(10000, 1.0, 1);
+   test_interleaved_compacted_vector(10000, 0.81, 1);
+   test_interleaved_compacted_vector(10000, 0.81, 12345);
+   test_interleaved_compacted_vector(10000, 0.5, (0x1LLU << 40) - 1);
+   test_interleaved_compacted_vector(10000, 0.99, ~0x0LLU);
+}
+
+TEST(InterleavedCompactedVector, BlocksAreMostlySelfContained) {
+   std::default_random_engine rng_gen(1);
+   std::bernoulli_distribution nonzero(0.81);
+   std::uniform_int_distribution<std::uint64_t> dist(1, (0x1LLU << 24) - 1);
+
+   std::vector<std::uint64_t> values(100000, 0);
+   for (auto& v : values)
+      v = nonzero(rng_gen) ? dist(rng_gen) : 0;
+
+   // only few values exceed their block's capacity
+   const exotic_hashing::support::InterleavedCompactedVector vec(values);
+   EXPECT_LE(vec.spilled(), values.size() / 20);
+
+   // blocks must be denser than plainly packing all 24-bit values
+   EXPECT_GT(vec.elements_per_block() * 24, 512);
+}
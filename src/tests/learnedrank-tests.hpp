@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <random>
+#include <vector>
 
 #include <exotic_hashing.hpp>
 #include <learned_hashing.hpp>
@@ -291,3 +294,205 @@ TEST(CompressedLearnedRankRadixSpline, IsMMPHF) {
       exotic_hashing::CompressedLearnedRank<std::uint64_t, learned_hashing::RadixSplineHash<std::uint64_t>>,
       tests::common::TestIsMMPHF>();
 }
+
+// ==== PartitionedCompressedLearnedRankRMI ====
+TEST(PartitionedCompressedLearnedRankRMI, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<
+      Data,
+      exotic_hashing::CompressedLearnedRank<Data, learned_hashing::MonotoneRMIHash<Data, 1000000>,
+                                            exotic_hashing::last_level_search::ExponentialRangeLookup<Data>,
+                                            exotic_hashing::support::PartitionedEliasFanoList<Data>>,
+      tests::common::TestIsMMPHF>();
+}
+
+// ==== LearnedRankPGM ====
+TEST(LearnedRankPGM, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data,
+                           exotic_hashing::LearnedRank<Data, exotic_hashing::support::PGMModel<Data>,
+                                                       exotic_hashing::last_level_search::BinaryRangeLookup<Data>>,
+                           tests::common::TestIsMMPHF>();
+}
+
+TEST(CompressedLearnedRankPGM, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<
+      Data,
+      exotic_hashing::CompressedLearnedRank<Data, exotic_hashing::support::PGMModel<Data, 8>,
+                                            exotic_hashing::last_level_search::BinaryRangeLookup<Data>>,
+      tests::common::TestIsMMPHF>();
+}
+
+// ==== BucketedRangeLookup ====
+TEST(BucketedRangeLookup, LowerBound) {
+   using Data = std::uint64_t;
+
+   std::default_random_engine rng_gen(42);
+   auto dataset = tests::common::gapped_dataset<Data>(100000, rng_gen);
+   const Data max = dataset.back();
+
+   // monotone but badly skewed predictor and non monotone predictor
+   const auto skewed = [&](const Data& key) -> size_t {
+      return key < max / 2 ? 0 : (key - max / 2) * 2 * dataset.size() / max;
+   };
+   const auto non_monotone = [&](const Data& key) -> size_t {
+      return (key * 0x9E3779B97F4A7C15ULL) % dataset.size();
+   };
+
+   const exotic_hashing::last_level_search::BucketedRangeLookup<Data> skewed_lls(dataset, skewed);
+   const exotic_hashing::last_level_search::BucketedRangeLookup<Data, 16> non_monotone_lls(dataset, non_monotone);
+
+   std::uniform_int_distribution<Data> dist(0, max + 10);
+   for (size_t i = 0; i < 100000; i++) {
+      const auto key = i < dataset.size() ? dataset[i] : dist(rng_gen);
+      const size_t expected = std::lower_bound(dataset.begin(), dataset.end(), key) - dataset.begin();
+      EXPECT_EQ(skewed_lls(skewed(key), key, dataset), expected);
+      EXPECT_EQ(non_monotone_lls(non_monotone(key), key, dataset), expected);
+   }
+}
+
+/// policies on plain and elias fano datasets for exact, skewed and far off predictions
+template<class LastLevelSearch>
+static void test_lower_bound() {
+   using Data = std::uint64_t;
+
+   std::default_random_engine rng_gen(42);
+   const auto dataset = tests::common::gapped_dataset<Data>(100000, rng_gen);
+   const exotic_hashing::support::EliasFanoList<Data> efl(dataset.begin(), dataset.end());
+   const Data max = dataset.back();
+
+   const auto exact = [&](const Data& key) -> size_t {
+      return std::lower_bound(dataset.begin(), dataset.end(), key) - dataset.begin();
+   };
+   const auto skewed = [&](const Data& key) -> size_t {
+      return std::min<size_t>(key < max / 2 ? 0 : (key - max / 2) * 2 * dataset.size() / max, dataset.size() - 1);
+   };
+   const auto noisy = [&](const Data& key) -> size_t {
+      const auto pred = exact(key) + (key * 0x9E3779B97F4A7C15ULL) % 1000;
+      return std::min<size_t>(pred < 500 ? 0 : pred - 500, dataset.size() - 1);
+   };
+
+   const LastLevelSearch exact_lls(dataset, exact), skewed_lls(dataset, skewed), noisy_lls(dataset, noisy),
+      compressed_lls(efl, noisy);
+
+   std::uniform_int_distribution<Data> dist(0, max + 10);
+   for (size_t i = 0; i < 100000; i++) {
+      const auto key = i < dataset.size() ? dataset[i] + (i % 3 == 0) : dist(rng_gen);
+      const size_t expected = exact(key);
+      EXPECT_EQ(exact_lls(exact(key), key, dataset), expected);
+      EXPECT_EQ(skewed_lls(skewed(key), key, dataset), expected);
+      EXPECT_EQ(noisy_lls(noisy(key), key, dataset), expected);
+      EXPECT_EQ(compressed_lls(noisy(key), key, efl), expected);
+   }
+}
+
+TEST(ExponentialRangeLookup, LowerBound) {
+   test_lower_bound<exotic_hashing::last_level_search::ExponentialRangeLookup<std::uint64_t>>();
+}
+
+/// windows slid around the prediction on elias fano datasets, i.e., without linearly scanning plain datasets
+TEST(SequentialRangeLookup, LowerBound) {
+   using Data = std::uint64_t;
+
+   std::default_random_engine rng_gen(42);
+   const auto dataset = tests::common::gapped_dataset<Data>(100000, rng_gen);
+   const exotic_hashing::support::EliasFanoList<Data> efl(dataset.begin(), dataset.end());
+   const Data max = dataset.back();
+
+   const auto exact = [&](const Data& key) -> size_t {
+      return std::lower_bound(dataset.begin(), dataset.end(), key) - dataset.begin();
+   };
+   const auto noisy = [&](const Data& key) -> size_t {
+      const auto pred = exact(key) + (key * 0x9E3779B97F4A7C15ULL) % 1000;
+      return std::min<size_t>(pred < 500 ? 0 : pred - 500, dataset.size() - 1);
+   };
+
+   const exotic_hashing::last_level_search::SequentialRangeLookup<Data> exact_lls(dataset, exact),
+      noisy_lls(dataset, noisy);
+
+   std::uniform_int_distribution<Data> dist(0, max + 10);
+   for (size_t i = 0; i < 100000; i++) {
+      const auto key = i < dataset.size() ? dataset[i] + (i % 3 == 0) : dist(rng_gen);
+      const size_t expected = exact(key);
+      EXPECT_EQ(exact_lls(exact(key), key, efl), expected);
+      EXPECT_EQ(noisy_lls(noisy(key), key, efl), expected);
+   }
+}
+
+TEST(SIMDLinearRangeLookup, LowerBound) {
+   test_lower_bound<exotic_hashing::last_level_search::SIMDLinearRangeLookup<std::uint64_t>>();
+}
+
+TEST(InterpolationSIMDRangeLookup, LowerBound) {
+   test_lower_bound<exotic_hashing::last_level_search::InterpolationSIMDRangeLookup<std::uint64_t>>();
+}
+
+TEST(LearnedRankBucketed, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data,
+                           exotic_hashing::LearnedRank<Data, learned_hashing::MonotoneRMIHash<Data, 1000000>,
+                                                       exotic_hashing::last_level_search::BucketedRangeLookup<Data>>,
+                           tests::common::TestIsMMPHF>();
+}
+
+TEST(CompressedLearnedRankBucketed, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<
+      Data,
+      exotic_hashing::CompressedLearnedRank<Data, exotic_hashing::support::PGMModel<Data>,
+                                            exotic_hashing::last_level_search::BucketedRangeLookup<Data>>,
+      tests::common::TestIsMMPHF>();
+}
+
+TEST(LearnedRankSIMDLinear, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data,
+                           exotic_hashing::LearnedRank<Data, exotic_hashing::support::PGMModel<Data>,
+                                                       exotic_hashing::last_level_search::SIMDLinearRangeLookup<Data>>,
+                           tests::common::TestIsMMPHF>();
+}
+
+TEST(CompressedLearnedRankInterpolationSIMD, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<
+      Data,
+      exotic_hashing::CompressedLearnedRank<Data, learned_hashing::MonotoneRMIHash<Data, 1000000>,
+                                            exotic_hashing::last_level_search::InterpolationSIMDRangeLookup<Data>>,
+      tests::common::TestIsMMPHF>();
+}
+
+/// overlapping compaction with training and parallel model training must not change any result
+TEST(LearnedRankParallelConstruction, MatchesSequential) {
+   using Data = std::uint64_t;
+   using namespace exotic_hashing;
+
+   std::default_random_engine rng_gen(42);
+   const auto dataset = tests::common::gapped_dataset<Data>(200000, rng_gen);
+
+   const LearnedRank<Data, support::RMIModel<Data, 10000>, last_level_search::BinaryRangeLookup<Data>> sequential(
+      dataset);
+   const LearnedRank<Data, support::RMIModel<Data, 10000, 1 << 16, 4>, last_level_search::BinaryRangeLookup<Data>, 4>
+      parallel(dataset);
+   const CompressedLearnedRank<Data, support::PGMModel<Data>, last_level_search::BinaryRangeLookup<Data>>
+      compressed_sequential(dataset);
+   const CompressedLearnedRank<Data, support::PGMModel<Data, 32, 4, 4>, last_level_search::BinaryRangeLookup<Data>,
+                               support::EliasFanoList<Data>, 4>
+      compressed_parallel(dataset);
+
+   EXPECT_EQ(sequential.byte_size(), parallel.byte_size());
+   for (size_t i = 0; i < dataset.size(); i++) {
+      ASSERT_EQ(sequential(dataset[i]), i);
+      ASSERT_EQ(parallel(dataset[i]), i);
+      ASSERT_EQ(compressed_sequential(dataset[i]), i);
+      ASSERT_EQ(compressed_parallel(dataset[i]), i);
+   }
+}
+
+TEST(LearnedRankRMIModel, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data,
+                           exotic_hashing::LearnedRank<Data, exotic_hashing::support::RMIModel<Data, 1000, 64>,
+                                                       exotic_hashing::last_level_search::BinaryRangeLookup<Data>>,
+                           tests::common::TestIsMMPHF>();
+}
@@ -18,3 +18,171 @@ TEST(MWHC, IsMinimal) {
 TEST(MWHC, IsOrderPreserving) {
    tests::common::run_test<std::uint64_t, exotic_hashing::MWHC<std::uint64_t>, tests::common::TestIsOrderPreserving>();
 }
+
+using ParallelMWHC =
+   exotic_hashing::MWHC<std::uint64_t, exotic_hashing::support::Hasher<std::uint64_t>,
+                        exotic_hashing::support::ParallelHyperGraph<std::uint64_t,
+                                                                    exotic_hashing::support::Hasher<std::uint64_t>>>;
+
+TEST(ParallelMWHC, IsPerfect) {
+   tests::common::run_test<std::uint64_t, ParallelMWHC, tests::common::TestIsPerfect>();
+}
+
+TEST(ParallelMWHC, IsMinimal) {
+   tests::common::run_test<std::uint64_t, ParallelMWHC, tests::common::TestIsMinimal>();
+}
+
+TEST(ParallelMWHC, IsOrderPreserving) {
+   tests::common::run_test<std::uint64_t, ParallelMWHC, tests::common::TestIsOrderPreserving>();
+}
+
+TEST(ParallelHyperGraph, PeelsLikeHyperGraph) {
+   using Data = std::uint64_t;
+   using Hasher = exotic_hashing::support::Hasher<Data>;
+
+   std::default_random_engine rng_gen(42);
+   const auto dataset = tests::common::gapped_dataset<Data>(100000, rng_gen);
+
+   // small overallocation to also observe failing peels
+   for (const auto overalloc : {1.1, 1.23}) {
+      const size_t N = std::ceil(overalloc * dataset.size());
+      for (size_t attempt = 0; attempt < 5; attempt++) {
+         const Hasher hasher(N);
+         exotic_hashing::support::HyperGraph<Data, Hasher> seq(dataset.begin(), dataset.end(), hasher, N);
+         exotic_hashing::support::ParallelHyperGraph<Data, Hasher, std::vector<Data>::const_iterator, 4> par(
+            dataset.begin(), dataset.end(), hasher, N);
+
+         auto seq_order = seq.peel();
+         auto par_order = par.peel();
+         EXPECT_EQ(seq_order.size(), par_order.size());
+         if (par_order.empty())
+            continue;
+
+         EXPECT_EQ(par.rounds().back(), par_order.size());
+         EXPECT_EQ(par.hinges().size(), par_order.size());
+
+         std::sort(seq_order.begin(), seq_order.end());
+         std::sort(par_order.begin(), par_order.end());
+         EXPECT_EQ(seq_order, par_order);
+      }
+   }
+}
+
+/// graphs spanning multiple vertex blocks are peeled in partitioned rounds, which must still yield a valid order
+TEST(HyperGraph, PartitionedPeelOrderIsValid) {
+   using Data = std::uint64_t;
+   using Hasher = exotic_hashing::support::Hasher<Data>;
+
+   std::default_random_engine rng_gen(7);
+   const auto dataset = tests::common::gapped_dataset<Data>(200000, rng_gen);
+   const size_t N = std::ceil(1.23 * dataset.size());
+
+   std::vector<size_t> order;
+   for (size_t attempt = 0; order.empty() && attempt < 10; attempt++) {
+      const Hasher hasher(N);
+      exotic_hashing::support::HyperGraph<Data, Hasher> graph(dataset.begin(), dataset.end(), hasher, N);
+      order = graph.peel();
+      if (order.empty())
+         continue;
+
+      // in reverse peel order, each edge has a vertex no later peeled edge touches
+      std::vector<bool> settable(N, true);
+      for (auto it = order.rbegin(); it != order.rend(); it++) {
+         const auto [h0, h1, h2] = graph.vertices_of(*it);
+         EXPECT_TRUE(settable[h0] || settable[h1] || settable[h2]);
+         settable[h0] = settable[h1] = settable[h2] = false;
+      }
+
+      std::sort(order.begin(), order.end());
+      for (size_t i = 0; i < order.size(); i++)
+         EXPECT_EQ(order[i], i);
+   }
+   EXPECT_FALSE(order.empty());
+}
+
+TEST(HyperGraph, RejectsTooNarrowVertexIndex) {
+   using Data = std::uint64_t;
+   using Hasher = exotic_hashing::support::Hasher<Data>;
+
+   const std::vector<Data> dataset{1, 2, 3, 4, 5};
+   const size_t N = 300;
+   const Hasher hasher(N);
+   EXPECT_THROW((exotic_hashing::support::HyperGraph<Data, Hasher, std::vector<Data>::const_iterator, std::uint8_t>(
+                   dataset.begin(), dataset.end(), hasher, N)),
+                std::runtime_error);
+}
+
+// small shards to exercise routing even on small datasets
+using PartitionedMWHC = exotic_hashing::PartitionedMWHC<std::uint64_t, 64>;
+
+TEST(PartitionedMWHC, IsPerfect) {
+   tests::common::run_test<std::uint64_t, PartitionedMWHC, tests::common::TestIsPerfect>();
+}
+
+TEST(PartitionedMWHC, IsMinimal) {
+   tests::common::run_test<std::uint64_t, PartitionedMWHC, tests::common::TestIsMinimal>();
+}
+
+TEST(PartitionedMWHC, IsOrderPreserving) {
+   tests::common::run_test<std::uint64_t, PartitionedMWHC, tests::common::TestIsOrderPreserving>();
+}
+
+TEST(MWHC, LookupBatch) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::MWHC<std::uint64_t>, tests::common::TestLookupBatch>();
+}
+
+TEST(PartitionedMWHC, LookupBatch) {
+   tests::common::run_test<std::uint64_t, PartitionedMWHC, tests::common::TestLookupBatch>();
+}
+
+using FuseMWHC = exotic_hashing::MWHC<std::uint64_t, exotic_hashing::support::FuseHasher<std::uint64_t>>;
+
+TEST(FuseMWHC, IsPerfect) {
+   tests::common::run_test<std::uint64_t, FuseMWHC, tests::common::TestIsPerfect>();
+}
+
+TEST(FuseMWHC, IsMinimal) {
+   tests::common::run_test<std::uint64_t, FuseMWHC, tests::common::TestIsMinimal>();
+}
+
+TEST(FuseMWHC, IsOrderPreserving) {
+   tests::common::run_test<std::uint64_t, FuseMWHC, tests::common::TestIsOrderPreserving>();
+}
+
+TEST(FuseHasher, SpatiallyCoupled) {
+   using Data = std::uint64_t;
+   using Hasher = exotic_hashing::support::FuseHasher<Data>;
+
+   for (const size_t n : {0UL, 1UL, 100UL, 10000UL, 1000000UL}) {
+      const auto N = Hasher::vertices_count(n);
+      EXPECT_GE(N, 3);
+      if (n >= 1000000) {
+         EXPECT_LE(N, 1.14 * n);
+      }
+
+      // vertices are distinct, in bounds and lie within a window of three consecutive segments
+      const Hasher hasher(N);
+      const size_t segment_length = N & (~N + 1);
+      for (Data key = 0; key < 1000; key++) {
+         const auto [h0, h1, h2] = hasher(key);
+         EXPECT_LT(h2, N);
+         EXPECT_EQ(h1 / segment_length, h0 / segment_length + 1);
+         EXPECT_EQ(h2 / segment_length, h0 / segment_length + 2);
+      }
+   }
+}
+
+using MultiplyShiftMWHC =
+   exotic_hashing::MWHC<std::uint64_t, exotic_hashing::support::MultiplyShiftHasher<std::uint64_t>>;
+
+TEST(MultiplyShiftMWHC, IsPerfect) {
+   tests::common::run_test<std::uint64_t, MultiplyShiftMWHC, tests::common::TestIsPerfect>();
+}
+
+TEST(MultiplyShiftMWHC, IsMinimal) {
+   tests::common::run_test<std::uint64_t, MultiplyShiftMWHC, tests::common::TestIsMinimal>();
+}
+
+TEST(MultiplyShiftMWHC, IsOrderPreserving) {
+   tests::common::run_test<std::uint64_t, MultiplyShiftMWHC, tests::common::TestIsOrderPreserving>();
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "include/support/partitioned_elias_fano_list.hpp"
+
+/// runs, dense and sparse regions as well as duplicates, i.e., all chunk encodings
+static std::vector<std::vector<std::uint64_t>> partitioned_test_data() {
+   std::mt19937_64 rng(42);
+   std::vector<std::vector<std::uint64_t>> test_data{
+      {}, {7}, {5, 5, 5, 5}, {2, 3, 5, 7, 11, 13, 24}, {0, std::numeric_limits<std::uint64_t>::max()}};
+
+   std::vector<std::uint64_t> mixed;
+   for (std::uint64_t x = 0; mixed.size() < 100000;) {
+      const size_t region = rng() % 4, len = 1 + rng() % 1000;
+      for (size_t i = 0; i < len; i++) {
+         switch (region) {
+            case 0: // run
+               x += 1;
+               break;
+            case 1: // dense
+               x += 1 + rng() % 3;
+               break;
+            case 2: // sparse
+               x += rng() % 100000;
+               break;
+            default: // duplicates
+               x += rng() % 2;
+         }
+         mixed.push_back(x);
+      }
+      x += rng() >> 30;
+   }
+   test_data.push_back(mixed);
+
+   return test_data;
+}
+
+TEST(PartitionedEliasFanoList, Access) {
+   using namespace exotic_hashing::support;
+
+   for (const auto& vec : partitioned_test_data()) {
+      PartitionedEliasFanoList<std::uint64_t> list(vec.begin(), vec.end());
+      PartitionedEliasFanoList<std::uint64_t, 7> small_chunks(vec.begin(), vec.end());
+      ASSERT_EQ(list.size(), vec.size());
+      ASSERT_EQ(small_chunks.size(), vec.size());
+      for (size_t i = 0; i < vec.size(); i++) {
+         EXPECT_EQ(list[i], vec[i]);
+         EXPECT_EQ(small_chunks[i], vec[i]);
+      }
+   }
+}
+
+TEST(PartitionedEliasFanoList, LowerBound) {
+   using namespace exotic_hashing::support;
+
+   std::mt19937_64 rng(1);
+   for (const auto& vec : partitioned_test_data()) {
+      PartitionedEliasFanoList<std::uint64_t> list(vec.begin(), vec.end());
+
+      std::vector<std::uint64_t> keys{0, std::numeric_limits<std::uint64_t>::max()};
+      for (const auto x : vec)
+         keys.insert(keys.end(), {x - 1, x, x + 1});
+
+      for (const auto key : keys) {
+         EXPECT_EQ(list.lower_bound(key), std::lower_bound(vec.begin(), vec.end(), key) - vec.begin());
+
+         const size_t lo = vec.empty() ? 0 : rng() % vec.size();
+         const size_t hi = lo + (vec.empty() ? 0 : rng() % (vec.size() - lo + 1));
+         EXPECT_EQ(list.lower_bound(key, lo, hi),
+                   std::lower_bound(vec.begin() + lo, vec.begin() + hi, key) - vec.begin());
+      }
+   }
+}
+
+/// tests decode() against the original data for block offsets spanning chunk borders and all encodings
+TEST(PartitionedEliasFanoList, Decode) {
+   using namespace exotic_hashing::support;
+
+   std::mt19937_64 rng(3);
+   for (const auto& vec : partitioned_test_data()) {
+      PartitionedEliasFanoList<std::uint64_t> list(vec.begin(), vec.end());
+      PartitionedEliasFanoList<std::uint64_t, 7> small_chunks(vec.begin(), vec.end());
+
+      std::vector<std::uint64_t> out(300);
+      for (size_t first = 0; first < vec.size(); first += 1 + rng() % 100) {
+         const size_t count = std::min(rng() % out.size(), vec.size() - first);
+         list.decode(first, count, out.data());
+         for (size_t j = 0; j < count; j++)
+            EXPECT_EQ(out[j], vec[first + j]);
+
+         small_chunks.decode(first, count, out.data());
+         for (size_t j = 0; j < count; j++)
+            EXPECT_EQ(out[j], vec[first + j]);
+      }
+   }
+}
+
+TEST(PartitionedEliasFanoList, ClusteredSpace) {
+   using namespace exotic_hashing::support;
+
+   // dense clusters separated by huge gaps
+   std::mt19937_64 rng(2);
+   std::vector<std::uint64_t> clustered;
+   for (std::uint64_t base = 0; clustered.size() < 100000; base += rng() >> 16)
+      for (size_t i = 0; i < 5000; i++)
+         clustered.push_back(base + 2 * i + rng() % 2);
+
+   const EliasFanoList<std::uint64_t> efl(clustered.begin(), clustered.end());
+   const PartitionedEliasFanoList<std::uint64_t> pefl(clustered.begin(), clustered.end());
+   EXPECT_LT(pefl.byte_size(), efl.byte_size());
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+#include "include/support/pgm_model.hpp"
+
+TEST(PGMModel, ErrorBound) {
+   using namespace exotic_hashing::support;
+
+   for (const auto& keys : tests::common::model_datasets(100000)) {
+      for (const size_t full_size : {keys.size(), keys.size() / 2}) {
+         tests::common::test_model_error_bound<PGMModel<std::uint64_t>>(keys, full_size);
+         tests::common::test_model_error_bound<PGMModel<std::uint64_t, 4, 2>>(keys, full_size);
+      }
+   }
+}
+
+TEST(PGMModel, SegmentCount) {
+   using namespace exotic_hashing::support;
+
+   // perfectly linear data fits into a single segment, regardless of epsilon
+   std::vector<std::uint64_t> linear(100000);
+   for (size_t i = 0; i < linear.size(); i++)
+      linear[i] = 1000 + 7 * i;
+
+   PGMModel<std::uint64_t, 1> model;
+   model.train(linear.begin(), linear.end(), linear.size());
+   EXPECT_EQ(model.segment_count(), 1);
+}
+
+/// parallel segmentation keeps the error bound and only adds segments at chunk borders
+TEST(PGMModel, Parallel) {
+   using namespace exotic_hashing::support;
+
+   std::mt19937_64 rng(42);
+   std::vector<std::uint64_t> uniform(200000), duplicates(200000);
+   for (auto& key : uniform)
+      key = rng();
+   std::sort(uniform.begin(), uniform.end());
+   // long runs of duplicates spanning chunk borders
+   for (size_t i = 0; i < duplicates.size(); i++)
+      duplicates[i] = i / 30000;
+
+   for (const auto& keys : {uniform, duplicates}) {
+      tests::common::test_model_error_bound<PGMModel<std::uint64_t, 32, 4, 4>>(keys, keys.size());
+      tests::common::test_model_error_bound<PGMModel<std::uint64_t, 32, 4, 4>>(keys, keys.size() / 2);
+
+      PGMModel<std::uint64_t> sequential;
+      PGMModel<std::uint64_t, 32, 4, 4> parallel;
+      sequential.train(keys.begin(), keys.end(), keys.size());
+      parallel.train(keys.begin(), keys.end(), keys.size());
+      EXPECT_LE(parallel.segment_count(), sequential.segment_count() + 3);
+   }
+}
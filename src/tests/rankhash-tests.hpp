@@ -25,6 +25,13 @@ TEST(RankHash, IsMMPHF) {
    tests::common::run_test<std::uint64_t, exotic_hashing::RankHash<std::uint64_t>, tests::common::TestIsMMPHF>();
 }
 
+// ==== StaticSearchTreeRankHash ====
+TEST(StaticSearchTreeRankHash, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data, exotic_hashing::RankHash<Data, exotic_hashing::support::StaticSearchTree<Data>>,
+                           tests::common::TestIsMMPHF>();
+}
+
 // ==== CompressedRankHash ====
 TEST(CompressedRankHash, IsPerfect) {
    tests::common::run_test<std::uint64_t, exotic_hashing::CompressedRankHash<std::uint64_t>,
@@ -45,3 +52,11 @@ TEST(CompressedRankHash, IsMMPHF) {
    tests::common::run_test<std::uint64_t, exotic_hashing::CompressedRankHash<std::uint64_t>,
                            tests::common::TestIsMMPHF>();
 }
+
+// ==== PartitionedCompressedRankHash ====
+TEST(PartitionedCompressedRankHash, IsMMPHF) {
+   using Data = std::uint64_t;
+   tests::common::run_test<
+      Data, exotic_hashing::CompressedRankHash<Data, exotic_hashing::support::PartitionedEliasFanoList<Data>>,
+      tests::common::TestIsMMPHF>();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+#include "include/support/rmi_model.hpp"
+
+TEST(RMIModel, ErrorBound) {
+   using namespace exotic_hashing::support;
+
+   for (const auto& keys : tests::common::model_datasets(200000))
+      for (const size_t full_size : {keys.size(), keys.size() / 2}) {
+         tests::common::test_model_error_bound<RMIModel<std::uint64_t>>(keys, full_size, true);
+         tests::common::test_model_error_bound<RMIModel<std::uint64_t, 100, 16, 4>>(keys, full_size, true);
+      }
+}
+
+/// leaves are fit on all of their keys, i.e., threads must not change any prediction
+TEST(RMIModel, ThreadCountIndependent) {
+   using namespace exotic_hashing::support;
+
+   for (const auto& keys : tests::common::model_datasets(200000)) {
+      RMIModel<std::uint64_t, 10000> sequential;
+      RMIModel<std::uint64_t, 10000, 1 << 16, 4> parallel;
+      sequential.train(keys.begin(), keys.end(), keys.size());
+      parallel.train(keys.begin(), keys.end(), keys.size());
+
+      EXPECT_EQ(sequential.max_error(), parallel.max_error());
+      for (const auto key : keys)
+         ASSERT_EQ(sequential(key), parallel(key));
+   }
+}
+
+/// fitting the root on a stratified sample must not noticeably increase the prediction error
+TEST(RMIModel, SampledRoot) {
+   using namespace exotic_hashing::support;
+
+   for (const auto& keys : tests::common::model_datasets(200000)) {
+      using tests::common::test_model_error_bound;
+      const auto full = test_model_error_bound<RMIModel<std::uint64_t, 10000, 0>>(keys, keys.size(), true);
+      const auto sampled = test_model_error_bound<RMIModel<std::uint64_t, 10000, 1024>>(keys, keys.size(), true);
+      EXPECT_LE(sampled, 1.05 * full + 1);
+   }
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <cstdint>
+#include <exotic_hashing.hpp>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+#include "include/support/serialization.hpp"
+
+TEST(Serialization, PackedView) {
+   using namespace exotic_hashing::support;
+
+   std::default_random_engine rng_gen(42);
+   for (size_t width = 1; width <= 64; width++) {
+      const std::uint64_t max_value = width == 64 ? ~0x0LLU : (0x1LLU << width) - 1;
+      std::uniform_int_distribution<std::uint64_t> dist(0, max_value);
+      std::vector<std::uint64_t> values(1000);
+      for (auto& v : values)
+         v = dist(rng_gen);
+      values[0] = max_value;
+
+      const auto path = tests::common::temp_path(std::to_string(width));
+      {
+         Serializer out(path, "PackedView", 0);
+         out.write(static_cast<std::uint8_t>(width));
+         out.write_packed(values, width);
+         out.finish();
+      }
+
+      const MappedFile file(path);
+      Deserializer in(file, "PackedView", 0);
+      EXPECT_EQ(in.read<std::uint8_t>(), width);
+      const auto view = in.read_packed();
+      ASSERT_EQ(view.size(), values.size());
+      for (size_t i = 0; i < values.size(); i++)
+         EXPECT_EQ(view[i], values[i]);
+
+      std::filesystem::remove(path);
+   }
+}
+
+TEST(Serialization, RejectsForeignFiles) {
+   using Data = std::uint64_t;
+   using FuseMWHC = exotic_hashing::MWHC<Data, exotic_hashing::support::FuseHasher<Data>>;
+
+   std::default_random_engine rng_gen(1);
+   const auto dataset = tests::common::gapped_dataset<Data>(1000, rng_gen);
+   const exotic_hashing::MWHC<Data> mwhc(dataset);
+
+   const auto path = tests::common::temp_path("bin");
+   mwhc.save(path);
+
+   // different structure & different template instantiation of the same structure
+   EXPECT_THROW(exotic_hashing::CompressedMWHC<Data>::View{path}, std::runtime_error);
+   EXPECT_THROW(FuseMWHC::View{path}, std::runtime_error);
+
+   // truncated file
+   std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+   EXPECT_THROW(exotic_hashing::MWHC<Data>::View{path}, std::runtime_error);
+
+   std::filesystem::remove(path);
+   EXPECT_THROW(exotic_hashing::MWHC<Data>::View{path}, std::runtime_error);
+}
+
+TEST(MWHC, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::MWHC<std::uint64_t>, tests::common::TestSaveView>();
+}
+
+TEST(MultiplyShiftMWHC, SaveView) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data, exotic_hashing::MWHC<Data, exotic_hashing::support::MultiplyShiftHasher<Data>>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(FuseMWHC, SaveView) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data, exotic_hashing::MWHC<Data, exotic_hashing::support::FuseHasher<Data>>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(CompressedMWHC, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::CompressedMWHC<std::uint64_t>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(BitMWHC, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::BitMWHC<std::uint64_t>, tests::common::TestSaveView>();
+}
+
+TEST(MinimalBitMWHC, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::MinimalBitMWHC<std::uint64_t>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(CompactedMWHC, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::CompactedMWHC<std::uint64_t>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(InterleavedCompactedMWHC, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::InterleavedCompactedMWHC<std::uint64_t>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(FixedWidthMWHC, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::FixedWidthMWHC<std::uint64_t, 16>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(PartitionedMWHC, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::PartitionedMWHC<std::uint64_t, 64>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(RankHash, SaveView) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data, exotic_hashing::RankHash<Data>, tests::common::TestSaveView>();
+   tests::common::run_test<Data, exotic_hashing::RankHash<Data, exotic_hashing::support::StaticSearchTree<Data>>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(CompressedRankHash, SaveView) {
+   using Data = std::uint64_t;
+   tests::common::run_test<Data, exotic_hashing::CompressedRankHash<Data>, tests::common::TestSaveView>();
+   tests::common::run_test<
+      Data, exotic_hashing::CompressedRankHash<Data, exotic_hashing::support::PartitionedEliasFanoList<Data>>,
+      tests::common::TestSaveView>();
+}
+
+TEST(HollowTrie, SaveView) {
+   using Data = std::uint64_t;
+   using BitConverter = exotic_hashing::support::FixedBitConverter<Data>;
+   using BitStream = exotic_hashing::support::FixedBitvector<64, Data>;
+   tests::common::run_test<Data, exotic_hashing::HollowTrie<Data, BitConverter>, tests::common::TestSaveView>();
+   tests::common::run_test<
+      Data, exotic_hashing::HollowTrie<Data, BitConverter, BitStream, exotic_hashing::support::GolombRiceCoder>,
+      tests::common::TestSaveView>();
+}
+
+TEST(CompactedCompactTrie, SaveView) {
+   using Data = std::uint64_t;
+   using BitConverter = exotic_hashing::support::FixedBitConverter<Data>;
+   using BitStream = exotic_hashing::support::FixedBitvector<64, Data>;
+   tests::common::run_test<Data, exotic_hashing::CompactedCompactTrie<Data, BitConverter>,
+                           tests::common::TestSaveView>();
+   tests::common::run_test<Data,
+                           exotic_hashing::CompactedCompactTrie<Data, BitConverter, false, BitStream,
+                                                                exotic_hashing::support::GolombRiceCoder>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(LearnedRank, SaveView) {
+   using Data = std::uint64_t;
+   using PGM = exotic_hashing::support::PGMModel<Data>;
+   using RMI = exotic_hashing::support::RMIModel<Data, 1000>;
+   namespace lls = exotic_hashing::last_level_search;
+
+   tests::common::run_test<Data, exotic_hashing::LearnedRank<Data, PGM, lls::BinaryRangeLookup<Data>>,
+                           tests::common::TestSaveView>();
+   tests::common::run_test<Data, exotic_hashing::LearnedRank<Data, RMI, lls::ExponentialRangeLookup<Data>>,
+                           tests::common::TestSaveView>();
+   tests::common::run_test<Data, exotic_hashing::LearnedRank<Data, RMI, lls::SequentialRangeLookup<Data>>,
+                           tests::common::TestSaveView>();
+   tests::common::run_test<Data, exotic_hashing::LearnedRank<Data, PGM, lls::BucketedRangeLookup<Data>>,
+                           tests::common::TestSaveView>();
+   tests::common::run_test<Data, exotic_hashing::LearnedRank<Data, PGM, lls::SIMDLinearRangeLookup<Data>>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(CompressedLearnedRank, SaveView) {
+   using Data = std::uint64_t;
+   using PGM = exotic_hashing::support::PGMModel<Data>;
+   using RMI = exotic_hashing::support::RMIModel<Data, 1000>;
+   using PEF = exotic_hashing::support::PartitionedEliasFanoList<Data>;
+   namespace lls = exotic_hashing::last_level_search;
+
+   tests::common::run_test<Data, exotic_hashing::CompressedLearnedRank<Data, PGM, lls::BinaryRangeLookup<Data>>,
+                           tests::common::TestSaveView>();
+   tests::common::run_test<Data,
+                           exotic_hashing::CompressedLearnedRank<Data, RMI, lls::ExponentialRangeLookup<Data>, PEF>,
+                           tests::common::TestSaveView>();
+   tests::common::run_test<Data, exotic_hashing::CompressedLearnedRank<Data, RMI, lls::SequentialRangeLookup<Data>>,
+                           tests::common::TestSaveView>();
+   tests::common::run_test<
+      Data, exotic_hashing::CompressedLearnedRank<Data, PGM, lls::InterpolationSIMDRangeLookup<Data>, PEF>,
+      tests::common::TestSaveView>();
+}
+
+TEST(LearnedLinear, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::LearnedLinear<std::uint64_t>,
+                           tests::common::TestSaveView>();
+}
+
+TEST(AdaptiveLearnedMMPHF, SaveView) {
+   tests::common::run_test<std::uint64_t, exotic_hashing::AdaptiveLearnedMMPHF<std::uint64_t, 10>,
+                           tests::common::TestSaveView>();
+}
+
+template<class SF>
+static void test_sf_save_view() {
+   using Key = std::uint64_t;
+
+   std::default_random_engine rng_gen(42);
+   std::uniform_int_distribution<Key> dist(0, std::numeric_limits<Key>::max());
+   for (const size_t dataset_size : {100, 10000}) {
+      std::vector<Key> keys(dataset_size), payloads(dataset_size);
+      for (size_t i = 0; i < dataset_size; i++) {
+         keys[i] = dist(rng_gen);
+         payloads[i] = dist(rng_gen) & 0xFFFFF;
+      }
+
+      const SF sf(keys, payloads);
+      const auto path = tests::common::temp_path("bin");
+      sf.save(path);
+      {
+         const typename SF::View view(path);
+         for (size_t i = 0; i < dataset_size; i++)
+            EXPECT_EQ(view(keys[i]), payloads[i]);
+      }
+      std::filesystem::remove(path);
+   }
+}
+
+TEST(SFMWHC, SaveView) {
+   test_sf_save_view<exotic_hashing::SFMWHC<std::uint64_t>>();
+}
+
+TEST(CompressedSFMWHC, SaveView) {
+   test_sf_save_view<exotic_hashing::CompressedSFMWHC<std::uint64_t>>();
+}
+
+TEST(RibbonSF, SaveView) {
+   test_sf_save_view<exotic_hashing::RibbonSF<std::uint64_t>>();
+   test_sf_save_view<exotic_hashing::RibbonSF<std::uint64_t, std::uint64_t, std::ratio<5, 100>, 256>>();
+}
+
+TEST(FixedWidthSFMWHC, SaveView) {
+   test_sf_save_view<exotic_hashing::FixedWidthSFMWHC<std::uint64_t, 20>>();
+}
+
+TEST(PartitionedSFMWHC, SaveView) {
+   test_sf_save_view<exotic_hashing::PartitionedSFMWHC<std::uint64_t, std::uint64_t, 64>>();
+}
+
+template<class Filter>
+static void test_filter_save_view() {
+   using Key = std::uint64_t;
+
+   std::default_random_engine rng_gen(42);
+   const auto keys = tests::common::gapped_dataset<Key>(10000, rng_gen);
+   const Filter filter(keys);
+
+   const auto path = tests::common::temp_path("bin");
+   filter.save(path);
+   {
+      // other keys, members or not, must match the filter including its false positives
+      const typename Filter::View view(path);
+      for (const auto& key : keys) {
+         EXPECT_TRUE(view.contains(key));
+         EXPECT_EQ(view.contains(key + 1), filter.contains(key + 1));
+      }
+   }
+   std::filesystem::remove(path);
+}
+
+TEST(XorFilter, SaveView) {
+   test_filter_save_view<exotic_hashing::XorFilter<std::uint64_t>>();
+}
+
+TEST(BinaryFuseFilter, SaveView) {
+   test_filter_save_view<exotic_hashing::BinaryFuseFilter<std::uint64_t, 16>>();
+}
@@ -8,7 +8,8 @@
 
 #include "common.hpp"
 
-TEST(SFMWHC, IsFunctionStorage) {
+template<class SF>
+static void test_is_function_storage() {
    using Key = std::uint64_t;
    using Payload = std::uint64_t;
 
@@ -31,7 +32,7 @@ TEST(SFMWHC, IsFunctionStorage) {
          payloads[i] = payload_dist(rng_gen);
 
       // build hashfn
-      exotic_hashing::SFMWHC<Key> h(keys, payloads);
+      SF h(keys, payloads);
 
       // test whether function was stored successfully
       for (size_t i = keys.size() - 1; i >= 0 && i < keys.size(); i--)
@@ -41,3 +42,124 @@ TEST(SFMWHC, IsFunctionStorage) {
       dataset_size += dataset_size - 1;
    }
 }
+
+TEST(SFMWHC, IsFunctionStorage) {
+   test_is_function_storage<exotic_hashing::SFMWHC<std::uint64_t>>();
+}
+
+TEST(ParallelSFMWHC, IsFunctionStorage) {
+   using Key = std::uint64_t;
+   using Hasher = exotic_hashing::support::Hasher<Key>;
+   test_is_function_storage<exotic_hashing::SFMWHC<Key, std::uint64_t, Hasher,
+                                                   exotic_hashing::support::ParallelHyperGraph<Key, Hasher>>>();
+}
+
+TEST(PartitionedSFMWHC, IsFunctionStorage) {
+   test_is_function_storage<exotic_hashing::PartitionedSFMWHC<std::uint64_t, std::uint64_t, 64>>();
+   test_is_function_storage<exotic_hashing::PartitionedSFMWHC<std::uint64_t>>();
+}
+
+template<class SF>
+static void test_lookup_batch() {
+   using Key = std::uint64_t;
+
+   std::default_random_engine rng_gen(42);
+   const auto keys = tests::common::gapped_dataset<Key>(10000, rng_gen);
+   std::vector<std::uint64_t> payloads(keys.size(), 0);
+   std::uniform_int_distribution<std::uint64_t> payload_dist(0, 1000000);
+   for (auto& payload : payloads)
+      payload = payload_dist(rng_gen);
+
+   const SF h(keys, payloads);
+   std::vector<size_t> out(keys.size(), 0);
+   h.lookup_batch(keys.data(), keys.size(), out.data());
+   for (size_t i = 0; i < keys.size(); i++)
+      EXPECT_EQ(out[i], payloads[i]);
+}
+
+TEST(SFMWHC, LookupBatch) {
+   test_lookup_batch<exotic_hashing::SFMWHC<std::uint64_t>>();
+}
+
+TEST(CompressedSFMWHC, LookupBatch) {
+   test_lookup_batch<exotic_hashing::CompressedSFMWHC<std::uint64_t>>();
+}
+
+TEST(PartitionedSFMWHC, LookupBatch) {
+   test_lookup_batch<exotic_hashing::PartitionedSFMWHC<std::uint64_t, std::uint64_t, 64>>();
+}
+
+TEST(FuseSFMWHC, IsFunctionStorage) {
+   using Key = std::uint64_t;
+   test_is_function_storage<exotic_hashing::SFMWHC<Key, std::uint64_t, exotic_hashing::support::FuseHasher<Key>>>();
+}
+
+TEST(MultiplyShiftSFMWHC, IsFunctionStorage) {
+   using Key = std::uint64_t;
+   test_is_function_storage<
+      exotic_hashing::SFMWHC<Key, std::uint64_t, exotic_hashing::support::MultiplyShiftHasher<Key>>>();
+}
+
+TEST(FixedWidthSFMWHC, LookupBatch) {
+   test_lookup_batch<exotic_hashing::FixedWidthSFMWHC<std::uint64_t, 20>>();
+}
+
+TEST(FixedWidthSFMWHC, RejectsTooWidePayloads) {
+   const std::vector<std::uint64_t> keys{1, 2, 3};
+   const std::vector<std::uint64_t> payloads{1, 1 << 8, 2};
+   EXPECT_THROW((exotic_hashing::FixedWidthSFMWHC<std::uint64_t, 8>(keys, payloads)), std::runtime_error);
+}
+
+template<size_t Bits>
+static void test_retrieval() {
+   using Key = std::uint64_t;
+   using Retrieval = exotic_hashing::RetrievalMWHC<Key, Bits>;
+
+   std::default_random_engine rng_gen(1337);
+   const auto keys = tests::common::gapped_dataset<Key>(10000, rng_gen);
+   std::uniform_int_distribution<std::uint64_t> payload_dist(0, (0x1LLU << Bits) - 1);
+   std::vector<std::conditional_t<(Bits <= 8), std::uint8_t, std::uint16_t>> payloads(keys.size(), 0);
+   for (auto& payload : payloads)
+      payload = payload_dist(rng_gen);
+
+   const Retrieval h(keys, payloads);
+   for (size_t i = 0; i < keys.size(); i++)
+      EXPECT_EQ(h(keys[i]), payloads[i]);
+
+   // ~1.23 Bits bits per key, i.e., only constant overhead on top
+   EXPECT_LE(8. * h.byte_size() / keys.size(), 1.23 * Bits + 0.1);
+}
+
+TEST(RetrievalMWHC, IsFunctionStorage) {
+   test_retrieval<1>();
+   test_retrieval<3>();
+   test_retrieval<8>();
+   test_retrieval<13>();
+}
+
+TEST(RibbonSF, IsFunctionStorage) {
+   test_is_function_storage<exotic_hashing::RibbonSF<std::uint64_t>>();
+   test_is_function_storage<exotic_hashing::RibbonSF<std::uint64_t, std::uint64_t, std::ratio<5, 100>, 64>>();
+}
+
+TEST(RibbonSF, LookupBatch) {
+   test_lookup_batch<exotic_hashing::RibbonSF<std::uint64_t, std::uint64_t, std::ratio<5, 100>, 1024>>();
+}
+
+TEST(RibbonSF, SpaceOverhead) {
+   using Key = std::uint64_t;
+
+   std::default_random_engine rng_gen(1337);
+   const auto keys = tests::common::gapped_dataset<Key>(200000, rng_gen);
+   std::uniform_int_distribution<std::uint64_t> payload_dist(0, 0xFF);
+   std::vector<std::uint8_t> payloads(keys.size(), 0);
+   for (auto& payload : payloads)
+      payload = payload_dist(rng_gen);
+
+   const exotic_hashing::RibbonSF<Key, std::uint8_t> h(keys, payloads);
+   for (size_t i = 0; i < keys.size(); i++)
+      EXPECT_EQ(h(keys[i]), payloads[i]);
+
+   // 8 bits per key plus ~5% overhead
+   EXPECT_LE(8. * h.byte_size() / keys.size(), 1.08 * 8);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "include/support/static_search_tree.hpp"
+
+template<class Key>
+static void test_static_search_tree(std::default_random_engine& rng_gen) {
+   using namespace exotic_hashing::support;
+
+   std::uniform_int_distribution<Key> dist(std::numeric_limits<Key>::min(), std::numeric_limits<Key>::max());
+   // sizes around full nodes & layers
+   for (const size_t size : {0UL, 1UL, 7UL, 8UL, 9UL, 72UL, 73UL, 1000UL, 100000UL}) {
+      std::vector<Key> keys(size);
+      for (auto& key : keys)
+         key = dist(rng_gen);
+      if (size > 2) {
+         keys[0] = std::numeric_limits<Key>::min();
+         keys[1] = std::numeric_limits<Key>::max();
+      }
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+      const StaticSearchTree<Key> tree(keys.begin(), keys.end());
+      ASSERT_EQ(tree.size(), keys.size());
+
+      // neighbours wrap around at min & max, i.e., are computed unsigned to avoid signed overflow
+      using Unsigned = std::make_unsigned_t<Key>;
+      std::vector<Key> queries{std::numeric_limits<Key>::min(), std::numeric_limits<Key>::max()};
+      for (const auto key : keys)
+         queries.insert(queries.end(), {static_cast<Key>(static_cast<Unsigned>(key) - 1), key,
+                                        static_cast<Key>(static_cast<Unsigned>(key) + 1)});
+
+      for (const auto query : queries)
+         EXPECT_EQ(tree.lower_bound(query), std::lower_bound(keys.begin(), keys.end(), query) - keys.begin());
+      for (size_t i = 0; i < keys.size(); i++)
+         EXPECT_EQ(tree[i], keys[i]);
+   }
+}
+
+TEST(StaticSearchTree, LowerBound) {
+   std::default_random_engine rng_gen(42);
+   test_static_search_tree<std::uint64_t>(rng_gen);
+   test_static_search_tree<std::int64_t>(rng_gen);
+   test_static_search_tree<std::uint32_t>(rng_gen);
+}
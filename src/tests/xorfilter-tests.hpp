@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <exotic_hashing.hpp>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+template<class Filter>
+static void test_no_false_negatives() {
+   using Key = std::uint64_t;
+
+   // we do want predictable random results, hence the fixed seeds
+   for (const auto seed : {0, 1, 13, 42, 1337}) {
+      std::default_random_engine rng_gen(seed);
+      const auto keys = tests::common::gapped_dataset<Key>(10000, rng_gen);
+
+      const Filter filter(keys);
+      for (const auto& key : keys)
+         EXPECT_TRUE(filter.contains(key));
+   }
+}
+
+template<class Filter, size_t FingerprintBits>
+static void test_false_positive_rate() {
+   using Key = std::uint64_t;
+
+   std::default_random_engine rng_gen(42);
+   std::uniform_int_distribution<Key> key_dist(0, std::numeric_limits<Key>::max() / 2);
+   std::vector<Key> keys(100000);
+   for (auto& key : keys)
+      key = 2 * key_dist(rng_gen);
+
+   // odd keys are guaranteed non members
+   const Filter filter(keys);
+   size_t false_positives = 0;
+   for (const auto& key : keys)
+      false_positives += filter.contains(key + 1);
+
+   const double expected = static_cast<double>(keys.size()) / (0x1LLU << FingerprintBits);
+   EXPECT_LE(false_positives, 2 * expected + 10);
+}
+
+template<class Filter>
+static void test_contains_batch() {
+   using Key = std::uint64_t;
+
+   std::default_random_engine rng_gen(13);
+   const auto keys = tests::common::gapped_dataset<Key>(5000, rng_gen);
+   const Filter filter(keys);
+
+   // mix of members and (likely) non members, more than one internal chunk
+   std::vector<Key> probes;
+   for (const auto& key : keys) {
+      probes.push_back(key);
+      probes.push_back(key + 1);
+   }
+
+   for (const auto n : {static_cast<size_t>(0), static_cast<size_t>(1), static_cast<size_t>(17), probes.size()}) {
+      std::unique_ptr<bool[]> out(new bool[n + 1]);
+      filter.contains_batch(probes.data(), n, out.get());
+      for (size_t i = 0; i < n; i++)
+         EXPECT_EQ(out[i], filter.contains(probes[i]));
+   }
+}
+
+TEST(XorFilter, NoFalseNegatives) {
+   test_no_false_negatives<exotic_hashing::XorFilter<std::uint64_t, 8>>();
+   test_no_false_negatives<exotic_hashing::XorFilter<std::uint64_t, 16>>();
+}
+
+TEST(XorFilter, FalsePositiveRate) {
+   test_false_positive_rate<exotic_hashing::XorFilter<std::uint64_t, 8>, 8>();
+   test_false_positive_rate<exotic_hashing::XorFilter<std::uint64_t, 12>, 12>();
+}
+
+TEST(XorFilter, ContainsBatch) {
+   test_contains_batch<exotic_hashing::XorFilter<std::uint64_t, 8>>();
+}
+
+TEST(XorFilter, SpaceOverhead) {
+   using Key = std::uint64_t;
+
+   std::default_random_engine rng_gen(1);
+   const auto keys = tests::common::gapped_dataset<Key>(10000, rng_gen);
+   const exotic_hashing::XorFilter<Key, 16> filter(keys);
+
+   EXPECT_LE(8. * filter.byte_size() / keys.size(), 1.23 * 16 + 0.2);
+}
+
+TEST(BinaryFuseFilter, NoFalseNegatives) {
+   test_no_false_negatives<exotic_hashing::BinaryFuseFilter<std::uint64_t, 8>>();
+   test_no_false_negatives<exotic_hashing::BinaryFuseFilter<std::uint64_t, 16>>();
+}
+
+TEST(BinaryFuseFilter, FalsePositiveRate) {
+   test_false_positive_rate<exotic_hashing::BinaryFuseFilter<std::uint64_t, 8>, 8>();
+}
+
+TEST(BinaryFuseFilter, ContainsBatch) {
+   test_contains_batch<exotic_hashing::BinaryFuseFilter<std::uint64_t, 8>>();
+}